@@ -35,6 +35,7 @@
 #endif
 
 static int rvnr;
+static int argstk;	/* bytes of arguments on the stack, see pusharg() */
 
 /*
  * Print out assembler segment name.
@@ -42,6 +43,13 @@ static int rvnr;
 void
 setseg(int seg, char *name)
 {
+	if (name != NULL && seg != NMSEG) { /* section of its own */
+		printf("\t.section %s,\"%s\",@%s\n", name,
+		    seg == PROG ? "ax" : seg == RDATA ? "a" :
+		    seg == TLSDATA || seg == TLSUDATA ? "awT" : "aw",
+		    seg == UDATA || seg == TLSUDATA ? "nobits" : "progbits");
+		return;
+	}
 	switch (seg) {
 		case PROG: name = ".text"; break;
 		case DATA:
@@ -50,7 +58,8 @@ setseg(int seg, char *name)
 		case PICLDATA: name = ".section .data.rel.local,\"aw\",@progbits";break;
 		case PICDATA: name = ".section .data.rel.rw,\"aw\",@progbits"; break;
 		case PICRDATA: name = ".section .data.rel.ro,\"aw\",@progbits"; break;
-		case STRNG:
+		case STRNG: name = ".section .rodata.str1.1,\"aMS\",@progbits,1";
+			break;
 		case RDATA: name = ".section .rodata"; break;
 		case TLSDATA: name = ".section .tdata,\"awT\",@progbits"; break;
 		case TLSUDATA: name = ".section .tbss,\"awT\",@nobits"; break;
@@ -187,68 +196,24 @@ param_32bit(struct symtab *sym, int *argofsp, int dotemps)
 	ecomp(p);
 }
 
-/* setup a double param on the stack
+/* setup a float/double param passed in v0-v7
  * used by bfcode() */
 static void
-param_double(struct symtab *sym, int *argofsp, int dotemps)
+param_fp(struct symtab *sym, int *fargofsp, int dotemps)
 {
-	NODE *p, *q, *t;
-	int tmpnr;
-
-	/*
-	 * we have to dump the float from the general register
-	 * into a temp, since the register allocator doesn't like
-	 * floats to be in CLASSA.  This may not work for -xtemps.
-	 */
-
-	t = tempnode(0, ULONGLONG, 0, 0);
-	tmpnr = regno(t);
-	q = block(REG, NIL, NIL, INT, 0, 0);
-	q->n_rval = R16 + (*argofsp)++;
-	p = buildtree(ASSIGN, t, q);
-	ecomp(p);
+	NODE *p, *q;
 
+	q = block(REG, NIL, NIL, sym->stype, sym->sdf, sym->sap);
+	regno(q) = V0 + (*fargofsp)++;
 	if (dotemps) {
-		sym->soffset = tmpnr;
+		p = tempnode(0, sym->stype, sym->sdf, sym->sap);
+		sym->soffset = regno(p);
 		sym->sflags |= STNODE;
 	} else {
-		q = tempnode(tmpnr, sym->stype, sym->sdf, sym->sap);
 		p = nametree(sym);
-		p = buildtree(ASSIGN, p, q);
-		ecomp(p);
 	}
-}
-
-/* setup a float param on the stack
- * used by bfcode() */
-static void
-param_float(struct symtab *sym, int *argofsp, int dotemps)
-{
-	NODE *p, *q, *t;
-	int tmpnr;
-
-	/*
-	 * we have to dump the float from the general register
-	 * into a temp, since the register allocator doesn't like
-	 * floats to be in CLASSA.  This may not work for -xtemps.
-	 */
-
-	t = tempnode(0, INT, 0, 0);
-	tmpnr = regno(t);
-	q = block(REG, NIL, NIL, INT, 0, 0);
-	q->n_rval = R0 + (*argofsp)++;
-	p = buildtree(ASSIGN, t, q);
+	p = buildtree(ASSIGN, p, q);
 	ecomp(p);
-
-	if (dotemps) {
-		sym->soffset = tmpnr;
-		sym->sflags |= STNODE;
-	} else {
-		q = tempnode(tmpnr, sym->stype, sym->sdf, sym->sap);
-		p = nametree(sym);
-		p = buildtree(ASSIGN, p, q);
-		ecomp(p);
-	}
 }
 
 /* setup the hidden pointer to struct return parameter
@@ -311,7 +276,7 @@ bfcode(struct symtab **sp, int cnt)
 {
 	union arglist *usym;
 	int saveallargs = 0;
-	int i, argofs = 0;
+	int i, argofs = 0, fargofs = 0;
 
 	/*
 	 * Detect if this function has ellipses and save all
@@ -338,6 +303,14 @@ bfcode(struct symtab **sp, int cnt)
 		if (sp[i] == NULL)
 			continue;
 
+		/* floats are passed in their own registers */
+		if (ISFTY(sp[i]->stype) && features(FEATURE_HARDFLOAT)) {
+			if (fargofs < NARGFPREGS)
+				param_fp(sp[i], &fargofs,
+				    xtemps && !saveallargs);
+			continue;
+		}
+
 		if ((argofs >= NARGREGS) && !xtemps)
 			break;
 
@@ -348,19 +321,9 @@ bfcode(struct symtab **sp, int cnt)
 		} else if (DEUNSIGN(sp[i]->stype) == LONGLONG  || DEUNSIGN(sp[i]->stype) == LONG) {
 			param_64bit(sp[i], &argofs, xtemps && !saveallargs);
 		} else if (sp[i]->stype == DOUBLE || sp[i]->stype == LDOUBLE) {
-			if (features(FEATURE_HARDFLOAT))
-				param_double(sp[i], &argofs,
-				    xtemps && !saveallargs);
-			else
-				param_64bit(sp[i], &argofs,
-				    xtemps && !saveallargs);
+			param_64bit(sp[i], &argofs, xtemps && !saveallargs);
 		} else if (sp[i]->stype == FLOAT) {
-			if (features(FEATURE_HARDFLOAT))
-				param_float(sp[i], &argofs,
-				    xtemps && !saveallargs);
-			else
-				param_32bit(sp[i], &argofs,
-				    xtemps && !saveallargs);
+			param_32bit(sp[i], &argofs, xtemps && !saveallargs);
 		} else {
 			param_32bit(sp[i], &argofs, xtemps && !saveallargs);
 		}
@@ -522,7 +485,7 @@ reverse(NODE *p)
 }
 
 
-/* push arg onto the stack */
+/* store arg in the outgoing argument area, one 8-byte slot each */
 /* called by moveargs() */
 static NODE *
 pusharg(NODE *p, int *regp)
@@ -535,18 +498,16 @@ pusharg(NODE *p, int *regp)
 	if (sz < SZINT)
 		p = block(SCONV, p, NIL, INT, 0, 0);
 
-	q = block(REG, NIL, NIL, INT, 0, 0);
-	regno(q) = SP;
-
-	if (szty(p->n_type) == 1) {
+	if (szty(p->n_type) == 1)
 		++(*regp);
-		q = block(MINUSEQ, q, bcon(4), INT, 0, 0);
-	} else {
+	else
 		(*regp) += 2;
-		q = block(MINUSEQ, q, bcon(8), INT, 0, 0);
-	}
 
+	q = block(REG, NIL, NIL, INCREF(p->n_type), p->n_df, p->n_ap);
+	regno(q) = SP;
+	q = block(PLUS, q, bcon(argstk), INCREF(p->n_type), p->n_df, p->n_ap);
 	q = block(UMUL, q, NIL, p->n_type, p->n_df, p->n_ap);
+	argstk += 8;
 
 	return buildtree(ASSIGN, q, p);
 }
@@ -621,8 +582,7 @@ movearg_float(NODE *p, int *regp)
 	int tmpnr;
 
 	/*
-	 * Floats are passed in the general registers for
-	 * compatibily with libraries compiled to handle soft-float.
+	 * With -msoft-float, floats are passed in the general registers.
 	 */
 
 	if (xtemps) {
@@ -707,6 +667,21 @@ movearg_double(NODE *p, int *regp)
 }
 
 
+/* setup float/double argument in v0-v7 */
+/* called from moveargs() */
+static NODE *
+movearg_fp(NODE *p, int *regp, int *fregp)
+{
+	NODE *q;
+
+	if (*fregp >= V0 + NARGFPREGS)
+		return pusharg(p, regp);
+
+	q = block(REG, NIL, NIL, p->n_type, p->n_df, p->n_ap);
+	regno(q) = (*fregp)++;
+	return buildtree(ASSIGN, q, p);
+}
+
 /* setup call stack with a structure */
 /* called from moveargs() */
 static NODE *
@@ -773,13 +748,13 @@ movearg_struct(NODE *p, int *regp)
 
 
 static NODE *
-moveargs(NODE *p, int *regp)
+moveargs(NODE *p, int *regp, int *fregp)
 {
 	NODE *r, **rp;
 	int reg;
 
 	if (p->n_op == CM) {
-		p->n_left = moveargs(p->n_left, regp);
+		p->n_left = moveargs(p->n_left, regp, fregp);
 		r = p->n_right;
 		rp = &p->n_right;
 	} else {
@@ -789,7 +764,9 @@ moveargs(NODE *p, int *regp)
 
 	reg = *regp;
 
-	if (reg > R3 && r->n_op != STARG) {
+	if (ISFTY(r->n_type) && features(FEATURE_HARDFLOAT)) {
+		*rp = movearg_fp(r, regp, fregp);
+	} else if (reg > R3 && r->n_op != STARG) {
 		*rp = pusharg(r, regp);
 	} else if (r->n_op == STARG) {
 		*rp = movearg_struct(r, regp);
@@ -867,14 +844,15 @@ builtin_cfa(const struct bitable *bt, NODE *a)
 NODE *
 funcode(NODE *p)
 {
-	int reg = R0;
+	int reg = R0, freg = V0;
 
 	if (p->n_type == STRTY+FTN || p->n_type == UNIONTY+FTN) {
 		p = retstruct(p);
 		reg = R1;
 	}
 
-	p->n_right = moveargs(p->n_right, &reg);
+	argstk = 0;
+	p->n_right = moveargs(p->n_right, &reg, &freg);
 
 	if (p->n_right == NULL)
 		p->n_op += (UCALL - CALL);
@@ -124,7 +124,7 @@ clocal(NODE *p)
 					/* fake up a structure reference */
 					r = block(REG, NIL, NIL, PTR+STRTY, 0, 0);
 					slval(r, 0);
-					r->n_rval = SPREG;
+					r->n_rval = FPREG;
 					p = stref(block(STREF, r, p, 0, 0, 0));
 					break;
 				case REGISTER:
@@ -257,10 +257,16 @@ clocal(NODE *p)
 				slval(l, (unsigned)glval(l));
 				goto delp;
 			}
-			if (l->n_type < INT || DEUNSIGN(l->n_type) == LONGLONG) {
+			if (l->n_type < INT) {
 				p->n_left = block(SCONV, l, NIL, UNSIGNED, 0, 0);
 				break;
 			}
+			if (DEUNSIGN(l->n_type) == LONGLONG ||
+			    DEUNSIGN(l->n_type) == LONG) {
+				/* 64-bit, only moves to class A */
+				p->n_op = SCONV;
+				break;
+			}
 			if (l->n_op == SCONV)
 				break;
 			if (l->n_op == ADDROF && l->n_left->n_op == TEMP)
@@ -303,9 +309,10 @@ myp2tree(NODE *p)
 	sp->sflags = 0;
 	sp->stype = p->n_type;
 	sp->squal = (CON >> TSHIFT);
+	sp->sname = NULL;
 
 	defloc(sp);
-	ninval(0, tsize(sp->stype, sp->sdf, sp->sap), p);
+	inval(0, tsize(sp->stype, sp->sdf, sp->sap), p);
 
 	p->n_op = NAME;
 	slval(p, 0);
@@ -334,7 +341,7 @@ int
 cisreg(TWORD t)
 {
 	if (t == FLOAT || t == DOUBLE || t == LDOUBLE)
-		return 0; /* not yet */
+		return features(FEATURE_HARDFLOAT);
 	return 1;
 }
 
@@ -475,6 +482,13 @@ defzero(struct symtab *sp)
 
 	off = tsize(sp->stype, sp->sdf, sp->sap);
 	off = (off+(SZCHAR-1))/SZCHAR;
+	if (sp->sclass == STATIC && datasects) {
+		/* in a .bss section of its own */
+		locctr(UDATA, sp);
+		defloc(sp);
+		printf("\t.zero %d\n", off);
+		return;
+	}
 	printf("	.%scomm ", sp->sclass == STATIC ? "l" : "");
 	if (sp->slevel == 0)
 		printf("%s,0%o\n", getexname(sp), off);
@@ -51,6 +51,23 @@ char *rnames[] = {
 	"x29","x30","sp",
 };
 
+/*
+ * The FP/SIMD registers v0-v31, as 32-bit float and 64-bit double.
+ */
+char *snames[] = {
+	"s0", "s1", "s2", "s3", "s4", "s5", "s6", "s7",
+	"s8", "s9", "s10", "s11", "s12", "s13", "s14", "s15",
+	"s16", "s17", "s18", "s19", "s20", "s21", "s22", "s23",
+	"s24", "s25", "s26", "s27", "s28", "s29", "s30", "s31",
+};
+
+char *dnames[] = {
+	"d0", "d1", "d2", "d3", "d4", "d5", "d6", "d7",
+	"d8", "d9", "d10", "d11", "d12", "d13", "d14", "d15",
+	"d16", "d17", "d18", "d19", "d20", "d21", "d22", "d23",
+	"d24", "d25", "d26", "d27", "d28", "d29", "d30", "d31",
+};
+
 /*
  * Handling of integer constants.  We have 8 bits + an even
  * number of rotates available as a simple immediate.
@@ -100,7 +117,11 @@ encode_constant(int constant, int *values)
 static void
 load_constant_into_reg(int reg, int v)
 {
-	printf("\tmov %s,#%d\n", wnames[reg], v);
+	outstr("\tmov ");
+	outstr(wnames[reg]);
+	outstr(",#");
+	outnum(v);
+	outchr('\n');
 }
 
 /*
@@ -109,10 +130,26 @@ load_constant_into_reg(int reg, int v)
 static void
 load_64constant_into_reg(int reg, long long v)
 {
-	printf("\tmov %s,#%lld\n", rnames[reg], v);
+	outstr("\tmov ");
+	outreg(reg);
+	outstr(",#");
+	outnum(v);
+	outchr('\n');
 }
 
 static TWORD ftype;
+static int regoff[MAXREGS];
+
+/*
+ * Name of a register saved by the prologue.
+ */
+static char *
+savname(int r)
+{
+	if (r >= V0)
+		return dnames[r-V0];
+	return rnames[GCLASS(r) == CLASSB ? r-R16 : r];
+}
 
 /*
  * calculate stack size and offsets
@@ -120,7 +157,7 @@ static TWORD ftype;
 static int
 offcalc(struct interpass_prolog *ipp)
 {
-	int addto;
+	int i, off, addto;
 
 #ifdef PCC_DEBUG
 	if (x2debug)
@@ -136,6 +173,16 @@ offcalc(struct interpass_prolog *ipp)
 
 	addto -= AUTOINIT / SZCHAR;
 
+	/* permanent registers are saved above the automatics */
+	off = (p2maxautooff + 7) & ~7;
+	for (i = 0; i < MAXREGS; i++)
+		if (TESTBIT(p2env.p_regs, i)) {
+			regoff[i] = off;
+			off += SZLONG/SZCHAR;
+			if (addto < off)
+				addto = off;
+		}
+
 	return addto;
 }
 
@@ -178,6 +225,35 @@ prologue(struct interpass_prolog *ipp)
         printf("\tstp %s,%s,[%s]\n", rnames[FP],rnames[LR],rnames[SP]);
         printf("\tmov %s,%s\n", rnames[FP], rnames[SP]);
         addStack=addto;
+
+	for (i = 0; i < MAXREGS; i++)
+		if (TESTBIT(p2env.p_regs, i))
+			printf("\tstr %s,[%s,#%d]\n", savname(i), rnames[FP],
+			    regoff[i]);
+}
+
+/*
+ * Restore the saved registers, fp and lr and pop the frame.
+ */
+static void
+framedown(void)
+{
+	int i;
+
+	for (i = 0; i < MAXREGS; i++)
+		if (TESTBIT(p2env.p_regs, i))
+			printf("\tldr %s,[%s,#%d]\n", savname(i), rnames[FP],
+			    regoff[i]);
+        if (addStack == 0){
+                printf("\tldp %s,%s,[%s],#%d \n", rnames[FP], rnames[LR],
+                        rnames[SP], 64);
+                printf("\tadd %s,%s,#%d\n", rnames[SP], rnames[SP], 64);
+        }
+        else{
+                printf("\tldp %s,%s,[%s] \n", rnames[FP], rnames[LR],
+                        rnames[SP]);
+                printf("\tadd %s,%s,%d\n", rnames[SP], rnames[SP], addStack);
+        }
 }
 
 void
@@ -189,19 +265,10 @@ eoftn(struct interpass_prolog *ipp)
 	/* struct return needs special treatment */
 	if (ftype == STRTY || ftype == UNIONTY) {
 		assert(0);
-	} else {
-                if (addStack == 0){
-                        printf("\tldp %s,%s,[%s],#%d \n", rnames[FP], rnames[LR],
-                                rnames[SP], 64);
-                        printf("\tadd %s,%s,#%d\n", rnames[SP], rnames[SP], 64);
-                }
-                else{
-                        printf("\tldp %s,%s,[%s] \n", rnames[FP], rnames[LR],
-                                rnames[SP]);
-                        printf("\tadd %s,%s,%d\n", rnames[SP], rnames[SP], addStack);
-                }
-	}
-	printf("\tret\n");
+	} else if (p2env.p_tailend == 0) {
+		framedown();
+		printf("\tret\n");
+	} /* else left by the tail jump */
 	printf("\t.size %s,.-%s\n", exname(ipp->ipp_name),
 	    exname(ipp->ipp_name));
 }
@@ -227,6 +294,34 @@ ccbranches[] = {
 	"bhi",		/* branch if higher-than */
 };
 
+/*
+ * After fcmp an unordered result sets C and V, so these
+ * do not branch on NaN operands, except for NE.
+ */
+static char *
+fpbranches[] = {
+	"beq",		/* branch if equal */
+	"bne",		/* branch if not-equal or unordered */
+	"bls",		/* branch if less-than-or-equal */
+	"bmi",		/* branch if less-than */
+	"bge",		/* branch if greater-than-or-equal */
+	"bgt",		/* branch if greater-than */
+};
+
+/*
+ * For a negated compare (ATTR_FP_SWAPPED) the branch must
+ * also be taken on unordered operands.
+ */
+static char *
+fpnbranches[] = {
+	"beq",		/* branch if equal */
+	"bne",		/* branch if not-equal or unordered */
+	"ble",		/* branch if less-than-or-equal or unordered */
+	"blt",		/* branch if less-than or unordered */
+	"bpl",		/* branch if greater-than-or-equal or unordered */
+	"bhi",		/* branch if greater-than or unordered */
+};
+
 /*
  * add/sub/...
  *
@@ -257,7 +352,8 @@ hopcode(int f, int o)
 			comperr("hopcode2: %d", o);
 			str = 0; /* XXX gcc */
 	}
-	printf("%s%c", str, f);
+	outstr(str);
+	outchr(f);
 }
 
 /*
@@ -568,36 +664,106 @@ bfext(NODE *p)
 	printf("#%d\n", sz);
 }
 
-static int
-argsiz(NODE *p)
+/*
+ * Emit an atomic operation as an exclusive load/store loop.  Left is
+ * the pointer, right the operand.  For CMPXCHG the right register
+ * holds the expected value, the new value is in R1 and the result
+ * goes to R0, see nspecial().  64-bit objects are in class B, where
+ * CMPXCHG has the expected value in R18, the new value in R17 and the
+ * result in R16.  Class B shares x0-x9 with class A, so the pointer
+ * is first moved to x16, which neither class uses.
+ */
+static void
+atomic(NODE *p)
 {
-	TWORD t = p->n_type;
-
-	if (t < LONGLONG || t == FLOAT || t > BTMASK)
-		return 4;
-	if (t == LONGLONG || t == ULONGLONG || t == LONG || t == ULONG )
-		return 8;
-	if (t == DOUBLE || t == LDOUBLE)
-		return 8;
-	if (t == STRTY || t == UNIONTY)
-		return attr_find(p->n_ap, ATTR_P2STRUCT)->iarg(0);
-	comperr("argsiz");
-	return 0;
+	char *sfx = "", **nm = wnames;
+	int ptr = regno(p->n_left), r = regno(p->n_right);
+	int r1 = DECRA(p->n_reg, 1), r2 = DECRA(p->n_reg, 2), r3;
+	int l1 = getlab2(), l2, b = 0, nw = R1;
+
+	switch (p->n_type) {
+	case CHAR:
+	case UCHAR:
+		sfx = "b";
+		break;
+	case SHORT:
+	case USHORT:
+		sfx = "h";
+		break;
+	case LONG:
+	case ULONG:
+	case LONGLONG:
+	case ULONGLONG:
+		nm = rnames;
+		b = R16;
+		printf("\tmov x16,%s\n", rnames[ptr]);
+		ptr = R16;
+		break;
+	}
+	if (p->n_op == CMPXCHG) {
+		/* status in A1, result in a fixed register */
+		r2 = r1;
+		r1 = b ? R16 : R0;
+		if (b) {
+			r = R18;
+			nw = R17;
+		}
+	}
+
+	deflab(l1);
+	printf("\tldaxr%s %s,[%s]\n", sfx, nm[r1-b], rnames[ptr]);
+	switch (p->n_op) {
+	case XADD:
+		r3 = DECRA(p->n_reg, 3);
+		printf("\tadd %s,%s,%s\n", nm[r2-b], nm[r1-b], nm[r-b]);
+		printf("\tstlxr%s %s,%s,[%s]\n", sfx,
+		    wnames[r3-b], nm[r2-b], rnames[ptr]);
+		printf("\tcbnz %s," LABFMT "\n", wnames[r3-b], l1);
+		break;
+	case XCHG:
+		printf("\tstlxr%s %s,%s,[%s]\n", sfx,
+		    wnames[r2-b], nm[r-b], rnames[ptr]);
+		printf("\tcbnz %s," LABFMT "\n", wnames[r2-b], l1);
+		break;
+	case CMPXCHG:
+		l2 = getlab2();
+		/* the expected value may be sign-extended */
+		printf("\tcmp %s,%s%s\n", nm[r1-b], nm[r-b],
+		    *sfx == 'b' ? ",uxtb" : *sfx == 'h' ? ",uxth" : "");
+		printf("\tb.ne " LABFMT "\n", l2);
+		printf("\tstlxr%s %s,%s,[%s]\n", sfx, wnames[r2-b],
+		    nm[nw-b], rnames[ptr]);
+		printf("\tcbnz %s," LABFMT "\n", wnames[r2-b], l1);
+		deflab(l2);
+		break;
+	default:
+		comperr("atomic");
+	}
+	printf("\tdmb ish\n");
+	if (p->n_type == CHAR)
+		printf("\tsxtb %s,%s\n", wnames[r1], wnames[r1]);
+	else if (p->n_type == SHORT)
+		printf("\tsxth %s,%s\n", wnames[r1], wnames[r1]);
 }
 
 void
 zzzcode(NODE *p, int c)
 {
+	NODE *l, *r;
 	int pr;
 
 	switch (c) {
+		case 'A': /* atomic operation */
+			atomic(p);
+			break;
+
 		case 'B': /* bit-field sign extension */
 			bfext(p);
 			break;
 
 		case 'C':  /* remove from stack after subroutine call */
 			pr = p->n_qual;
-			if (p->n_op == UCALL)
+			if (p->n_op == UCALL || attr_find(p->n_ap, ATTR_TAILCALL))
 				return; /* XXX remove ZC from UCALL */
 			if (pr > 0)
 				printf("\tadd %s,%s,#%d\n", rnames[SP], rnames[SP], pr);
@@ -628,10 +794,44 @@ zzzcode(NODE *p, int c)
 			    getlval(p) & 0xffffffffffffffff);
 			break;
 
+		case 'M': /* operands of fmadd, the product first */
+			l = p->n_left;
+			r = p->n_right;
+			if (l->n_op != MUL) {
+				r = l;
+				l = p->n_right;
+			}
+			adrput(stdout, l->n_left);
+			outchr(',');
+			adrput(stdout, l->n_right);
+			outchr(',');
+			adrput(stdout, r);
+			break;
+
 		case 'Q': /* emit struct assign */
 			stasg(p);
 			break;
 
+		case 'U': /* branch after fcmp */
+			if (p->n_op < EQ || p->n_op > GT)
+				comperr("bad fp branch");
+			if (attr_find(p->n_ap, ATTR_FP_SWAPPED))
+				printf("\t%s ", fpnbranches[p->n_op - EQ]);
+			else
+				printf("\t%s ", fpbranches[p->n_op - EQ]);
+			outlab(p->n_label);
+			outstr(COM "fp conditional branch\n");
+			break;
+
+		case 'W': /* call, or pop frame and branch if a tail call */
+			if (attr_find(p->n_ap, ATTR_TAILCALL) == NULL) {
+				printf("\tbl");
+				break;
+			}
+			framedown();
+			printf("\tb");
+			break;
+
 		default:
 			comperr("zzzcode %c", c);
 	}
@@ -670,7 +870,8 @@ shtemp(NODE *p)
 void
 adrcon(CONSZ val)
 {
-	printf(CONFMT, val);
+	outchr('#');
+	outnum(val);
 }
 
 void
@@ -692,13 +893,15 @@ conput(FILE *fp, NODE *p)
 			s = p->n_name;
 #endif		
 			if (*s != '\0') {
-				fprintf(fp, "%s", s);
+				fputstr(s, fp);
 				if (val > 0)
-					fprintf(fp, "+%d", val);
-				else if (val < 0)
-					fprintf(fp, "-%d", -val);
-			} else
-				fprintf(fp, CONFMT, (CONSZ)val);
+					fputchr('+', fp);
+				if (val != 0)
+					fputnum(val, fp);
+			} else {
+				fputchr('#', fp);
+				fputnum(val, fp);
+			}
 			return;
 
 		default:
@@ -752,19 +955,32 @@ adrput(FILE *io, NODE *p)
 	switch (p->n_op) {
 		case NAME:
 			if (p->n_name[0] != '\0') {
-				fputs(p->n_name, io);
-				if (getlval(p) != 0)
-					fprintf(io, "+%lld", getlval(p));
-			} else
-				fprintf(io, CONFMT, getlval(p));
+				fputstr(p->n_name, io);
+				if (getlval(p) != 0) {
+					fputchr('+', io);
+					fputnum(getlval(p), io);
+				}
+			} else {
+				fputchr('#', io);
+				fputnum(getlval(p), io);
+			}
 			return;
 
 		case OREG:
 			r = p->n_rval;
-                	if (R2TEST(r))
-				fprintf(io, "[%s, %s, lsl #%d]",rnames[R2UPK1(r)],rnames[R2UPK2(r)],R2UPK3(r));
-			else
-				fprintf(io, "[%s,#%d]", rnames[p->n_rval], (int)getlval(p));
+			fputchr('[', io);
+                	if (R2TEST(r)) {
+				fputstr(rnames[R2UPK1(r)], io);
+				fputstr(", ", io);
+				fputstr(rnames[R2UPK2(r)], io);
+				fputstr(", lsl #", io);
+				fputnum(R2UPK3(r), io);
+			} else {
+				fputstr(rnames[p->n_rval], io);
+				fputstr(",#", io);
+				fputnum((int)getlval(p), io);
+			}
+			fputchr(']', io);
 			return;
 
 		case ICON:
@@ -773,6 +989,12 @@ adrput(FILE *io, NODE *p)
 			return;
 	
 		case REG:
+			if (GCLASS(p->n_rval) == CLASSC) {
+				fputstr(p->n_type == FLOAT ?
+				    snames[p->n_rval-V0] : dnames[p->n_rval-V0],
+				    io);
+				return;
+			}
 			switch (p->n_type) {
 				case CHAR:
 				case UCHAR:
@@ -783,28 +1005,28 @@ adrput(FILE *io, NODE *p)
 				case UNSIGNED:
 					if (!ISPTR(p->n_type)) {
 						if (isConverstion) {
-							fprintf(io, "%s", wnames[0]);
+							fputstr(wnames[0], io);
 							isConverstion = 0;
 						}
 						else
-							fprintf(io, "%s", wnames[p->n_rval]);
+							fputstr(wnames[p->n_rval], io);
 					}
 					else
-						fprintf(io, "%s", rnames[p->n_rval]);
+						fputstr(rnames[p->n_rval], io);
 					break;
 				case DOUBLE:
 				case LDOUBLE:
 					if (features(FEATURE_HARDFLOAT)) {
-						fprintf(io, "%s", rnames[p->n_rval]);
+						fputstr(rnames[p->n_rval], io);
 						break;
 					}
 					/* FALLTHROUGH */
 				case LONGLONG:
 				case ULONGLONG:
-					fprintf(io, "%s", rnames[p->n_rval-R16]);
+					fputstr(rnames[p->n_rval-R16], io);
 					break;
 				default:
-					fprintf(io, "%s", rnames[p->n_rval]);
+					fputstr(rnames[p->n_rval], io);
 			}
 		return;
 
@@ -821,8 +1043,68 @@ cbgen(int o, int lab)
 {
 	if (o < EQ || o > UGT)
 		comperr("bad conditional branch: %s", opst[o]);
-	printf("\t%s " LABFMT COM "conditional branch\n",
-	    ccbranches[o-EQ], lab);
+	outchr('\t');
+	outstr(ccbranches[o-EQ]);
+	outchr(' ');
+	outlab(lab);
+	outstr(COM "conditional branch\n");
+}
+
+/*
+ * Can the call p in tail position be done with a branch?  Only direct
+ * calls with all arguments in registers.
+ */
+int
+tailcallok(struct interpass_prolog *ipp, NODE *p)
+{
+	if (p->n_left->n_op != ICON)
+		return 0;
+	if (p->n_op == UCALL)
+		return 1;
+	for (p = p->n_right; p->n_op == CM; p = p->n_left)
+		if (p->n_right->n_op != ASSIGN ||
+		    p->n_right->n_left->n_op != REG)
+			return 0;
+	return p->n_op == ASSIGN && p->n_left->n_op == REG;
+}
+
+/*
+ * Can the move p be done with csel after the compare rel?
+ * Only moves between class A registers are handled.
+ */
+int
+cmovok(NODE *rel, NODE *p)
+{
+	if (rel->n_left->n_type >= FLOAT && rel->n_left->n_type <= LDOUBLE)
+		return 0;
+	if (p->n_left->n_op != REG || p->n_right->n_op != REG)
+		return 0;
+	if (GCLASS(p->n_left->n_rval) != CLASSA ||
+	    GCLASS(p->n_right->n_rval) != CLASSA)
+		return 0;
+	return szty(p->n_type) == 1 && szty(p->n_right->n_type) == 1;
+}
+
+/*
+ * Print the conditional move p, to be done if condition o is true.
+ */
+void
+cmovgen(int o, NODE *p)
+{
+	char **rn = ISPTR(p->n_type) ? rnames : wnames;
+	int d = p->n_left->n_rval, s = p->n_right->n_rval;
+
+	if (d == s)
+		return;
+	outstr("\tcsel ");
+	outstr(rn[d]);
+	outchr(',');
+	outstr(rn[s]);
+	outchr(',');
+	outstr(rn[d]);
+	outchr(',');
+	outstr(ccbranches[o-EQ] + 1);
+	outchr('\n');
 }
 
 /*
@@ -1022,38 +1304,98 @@ myoptim(struct interpass *ipp)
 {
 }
 
+/*
+ * Peephole patterns, see mip/peep.c.  Writing a w register clears the
+ * upper half of the x register, so only moves of x registers may be
+ * removed.
+ */
+static int
+peepgpr(char *s)
+{
+	if (*s != 'w' && *s != 'x')
+		return 0;
+	if (strcmp(s + 1, "zr") == 0)
+		return 1;
+	if (!isdigit((unsigned char)s[1]))
+		return 0;
+	while (isdigit((unsigned char)*++s))
+		;
+	return *s == 0;
+}
+
+/* @1 addresses a stack slot */
+static int
+peepframe(char **v)
+{
+	return strcmp(v[1], "sp") == 0 || strncmp(v[1], "sp,", 3) == 0 ||
+	    strcmp(v[1], "x29") == 0 || strncmp(v[1], "x29,", 4) == 0;
+}
+
+/* @0 is stored to and @2 loaded from the same stack slot */
+static int
+peepsl(char **v)
+{
+	return peepframe(v) && peepgpr(v[0]) && peepgpr(v[2]) &&
+	    v[0][0] == v[2][0] && v[2][1] != 'z';
+}
+
+/* @4 may set the flags as a compare of @0 with zero would do for b.@3 */
+static int
+peepflags(char **v)
+{
+	if (strcmp(v[4], "add") && strcmp(v[4], "sub") && strcmp(v[4], "and"))
+		return 0;
+	if (strcmp(v[3], "eq") && strcmp(v[3], "ne") &&
+	    strcmp(v[3], "mi") && strcmp(v[3], "pl"))
+		return 0;
+	return peepgpr(v[0]) && v[0][1] != 'z';
+}
+
+struct peep peeptab[] = {
+	{ "branch to next", { "\tb @0", "@0:" }, { "@0:" } },
+	{ "add zero", { "\tadd x@0,x@0,#0" }, { NULL } },
+	{ "add zero", { "\tadd @0,@1,#0" }, { "\tmov @0,@1" } },
+	{ "move to self", { "\tmov x@0,x@0" }, { NULL } },
+	{ "move back", { "\tmov x@0,x@1", "\tmov x@1,x@0" },
+	    { "\tmov x@0,x@1" } },
+	{ "reload", { "\tstr x@0,[@1]", "\tldr x@0,[@1]" },
+	    { "\tstr x@0,[@1]" }, peepframe },
+	{ "store and load", { "\tstr @0,[@1]", "\tldr @2,[@1]" },
+	    { "\tstr @0,[@1]", "\tmov @2,@0" }, peepsl },
+	{ "compare zero", { "\t@4 @0,@1,@2", "\tcmp @0,#0", "\tb.@3 @5" },
+	    { "\t@4s @0,@1,@2", "\tb.@3 @5" }, peepflags },
+	{ NULL },
+};
+
 /*
  * Register move: move contents of register 's' to register 'r'.
  */
 void
 rmove(int s, int d, TWORD t)
 {
+	char **rn;
+
+	if (GCLASS(s) == CLASSC) {
+		rn = t == FLOAT ? snames : dnames;
+		printf("\tfmov %s,%s" COM "rmove\n", rn[d-V0], rn[s-V0]);
+		return;
+	}
+
         switch (t) {
 		case DOUBLE:
 		case LDOUBLE:
-			if (features(FEATURE_HARDFLOAT)) {
-				printf("\tfmr %s,%s" COM "rmove\n",rnames[d], rnames[s]);
-				break;
-			}
-			/* FALLTHROUGH */
 	        case LONGLONG:
         	case ULONGLONG:
 		#define LONGREG(x, y) rnames[(x)-(R16-(y))]
 			printf("\tmov %s,%s\n",LONGREG(d,0), LONGREG(s,0));
                		break;
-		case FLOAT:
-			if (features(FEATURE_HARDFLOAT)) {
-				printf("\tmr %s,%s" COM "rmove\n",rnames[d], rnames[s]);
-				break;
-			}
-			/* FALLTHROUGH */
         	default:
-                	if (!ISPTR(t)){
-                        	printf("\tmov %s,%s" COM "rmove\n", wnames[d], wnames[s]);
-   	        	}
-                	else{
-                        	printf("\tmov %s,%s" COM "rmove\n", rnames[d], rnames[s]);
-                	}
+			rn = ISPTR(t) ? rnames : wnames;
+			outstr("\tmov ");
+			outstr(rn[d]);
+			outchr(',');
+			outstr(rn[s]);
+			outstr(COM "rmove\n");
         }
 }
 
@@ -1064,7 +1406,7 @@ rmove(int s, int d, TWORD t)
  * On ARM, we have:
  *	11  CLASSA registers (32-bit hard registers)
  *	10  CLASSB registers (64-bit composite registers)
- *	8 or 32 CLASSC registers (floating-point)
+ *	31  CLASSC registers (floating-point, v0-v30)
  *
  *  There is a problem calculating the available composite registers
  *  (ie CLASSB).  The algorithm below assumes that given any two
@@ -1094,7 +1436,7 @@ COLORMAP(int c, int *r)
 			return num < 6;  /* XXX see comments above */
 		case CLASSC:
 	        	num += r[CLASSC];
-   			return num < 8;
+   			return num < 31;
 	}
 	cerror("colormap 2");
 	return 0; /* XXX gcc */
@@ -1129,11 +1471,27 @@ retreg(int t)
 	int c = gclass(t);
 	if (c == CLASSB)
 		return R16;
+	if (c == CLASSC)
+		return V0;
 	return R0;
 }
 
 /*
- * Calculate argument sizes.
+ * Return the end of the stack slot that argument p is stored into by
+ * pusharg(), or 0 if it is passed in a register.
+ */
+static int
+argend(NODE *p)
+{
+	if (p->n_op != ASSIGN || p->n_left->n_op != OREG ||
+	    regno(p->n_left) != SP)
+		return 0;
+	return (int)getlval(p->n_left) + 8;
+}
+
+/*
+ * Allocate the outgoing argument area for the arguments on the stack,
+ * keeping sp aligned to 16 bytes.  ZC removes it after the call.
  */
 void
 lastcall(NODE *p)
@@ -1145,9 +1503,14 @@ lastcall(NODE *p)
 	if (p->n_op != CALL && p->n_op != FORTCALL && p->n_op != STCALL)
 		return;
 	for (p = p->n_right; p->n_op == CM; p = p->n_left)
-		size += argsiz(p->n_right);
-	size += argsiz(p);
-	op->n_qual = size - 16; /* XXX */
+		if (argend(p->n_right) > size)
+			size = argend(p->n_right);
+	if (argend(p) > size)
+		size = argend(p);
+	size = (size + 15) & ~15;
+	if (size)
+		printf("\tsub %s,%s,#%d\n", rnames[SP], rnames[SP], size);
+	op->n_qual = size;
 }
 
 /*
@@ -1156,16 +1519,31 @@ lastcall(NODE *p)
 int
 special(NODE *p, int shape)
 {
+	NODE *l, *r;
+
+	switch (shape) {
+	case SFMUL:
+		/* both factors must already be in registers */
+		if (p->n_op != MUL)
+			break;
+		l = p->n_left;
+		r = p->n_right;
+		if ((l->n_op == TEMP || l->n_op == REG) &&
+		    (r->n_op == TEMP || r->n_op == REG) &&
+		    PCLASS(l) == SCREG && PCLASS(r) == SCREG)
+			return SRDIR;
+		break;
+	}
 	return SRNOPE;
 }
 
 /*
- * default to ARMv2
+ * default to hardware floating point
  */
 #ifdef TARGET_BIG_ENDIAN
-#define DEFAULT_FEATURES	FEATURE_BIGENDIAN | FEATURE_MUL
+#define DEFAULT_FEATURES	FEATURE_BIGENDIAN | FEATURE_MUL | FEATURE_FP
 #else
-#define DEFAULT_FEATURES	FEATURE_MUL
+#define DEFAULT_FEATURES	FEATURE_MUL | FEATURE_FP
 #endif
 
 static int fset = DEFAULT_FEATURES;
@@ -1176,7 +1554,16 @@ static int fset = DEFAULT_FEATURES;
 void
 mflags(char *str)
 {
-	//Handling needs to be done for ARMv8
+	if (strcasecmp(str, "soft-float") == 0) {
+		fset &= ~FEATURE_FP;
+		fset |= FEATURE_SOFTFLOAT;
+	} else if (strcasecmp(str, "hard-float") == 0) {
+		fset &= ~FEATURE_SOFTFLOAT;
+		fset |= FEATURE_FP;
+	} else {
+		fprintf(stderr, "unknown m option '%s'\n", str);
+		exit(1);
+	}
 }
 int
 features(int mask)
@@ -1192,7 +1579,8 @@ features(int mask)
 void
 deflab(int label)
 {
-	printf(LABFMT ":\n", label);
+	outlab(label);
+	outstr(":\n");
 }
 
 /*
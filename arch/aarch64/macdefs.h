@@ -134,13 +134,47 @@ typedef long long OFFSZ;
 #define R30	30
 #define R31	31   //SP register
 
+/* FP/SIMD registers, used as s or d registers */
+#define V0	32
+#define V1	33
+#define V2	34
+#define V3	35
+#define V4	36
+#define V5	37
+#define V6	38
+#define V7	39
+#define V8	40
+#define V9	41
+#define V10	42
+#define V11	43
+#define V12	44
+#define V13	45
+#define V14	46
+#define V15	47
+#define V16	48
+#define V17	49
+#define V18	50
+#define V19	51
+#define V20	52
+#define V21	53
+#define V22	54
+#define V23	55
+#define V24	56
+#define V25	57
+#define V26	58
+#define V27	59
+#define V28	60
+#define V29	61
+#define V30	62
+#define V31	63
+
 #define FP	R29
 #define IP	R16
 #define SP	R31
 #define LR	R30
 
 #define NUMCLASS 3
-#define	MAXREGS  34	
+#define	MAXREGS  64
 
 #define RSTATUS \
 	SAREG|TEMPREG, SAREG|TEMPREG, SAREG|TEMPREG, SAREG|TEMPREG,	\
@@ -149,37 +183,54 @@ typedef long long OFFSZ;
 	0, 0, 0, 0, 0,							\
         SBREG|TEMPREG, SBREG|TEMPREG, SBREG|TEMPREG, SBREG,		\
         SBREG, SBREG, SBREG, SBREG, SBREG, SBREG,			\
-	SCREG, SCREG, SCREG, SCREG,					\
-	SCREG, SCREG, SCREG, SCREG,					\
+	0, 0, 0, 0, 0, 0,						\
+	/* v0-v7 arguments, v8-v15 callee-saved, v16-v30 scratch */	\
+	SCREG|TEMPREG, SCREG|TEMPREG, SCREG|TEMPREG, SCREG|TEMPREG,	\
+	SCREG|TEMPREG, SCREG|TEMPREG, SCREG|TEMPREG, SCREG|TEMPREG,	\
+	SCREG|PERMREG, SCREG|PERMREG, SCREG|PERMREG, SCREG|PERMREG,	\
+	SCREG|PERMREG, SCREG|PERMREG, SCREG|PERMREG, SCREG|PERMREG,	\
+	SCREG|TEMPREG, SCREG|TEMPREG, SCREG|TEMPREG, SCREG|TEMPREG,	\
+	SCREG|TEMPREG, SCREG|TEMPREG, SCREG|TEMPREG, SCREG|TEMPREG,	\
+	SCREG|TEMPREG, SCREG|TEMPREG, SCREG|TEMPREG, SCREG|TEMPREG,	\
+	SCREG|TEMPREG, SCREG|TEMPREG, SCREG|TEMPREG,			\
+	0,	/* v31 left out, a class holds at most 31 registers */
 
 /* no overlapping registers at all */
 #define ROVERLAP \
-        { -1 }, { -1 }, { -1 }, { -1 }, { -1 }, { -1 }, { -1 }, \
-        { -1 }, { -1 }, { -1 }, { -1 }, { -1 }, { -1 }, { -1 }, \
-        { -1 }, { -1 }, { -1 }, { -1 }, { -1 }, { -1 }, { -1 }, \
-        { -1 }, { -1 }, { -1 }, { -1 }, { -1 }, { -1 }, { -1 }, \
-        { -1 }, { -1 }, { -1 }, { -1 }, { -1 }, { -1 },
+        { -1 }, { -1 }, { -1 }, { -1 }, { -1 }, { -1 }, { -1 }, { -1 }, \
+        { -1 }, { -1 }, { -1 }, { -1 }, { -1 }, { -1 }, { -1 }, { -1 }, \
+        { -1 }, { -1 }, { -1 }, { -1 }, { -1 }, { -1 }, { -1 }, { -1 }, \
+        { -1 }, { -1 }, { -1 }, { -1 }, { -1 }, { -1 }, { -1 }, { -1 }, \
+        { -1 }, { -1 }, { -1 }, { -1 }, { -1 }, { -1 }, { -1 }, { -1 }, \
+        { -1 }, { -1 }, { -1 }, { -1 }, { -1 }, { -1 }, { -1 }, { -1 }, \
+        { -1 }, { -1 }, { -1 }, { -1 }, { -1 }, { -1 }, { -1 }, { -1 }, \
+        { -1 }, { -1 }, { -1 }, { -1 }, { -1 }, { -1 }, { -1 }, { -1 },
 
 #define ARGINIT		(16*8)	/* # bits above fp where arguments start */
 #define AUTOINIT	(32*8)	/* # bits above fp where automatics start */
 
 #undef	FIELDOPS		/* no bit-field instructions */
 #define TARGET_ENDIAN TARGET_LE
+#define	TARGET_ATOMICS	(1|2|4|8)	/* object sizes with atomic insns */
+#define	CONDMOVE		/* has csel, see ifconvert() */
+#define	TAILCALL		/* see tailcall() */
+#define	PEEPHOLE		/* see peeptab[] */
 
 /* XXX - to die */
 #define FPREG   FP	/* frame pointer */
 #define SPREG   SP      /* Stack pointer */
+#define STKREG  SP
 
 /* Return a register class based on the type of the node */
 #define PCLASS(p)	(1 << gclass((p)->n_type))
 
-#define GCLASS(x)	(x < 16 ? CLASSA : x < 26 ? CLASSB : CLASSC)
+#define GCLASS(x)	(x < 16 ? CLASSA : x < 32 ? CLASSB : CLASSC)
 #define DECRA(x,y)      (((x) >> (y*6)) & 63)   /* decode encoded regs */
 #define ENCRD(x)        (x)             /* Encode dest reg in n_reg */
 #define ENCRA1(x)       ((x) << 6)      /* A1 */
 #define ENCRA2(x)       ((x) << 12)     /* A2 */
 #define ENCRA(x,y)      ((x) << (6+y*6))        /* encode regs in int */
-#define RETREG(x)	retreg(x)
+#define RETREG(x)	retreg(x)	/* x0, or v0 for floats */
 
 int COLORMAP(int c, int *r);
 int retreg(int ty);
@@ -191,9 +242,11 @@ int features(int f);
 #define FEATURE_MUL		0x00080000
 #define FEATURE_MULL		0x00100000
 #define FEATURE_DIV		0x00200000
-#define FEATURE_FPA		0x10000000
-#define FEATURE_VFP		0x20000000
-#define FEATURE_HARDFLOAT	(FEATURE_FPA|FEATURE_VFP)
+#define FEATURE_SOFTFLOAT	0x10000000	/* float ops are library calls */
+#define FEATURE_FP		0x20000000	/* FP/SIMD registers */
+#define FEATURE_HARDFLOAT	FEATURE_FP
+
+#define	SFMUL		(MAXSPECIAL+1)	/* float multiply for fmadd */
 
 #undef NODE
 #ifdef LANG_CXX
@@ -211,6 +264,9 @@ NODE *arm_builtin_va_copy(const struct bitable *bt, NODE *a);
 
 #define COM     "\t// "
 #define NARGREGS	4
+#define NARGFPREGS	8	/* v0-v7 */
+/* FP varargs come in v0-v7, which bfcode() does not save */
+#define	NOFPVAARG	features(FEATURE_HARDFLOAT)
 
 /* floating point definitions */
 #define USE_IEEEFP_32
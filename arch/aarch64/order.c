@@ -274,6 +274,61 @@ nspecial(struct optab *q)
 			}
 			break;
 
+		/*
+		 * 64-bit atomics, see atomic().  Keep the pointer out of
+		 * the x registers of the class B operands.
+		 */
+		case XADD:
+		case XCHG:
+			{
+				static struct rspecial s[] = {
+					{ NRIGHT, R19 },
+					{ NOLEFT, R3 },
+					{ 0 }
+				};
+				return s;
+			}
+		case CMPXCHG:
+			if (q->visit & INBREG) {
+				static struct rspecial s[] = {
+					{ NOLEFT, R2 },
+					{ NOLEFT, R1 },
+					{ NEVER, R18 },
+					{ NEVER, R17 },
+					{ NEVER, R16 },
+					{ NRES, R16 },
+					{ 0 }
+				};
+				return s;
+			} else {
+				static struct rspecial s[] = {
+					{ NOLEFT, R1 },
+					{ NORIGHT, R1 },
+					{ NEVER, R1 },
+					{ NOLEFT, R0 },
+					{ NORIGHT, R0 },
+					{ NEVER, R0 },
+					{ NRES, R0 },
+					{ 0 }
+				};
+				return s;
+			}
+		case CM: /* operands of CMPXCHG */
+			if (q->visit & INBREG) {
+				static struct rspecial s[] = {
+					{ NLEFT, R18 },
+					{ NRIGHT, R17 },
+					{ 0 }
+				};
+				return s;
+			} else {
+				static struct rspecial s[] = {
+					{ NRIGHT, R1 },
+					{ 0 }
+				};
+				return s;
+			}
+
 		default:
 			break;
 	}
@@ -301,19 +356,30 @@ setorder(NODE *p)
 int *
 livecall(NODE *p)
 {
-        static int r[] = { R3, R2, R1, R0, -1 };
-	int num = 1;
+	static int r[NARGREGS+NARGFPREGS+1];
+	NODE *q, *a;
+	int num = 1, n = 0;
 
-	if (p->n_op != CALL && p->n_op != FORTCALL && p->n_op != STCALL)
-		return &r[4-0];
-
-        for (p = p->n_right; p->n_op == CM; p = p->n_left)
-                num += szty(p->n_right->n_type);
-        num += szty(p->n_right->n_type);
+	if (p->n_op != CALL && p->n_op != FORTCALL && p->n_op != STCALL) {
+		r[0] = -1;
+		return r;
+	}
 
-	num = (num > 4 ? 4 : num);
+	for (q = p->n_right; ; q = q->n_left) {
+		a = q->n_op == CM ? q->n_right : q;
+		if (a->n_op == ASSIGN && a->n_left->n_op == REG &&
+		    GCLASS(regno(a->n_left)) == CLASSC)
+			r[n++] = regno(a->n_left);	/* in v0-v7 */
+		else
+			num += szty(a->n_type);
+		if (q->n_op != CM)
+			break;
+	}
 
-        return &r[4 - num];
+	for (num = (num > 4 ? 4 : num); num > 0; num--)
+		r[n++] = R0 + num - 1;
+	r[n] = -1;
+	return r;
 }
 
 /*
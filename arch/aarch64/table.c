@@ -210,6 +210,18 @@ struct optab table[] = {
 		0,	RLEFT,
 		COM "convert (u)longlong to (u)longlong\n", },
 
+{ SCONV,	INBREG,
+	SAREG,	TPOINT,
+	SBREG,	TLONG|TULONG|TLONGLONG|TULONGLONG,
+		NBREG,	RESC1,
+		"	mov A1,AL" COM "convert pointer to (u)longlong\n", },
+
+{ SCONV,	INAREG,
+	SBREG,	TLONG|TULONG|TLONGLONG|TULONGLONG,
+	SAREG,	TPOINT,
+		NAREG,	RESC1,
+		"	mov A1,AL" COM "convert (u)longlong to pointer\n", },
+
 /* convert (u)char/(u)short/(u)int to longlong */
 { SCONV,	INBREG,
 	SAREG,	TCHAR|TUCHAR|TSHORT|TUSHORT|TWORD,
@@ -303,265 +315,145 @@ struct optab table[] = {
 		2*NAREG|NASL,	RESC1,
 		"ZH", },
 
-{ SCONV,	INAREG | FEATURE_FPA,
-	SCREG,	TFLOAT,
-	SAREG,	TWORD,
+{ SCONV,	INAREG | FEATURE_FP,
+	SCREG,	TFLOAT|TDOUBLE|TLDOUBLE,
+	SAREG,	TINT,
 		NAREG,		RESC1,
-		"	fix AL,AR" COM "convert float to int\n", },
+		"	fcvtzs A1,AL" COM "convert float/double to int\n", },
 
-{ SCONV,	INAREG | FEATURE_VFP,
-	SCREG,	TFLOAT,
-	SAREG,	TSWORD,
+{ SCONV,	INAREG | FEATURE_FP,
+	SCREG,	TFLOAT|TDOUBLE|TLDOUBLE,
+	SAREG,	TUNSIGNED,
 		NAREG,		RESC1,
-		"	ftosis AL,AR" COM "convert float to int\n", },
+		"	fcvtzu A1,AL" COM "convert float/double to unsigned\n", },
 
-{ SCONV,	INAREG | FEATURE_VFP,
-	SCREG,	TFLOAT,
-	SAREG,	TSWORD,
-		NAREG,		RESC1,
-		"	ftouis AL,AR" COM "convert float to int\n", },
-
-{ SCONV,	INAREG,
+{ SCONV,	INAREG | FEATURE_SOFTFLOAT,
 	SAREG,	TFLOAT,
 	SAREG,	TWORD,
 		NSPECIAL|NAREG,		RESC1,
 		"ZF", },
 
-{ SCONV,	INBREG | FEATURE_FPA,
-	SCREG,	TFLOAT,
-	SBREG,	TULONGLONG|TLONGLONG,
+{ SCONV,	INBREG | FEATURE_FP,
+	SCREG,	TFLOAT|TDOUBLE|TLDOUBLE,
+	SBREG,	TLONGLONG,
 		NBREG,		RESC1,
-		COM "unimplemented\n", },
+		"	fcvtzs A1,AL" COM "convert float/double to long long\n", },
 
-{ SCONV,	INBREG | FEATURE_VFP,
-	SCREG,	TFLOAT,
-	SBREG,	TULONGLONG|TLONGLONG,
+{ SCONV,	INBREG | FEATURE_FP,
+	SCREG,	TFLOAT|TDOUBLE|TLDOUBLE,
+	SBREG,	TULONGLONG,
 		NBREG,		RESC1,
-		COM "unimplemented\n", },
+		"	fcvtzu A1,AL" COM "convert float/double to ulong long\n", },
 
-{ SCONV,	INBREG,
+{ SCONV,	INBREG | FEATURE_SOFTFLOAT,
 	SAREG,	TFLOAT,
 	SBREG,	TULONGLONG|TLONGLONG,
 		NSPECIAL|NBREG,		RESC1,
 		"ZF", },
 
-{ SCONV,	INAREG | FEATURE_FPA,
-	SCREG,	TDOUBLE|TLDOUBLE,
-	SAREG,	TWORD,
-		NAREG,		RESC1,
-		"	fix AL,AR" COM "convert double/ldouble to int\n", },
-
-{ SCONV,	INAREG | FEATURE_VFP,
-	SCREG,	TDOUBLE|TLDOUBLE,
-	SAREG,	TSWORD,
-		NAREG,		RESC1,
-		"	ftosid AL,AR" COM "convert double/ldouble to int\n", },
-
-{ SCONV,	INAREG | FEATURE_VFP,
-	SCREG,	TDOUBLE|TLDOUBLE,
-	SAREG,	TUWORD,
-		NAREG,		RESC1,
-		"	ftouid AL,AR" COM "convert double/ldouble to int\n", },
-
-{ SCONV,	INAREG,
+{ SCONV,	INAREG | FEATURE_SOFTFLOAT,
 	SBREG,	TDOUBLE|TLDOUBLE,
 	SAREG,	TWORD,
 		NSPECIAL|NAREG,		RESC1,
 		"ZF", },
 
-{ SCONV,	INBREG | FEATURE_FPA,
-	SCREG,	TDOUBLE|TLDOUBLE,
-	SBREG,	TLONGLONG|TULONGLONG,
-		NBREG,		RESC1,
-		COM "unimplemented\n", },
-
-{ SCONV,	INBREG | FEATURE_VFP,
-	SCREG,	TDOUBLE|TLDOUBLE,
-	SBREG,	TULONGLONG|TLONGLONG,
-		NBREG,		RESC1,
-		COM "unimplemented\n", },
-
-{ SCONV,	INBREG,
+{ SCONV,	INBREG | FEATURE_SOFTFLOAT,
 	SBREG,	TDOUBLE|TLDOUBLE,
 	SBREG,	TULONGLONG|TLONGLONG,
 		NSPECIAL|NBREG,		RESC1,
 		"ZF", },
 
-{ SCONV,	INCREG | FEATURE_FPA,
-	SAREG,	TWORD,
-	SCREG,	TFLOAT,
+{ SCONV,	INCREG | FEATURE_FP,
+	SAREG,	TINT|TSHORT|TCHAR,
+	SCREG,	TFLOAT|TDOUBLE|TLDOUBLE,
 		NCREG,		RESC1,
-		"	flts AL,AR" COM "convert int to float\n" },
+		"	scvtf A1,AL" COM "convert int to float/double\n", },
 
-{ SCONV,	INCREG | FEATURE_VFP,
-	SAREG,	TSWORD,
-	SCREG,	TFLOAT,
-		NCREG,		RESC1,
-		"	fsitos AL,AR" COM "convert int to float\n" },
-
-{ SCONV,	INCREG | FEATURE_VFP,
-	SAREG,	TUWORD,
-	SCREG,	TFLOAT,
+{ SCONV,	INCREG | FEATURE_FP,
+	SAREG,	TUNSIGNED|TUSHORT|TUCHAR,
+	SCREG,	TFLOAT|TDOUBLE|TLDOUBLE,
 		NCREG,		RESC1,
-		"	fuitos AL,AR" COM "convert int to float\n" },
+		"	ucvtf A1,AL" COM "convert unsigned to float/double\n", },
 
-{ SCONV,	INAREG,
+{ SCONV,	INAREG | FEATURE_SOFTFLOAT,
 	SAREG,	TWORD,
 	SAREG,	TFLOAT,
 		NSPECIAL|NAREG,		RESC1,
 		"ZF", },
 
-{ SCONV,	INCREG | FEATURE_FPA,
-	SBREG,	TULONGLONG|TLONGLONG,
-	SCREG,	TFLOAT,
+{ SCONV,	INCREG | FEATURE_FP,
+	SBREG,	TLONGLONG,
+	SCREG,	TFLOAT|TDOUBLE|TLDOUBLE,
 		NCREG,		RESC1,
-		COM "unimplemented\n", },
+		"	scvtf A1,AL" COM "convert long long to float/double\n", },
 
-{ SCONV,	INCREG | FEATURE_VFP,
-	SBREG,	TULONGLONG|TLONGLONG,
-	SCREG,	TFLOAT,
+{ SCONV,	INCREG | FEATURE_FP,
+	SBREG,	TULONGLONG,
+	SCREG,	TFLOAT|TDOUBLE|TLDOUBLE,
 		NCREG,		RESC1,
-		COM "unimplemented\n", },
+		"	ucvtf A1,AL" COM "convert ulong long to float/double\n", },
 
-{ SCONV,	INAREG,
+{ SCONV,	INAREG | FEATURE_SOFTFLOAT,
 	SBREG,	TULONGLONG|TLONGLONG,
 	SAREG,	TFLOAT,
 		NAREG,		RESC1,
 		COM "unimplemented\n", },
 
-{ SCONV,	INCREG | FEATURE_FPA,
-	SAREG,	TWORD,
-	SCREG,	TDOUBLE,
-		NCREG,		RESC1,
-		"	fltd AL,AR" COM "convert int to double\n" },
-
-{ SCONV,	INCREG | FEATURE_VFP,
-	SAREG,	TSWORD,
-	SCREG,	TDOUBLE,
-		NCREG,		RESC1,
-		"	fsitod AL,AR" COM "convert int to double\n" },
-
-{ SCONV,	INCREG | FEATURE_VFP,
-	SAREG,	TUWORD,
-	SCREG,	TDOUBLE,
-		NCREG,		RESC1,
-		"	fuitod AL,AR" COM "convert int to double\n" },
-
-{ SCONV,	INBREG,
+{ SCONV,	INBREG | FEATURE_SOFTFLOAT,
 	SAREG,	TWORD,
 	SBREG,	TDOUBLE,
 		NSPECIAL|NBREG,		RESC1,
 		"ZF", },
 
-{ SCONV,	INCREG | FEATURE_FPA,
-	SBREG,	TLONGLONG|TULONGLONG,
-	SCREG,	TDOUBLE,
-		NCREG,		RESC1,
-		COM "unimplemented\n", },
-
-{ SCONV,	INCREG | FEATURE_VFP,
-	SBREG,	TLONGLONG|TULONGLONG,
-	SCREG,	TDOUBLE,
-		NCREG,		RESC1,
-		COM "unimplemented\n", },
-
-{ SCONV,	INBREG,
+{ SCONV,	INBREG | FEATURE_SOFTFLOAT,
 	SBREG,	TLONGLONG|TULONGLONG,
 	SBREG,	TDOUBLE,
 		NSPECIAL|NBREG,		RESC1,
 		"ZF", },
 
-{ SCONV,	INCREG | FEATURE_FPA,
-	SAREG,	TWORD,
-	SCREG,	TLDOUBLE,
-		NCREG,		RESC1,
-		"	flte AL,AR" COM "convert int to ldouble\n" },
-
-{ SCONV,	INCREG | FEATURE_VFP,
-	SAREG,	TSWORD,
-	SCREG,	TLDOUBLE,
-		NCREG,		RESC1,
-		"	fsitod AL,AR" COM "convert int to ldouble\n" },
-
-{ SCONV,	INCREG | FEATURE_VFP,
-	SAREG,	TUWORD,
-	SCREG,	TLDOUBLE,
-		NCREG,		RESC1,
-		"	fuitod AL,AR" COM "convert uint to ldouble\n" },
-
-{ SCONV,	INBREG,
+{ SCONV,	INBREG | FEATURE_SOFTFLOAT,
 	SAREG,	TWORD,
 	SBREG,	TLDOUBLE,
 		NSPECIAL|NBREG,		RESC1,
 		"ZF", },
 
-{ SCONV,	INCREG | FEATURE_FPA,
-	SBREG,	TLONGLONG|TULONGLONG,
-	SCREG,	TLDOUBLE,
-		NCREG,		RESC1,
-		COM "unimplemented\n", },
-
-{ SCONV,	INCREG | FEATURE_VFP,
-	SBREG,	TLONGLONG|TULONGLONG,
-	SCREG,	TLDOUBLE,
-		NCREG,		RESC1,
-		COM "unimplemented\n", },
-
-{ SCONV,	INBREG,
+{ SCONV,	INBREG | FEATURE_SOFTFLOAT,
 	SBREG,	TLONGLONG|TULONGLONG,
 	SBREG,	TLDOUBLE,
 		NSPECIAL|NBREG,		RESC1,
 		"ZF", },
 
-{ SCONV,	INCREG | FEATURE_FPA,
-	SCREG,	TDOUBLE|TLDOUBLE,
-	SCREG,	TFLOAT,
-		NCREG,		RESC1,
-		COM "unimplemented\n", },
-
-{ SCONV,	INCREG | FEATURE_VFP,
+{ SCONV,	INCREG | FEATURE_FP,
 	SCREG,	TDOUBLE|TLDOUBLE,
 	SCREG,	TFLOAT,
 		NCREG,		RESC1,
-		"	fcvtds AL,AR" COM "convert float to double\n" },
+		"	fcvt A1,AL" COM "convert double to float\n", },
 
-{ SCONV,	INAREG,
+{ SCONV,	INAREG | FEATURE_SOFTFLOAT,
 	SBREG,	TDOUBLE|TLDOUBLE,
 	SAREG,	TFLOAT,
 		NSPECIAL|NAREG,		RESC1,
 		"ZF", },
 
-{ SCONV,	INCREG | FEATURE_FPA,
+{ SCONV,	INCREG | FEATURE_FP,
 	SCREG,	TFLOAT,
 	SCREG,	TDOUBLE|TLDOUBLE,
 		NCREG,		RESC1,
-		COM "unimplemented\n", },
-
-{ SCONV,	INCREG | FEATURE_VFP,
-	SCREG,	TFLOAT,
-	SCREG,	TDOUBLE|TLDOUBLE,
-		NCREG,		RESC1,
-		"	fcvtsd AL,AR" COM "convert float to double\n" },
+		"	fcvt A1,AL" COM "convert float to double\n", },
 
-{ SCONV,	INBREG,
+{ SCONV,	INBREG | FEATURE_SOFTFLOAT,
 	SAREG,	TFLOAT,
 	SBREG,	TDOUBLE|TLDOUBLE,
 		NSPECIAL|NBREG,		RESC1,
 		"ZF", },
 
-{ SCONV,	INCREG | FEATURE_FPA,
+{ SCONV,	INCREG | FEATURE_FP,
 	SCREG,	TDOUBLE|TLDOUBLE,
 	SCREG,	TDOUBLE|TLDOUBLE,
 		0,		RLEFT,
-		COM "convert (l)double to (l)double", },
+		COM "convert (l)double to (l)double\n", },
 
-{ SCONV,	INCREG | FEATURE_VFP,
-	SCREG,	TDOUBLE|TLDOUBLE,
-	SCREG,	TDOUBLE|TLDOUBLE,
-		0,		RLEFT,
-		COM "convert (l)double to (l)double", },
-
-{ SCONV,	INBREG,
+{ SCONV,	INBREG | FEATURE_SOFTFLOAT,
 	SBREG,	TDOUBLE|TLDOUBLE,
 	SBREG,	TDOUBLE|TLDOUBLE,
 		0,		RLEFT,
@@ -575,80 +467,80 @@ struct optab table[] = {
 	SCON|SNAME,	TANY,
 	SANY,		TANY,
 		0,	0,
-		"	bl CL" COM "call (args, no result) to scon/sname (CL)\n"
+		"ZW CL" COM "call (args, no result) to scon/sname (CL)\n"
 		"ZC", },
 
 { UCALL,	FOREFF,
 	SCON|SNAME,	TANY,
 	SANY,		TANY,
 		0,	0,
-		"	bl CL" COM "call (no args, no result) to scon/sname (CL)\n", },
+		"ZW CL" COM "call (no args, no result) to scon/sname (CL)\n", },
 
 { CALL,		INAREG,
 	SCON|SNAME,	TANY,
 	SAREG,		TWORD|TPOINT|TSHORT|TUSHORT|TCHAR|TUCHAR,
 		NAREG|NASL,	RESC1,	/* should be 0 */
-		"	bl CL" COM "call (args, result in r0) to scon/sname (CL)\n"
+		"ZW CL" COM "call (args, result in r0) to scon/sname (CL)\n"
 		"ZC", },
 
 { CALL,		INBREG,
 	SCON|SNAME,	TANY,
 	SBREG,		TLONGLONG|TULONGLONG,
 		NBREG|NBSL,	RESC1,	/* should be 0 */
-		"	bl CL" COM "call (args, result in r0:r1) to scon/sname (CL)\n"
-		"ZC", },
-
-{ CALL,		INCREG | FEATURE_FPA,
-	SCON|SNAME,	TANY,
-	SCREG,		TFLOAT,
-		NCREG|NCSL,	RESC1,	/* should be 0 */
-		"	bl CL" COM "call (args, result r0) to scon/sname (CL)\n"
+		"ZW CL" COM "call (args, result in r0:r1) to scon/sname (CL)\n"
 		"ZC", },
 
-{ CALL,		INCREG | FEATURE_FPA,
+{ CALL,		INCREG | FEATURE_FP,
 	SCON|SNAME,	TANY,
-	SCREG,		TDOUBLE|TLDOUBLE,
+	SCREG,	TFLOAT|TDOUBLE|TLDOUBLE,
 		NCREG|NCSL,	RESC1,	/* should be 0 */
-		"	bl CL" COM "call (args, result in r0:r1) to scon/sname (CL)\n"
+		"ZW CL" COM "call (args, result in v0) to scon/sname (CL)\n"
 		"ZC", },
 
-{ CALL,		INAREG,
+{ CALL,		INAREG | FEATURE_SOFTFLOAT,
 	SCON|SNAME,	TANY,
 	SAREG,		TFLOAT,
 		NAREG|NASL,	RESC1,	/* should be 0 */
-		"	bl CL" COM "call (args, result r0) to scon/sname (CL)\n"
+		"ZW CL" COM "call (args, result r0) to scon/sname (CL)\n"
 		"ZC", },
 
-{ CALL,		INBREG,
+{ CALL,		INBREG | FEATURE_SOFTFLOAT,
 	SCON|SNAME,	TANY,
 	SBREG,		TDOUBLE|TLDOUBLE,
 		NBREG|NBSL,	RESC1,	/* should be 0 */
-		"	bl CL" COM "call (args, result in r0:r1) to scon/sname (CL)\n"
+		"ZW CL" COM "call (args, result in r0:r1) to scon/sname (CL)\n"
 		"ZC", },
 
 { UCALL,	INAREG,
 	SCON|SNAME,	TANY,
 	SAREG,		TWORD|TPOINT|TSHORT|TUSHORT|TCHAR|TUCHAR,
 		NAREG|NASL,	RESC1,	/* should be 0 */
-		"	bl CL" COM "call (no args, result in r0) to scon/sname (CL)\n", },
+		"ZW CL" COM "call (no args, result in r0) to scon/sname (CL)\n", },
 
 { UCALL,	INBREG,
 	SCON|SNAME,	TANY,
 	SBREG,		TLONGLONG|TULONGLONG,
 		NBREG|NBSL,	RESC1,	/* should be 0 */
-		"	bl CL" COM "call (no args, result in r0:r1) to scon/sname (CL)\n", },
+		"ZW CL" COM "call (no args, result in r0:r1) to scon/sname (CL)\n", },
 
-{ UCALL,	INCREG | FEATURE_FPA,
+{ UCALL,	INCREG | FEATURE_FP,
 	SCON|SNAME,	TANY,
-	SCREG,		TFLOAT,
+	SCREG,	TFLOAT|TDOUBLE|TLDOUBLE,
 		NCREG|NCSL,	RESC1,	/* should be 0 */
-		"	bl CL" COM "call (no args, result in r0) to scon/sname (CL)\n", },
+		"ZW CL" COM "call (no args, result in v0) to scon/sname (CL)\n", },
 
-{ UCALL,	INCREG | FEATURE_FPA,
-	SCON|SNAME,	TANY,
-	SCREG,		TDOUBLE|TLDOUBLE,
-		NCREG|NCSL,	RESC1,	/* should be 0 */
-		"	bl CL" COM "call (no args, result in r0:r1) to scon/sname (CL)\n", },
+{ CALL,		INCREG | FEATURE_FP,
+	SAREG,	TANY,
+	SCREG,	TFLOAT|TDOUBLE|TLDOUBLE,
+		NCREG,		RESC1,
+		"	blr AL" COM "call (args, result in v0) to register\n"
+		"ZC", },
+
+{ UCALL,	INCREG | FEATURE_FP,
+	SAREG,	TANY,
+	SCREG,	TFLOAT|TDOUBLE|TLDOUBLE,
+		NCREG,		RESC1,
+		"	blr AL" COM "call (no args, result in v0) to register\n", },
 
 { CALL,		FOREFF,
 	SAREG,	TANY,
@@ -765,55 +657,37 @@ struct optab table[] = {
 		NBREG|NBSL,	RESC1,
 		"	adds A1,AL,AR" COM "64-bit addition\n", },
 
-{ PLUS,		INCREG | FEATURE_FPA,
-	SCREG,	TFLOAT,
-	SCREG,	TFLOAT,
-		NCREG,	RESC1,
-		"	adfs A1,AL,AR" COM "float add\n", },
+{ PLUS,		INCREG | FEATURE_FP,
+	SCREG,	TFLOAT|TDOUBLE|TLDOUBLE,
+	SCREG,	TFLOAT|TDOUBLE|TLDOUBLE,
+		NCREG,		RESC1,
+		"	fadd A1,AL,AR" COM "float/double add\n", },
 
-{ PLUS,		INCREG | FEATURE_VFP,
-	SCREG,	TFLOAT,
-	SCREG,	TFLOAT,
-		NCREG,	RESC1,
-		"	fadds A1,AL,AR" COM "float add\n", },
+{ PLUS,		INCREG | FEATURE_FP,
+	SFMUL,	TFLOAT|TDOUBLE|TLDOUBLE,
+	SCREG,	TFLOAT|TDOUBLE|TLDOUBLE,
+		NCREG,		RESC1,
+		"	fmadd A1,ZM" COM "multiply and add\n", },
 
-{ PLUS,		INAREG,
+{ PLUS,		INCREG | FEATURE_FP,
+	SCREG,	TFLOAT|TDOUBLE|TLDOUBLE,
+	SFMUL,	TFLOAT|TDOUBLE|TLDOUBLE,
+		NCREG,		RESC1,
+		"	fmadd A1,ZM" COM "multiply and add\n", },
+
+{ PLUS,		INAREG | FEATURE_SOFTFLOAT,
 	SAREG,	TFLOAT,
 	SAREG,	TFLOAT,
 		NSPECIAL|NAREG,	RESC1,
 		"ZF", },
 
-{ PLUS,		INCREG | FEATURE_FPA,
-	SCREG,	TDOUBLE,
-	SCREG,	TDOUBLE,
-		NCREG,	RESC1,
-		"	adfd A1,AL,AR" COM "double add\n", },
-
-{ PLUS,		INCREG | FEATURE_VFP,
-	SCREG,	TDOUBLE,
-	SCREG,	TDOUBLE,
-		NCREG,	RESC1,
-		"	faddd A1,AL,AR" COM "double add\n", },
-
-{ PLUS,		INBREG,
+{ PLUS,		INBREG | FEATURE_SOFTFLOAT,
 	SBREG,	TDOUBLE,
 	SBREG,	TDOUBLE,
 		NSPECIAL|NBREG,	RESC1,
 		"ZF", },
 
-{ PLUS,		INCREG | FEATURE_FPA,
-	SCREG,	TLDOUBLE,
-	SCREG,	TLDOUBLE,
-		NCREG,	RESC1,
-		"	adfe A1,AL,AR" COM "ldouble add\n", },
-
-{ PLUS,		INCREG | FEATURE_VFP,
-	SCREG,	TLDOUBLE,
-	SCREG,	TLDOUBLE,
-		NCREG,	RESC1,
-		"	faddd A1,AL,AR" COM "ldouble add\n", },
-
-{ PLUS,		INBREG,
+{ PLUS,		INBREG | FEATURE_SOFTFLOAT,
 	SBREG,	TLDOUBLE,
 	SBREG,	TLDOUBLE,
 		NSPECIAL|NBREG,	RESC1,
@@ -843,55 +717,37 @@ struct optab table[] = {
 		NBREG|NBSL,	RESC1,
 		"	subs A1,AL,AR" COM "64-bit subtraction\n", },
 
-{ MINUS,	INCREG | FEATURE_FPA,
-	SCREG,	TFLOAT,
-	SCREG,	TFLOAT,
-		NCREG,	RESC1,
-		"	sufs A1,AL,AR" COM "float subtraction\n", },
+{ MINUS,	INCREG | FEATURE_FP,
+	SCREG,	TFLOAT|TDOUBLE|TLDOUBLE,
+	SCREG,	TFLOAT|TDOUBLE|TLDOUBLE,
+		NCREG,		RESC1,
+		"	fsub A1,AL,AR" COM "float/double subtraction\n", },
 
-{ MINUS,	INCREG | FEATURE_VFP,
-	SCREG,	TFLOAT,
-	SCREG,	TFLOAT,
-		NCREG,	RESC1,
-		"	fsubs A1,AL,AR" COM "float subtraction\n", },
+{ MINUS,	INCREG | FEATURE_FP,
+	SCREG,	TFLOAT|TDOUBLE|TLDOUBLE,
+	SFMUL,	TFLOAT|TDOUBLE|TLDOUBLE,
+		NCREG,		RESC1,
+		"	fmsub A1,ZM" COM "multiply and subtract from\n", },
 
-{ MINUS,	INAREG,
+{ MINUS,	INCREG | FEATURE_FP,
+	SFMUL,	TFLOAT|TDOUBLE|TLDOUBLE,
+	SCREG,	TFLOAT|TDOUBLE|TLDOUBLE,
+		NCREG,		RESC1,
+		"	fnmsub A1,ZM" COM "multiply and subtract\n", },
+
+{ MINUS,	INAREG | FEATURE_SOFTFLOAT,
 	SAREG,	TFLOAT,
 	SAREG,	TFLOAT,
 		NSPECIAL|NAREG,	RESC1,
 		"ZF", },
 
-{ MINUS,	INCREG | FEATURE_FPA,
-	SCREG,	TDOUBLE,
-	SCREG,	TDOUBLE,
-		NCREG,	RESC1,
-		"	sufd A1,AL,AR" COM "double subtraction\n", },
-
-{ MINUS,	INCREG | FEATURE_VFP,
-	SCREG,	TDOUBLE,
-	SCREG,	TDOUBLE,
-		NCREG,	RESC1,
-		"	fsubd A1,AL,AR" COM "double subtraction\n", },
-
-{ MINUS,	INBREG,
+{ MINUS,	INBREG | FEATURE_SOFTFLOAT,
 	SBREG,	TDOUBLE,
 	SBREG,	TDOUBLE,
 		NSPECIAL|NBREG,	RESC1,
 		"ZF", },
 
-{ MINUS,	INCREG | FEATURE_FPA,
-	SCREG,	TLDOUBLE,
-	SCREG,	TLDOUBLE,
-		NCREG,	RESC1,
-		"	sufe A1,AL,AR" COM "ldouble subtraction\n", },
-
-{ MINUS,	INCREG | FEATURE_VFP,
-	SCREG,	TLDOUBLE,
-	SCREG,	TLDOUBLE,
-		NCREG,	RESC1,
-		"	fsubd A1,AL,AR" COM "double subtraction\n", },
-
-{ MINUS,	INBREG,
+{ MINUS,	INBREG | FEATURE_SOFTFLOAT,
 	SBREG,	TLDOUBLE,
 	SBREG,	TLDOUBLE,
 		NSPECIAL|NBREG,	RESC1,
@@ -1011,56 +867,34 @@ struct optab table[] = {
 		NAREG|NASL,	RDEST,
 		"ZH", },
 
-{ ASSIGN, 	FOREFF|INCREG | FEATURE_FPA,
-	SOREG|SNAME,	TFLOAT,
-	SCREG,		TFLOAT,
-		0,	RDEST,
-		"	stfs AR,AL" COM "assign float\n", },
-
-{ ASSIGN, 	FOREFF|INCREG | FEATURE_VFP,
-	SOREG|SNAME,	TFLOAT,
-	SCREG,		TFLOAT,
-		0,	RDEST,
-		COM "unimplemented\n", },
-
-{ ASSIGN, 	FOREFF|INAREG,
+{ ASSIGN,	FOREFF|INCREG | FEATURE_FP,
+	SOREG,	TFLOAT|TDOUBLE|TLDOUBLE,
+	SCREG,	TFLOAT|TDOUBLE|TLDOUBLE,
+		0,		RDEST,
+		"	str AR,AL" COM "assign float/double\n", },
+
+{ ASSIGN,	FOREFF|INCREG | FEATURE_FP,
+	SNAME,	TFLOAT|TDOUBLE|TLDOUBLE,
+	SCREG,	TFLOAT|TDOUBLE|TLDOUBLE,
+		NAREG,		RDEST,
+		"	adrp A1,AL\n"
+		"	add A1,A1,:lo12:AL\n"
+		"	str AR,[A1]" COM "assign global float/double\n", },
+
+{ ASSIGN, 	FOREFF|INAREG | FEATURE_SOFTFLOAT,
 	SOREG|SNAME,	TFLOAT,
 	SAREG,		TFLOAT,
 		0,	RDEST,
 		"	str AR,AL" COM "assign float (soft-float)\n", },
 
-{ ASSIGN, 	FOREFF|INCREG | FEATURE_FPA,
-	SOREG|SNAME,	TDOUBLE,
-	SCREG,		TDOUBLE,
-		0,	RDEST,
-		"	stfd AR,AL" COM "assign double\n", },
-
-{ ASSIGN, 	FOREFF|INCREG | FEATURE_VFP,
-	SOREG|SNAME,	TDOUBLE,
-	SCREG,		TDOUBLE,
-		0,	RDEST,
-		COM "unimplemented\n", },
-
-{ ASSIGN, 	FOREFF|INBREG,
+{ ASSIGN, 	FOREFF|INBREG | FEATURE_SOFTFLOAT,
 	SOREG|SNAME,	TDOUBLE,
 	SBREG,		TDOUBLE,
 		0,	RDEST,
 		"	str AR,AL" COM "assign double (soft-float)\n"
 		"	str UR,UL\n", },
 
-{ ASSIGN, 	FOREFF|INCREG | FEATURE_FPA,
-	SOREG|SNAME,	TLDOUBLE,
-	SCREG,		TLDOUBLE,
-		0,	RDEST,
-		"	stfe AR,AL" COM "assign ldouble\n", },
-
-{ ASSIGN, 	FOREFF|INCREG | FEATURE_VFP,
-	SOREG|SNAME,	TLDOUBLE,
-	SCREG,		TLDOUBLE,
-		0,	RDEST,
-		COM "not implemented", },
-
-{ ASSIGN, 	FOREFF|INBREG,
+{ ASSIGN, 	FOREFF|INBREG | FEATURE_SOFTFLOAT,
 	SOREG|SNAME,	TLDOUBLE,
 	SBREG,		TLDOUBLE,
 		0,	RDEST,
@@ -1080,37 +914,19 @@ struct optab table[] = {
                 0,      RDEST,
                 "	mov AL,AR" COM "assign AR to AL\n", },
 
-{ ASSIGN,	FOREFF|INCREG | FEATURE_FPA,
-	SCREG,	TFLOAT,
-	SCREG,	TFLOAT,
-		0,	RDEST,
-		"	mvf AL,AR" COM "assign float reg to float reg\n", },
-
-{ ASSIGN,	FOREFF|INCREG | FEATURE_VFP,
-	SCREG,	TFLOAT,
-	SCREG,	TFLOAT,
-		0,	RDEST,
-		"	fcpys AL,AR" COM "assign float reg to float reg\n", },
+{ ASSIGN,	FOREFF|INCREG | FEATURE_FP,
+	SCREG,	TFLOAT|TDOUBLE|TLDOUBLE,
+	SCREG,	TFLOAT|TDOUBLE|TLDOUBLE,
+		0,		RDEST,
+		"	fmov AL,AR" COM "assign float reg to float reg\n", },
 
-{ ASSIGN,	FOREFF|INAREG,
+{ ASSIGN,	FOREFF|INAREG | FEATURE_SOFTFLOAT,
 	SAREG,	TFLOAT,
 	SAREG,	TFLOAT,
 		0,	RDEST,
 		"	mov AL,AR" COM "assign float reg to float reg\n", },
 
-{ ASSIGN,	FOREFF|INCREG | FEATURE_FPA,
-	SCREG,	TDOUBLE|TLDOUBLE,
-	SCREG,	TDOUBLE|TLDOUBLE,
-		0,	RDEST,
-		"	mvf AL,AR" COM "assign float reg to float reg\n", },
-
-{ ASSIGN,	FOREFF|INCREG | FEATURE_VFP,
-	SCREG,	TDOUBLE|TLDOUBLE,
-	SCREG,	TDOUBLE|TLDOUBLE,
-		0,	RDEST,
-		"	fcpyd AL,AR" COM "assign float reg to float reg\n", },
-
-{ ASSIGN,	FOREFF|INBREG,
+{ ASSIGN,	FOREFF|INBREG | FEATURE_SOFTFLOAT,
 	SBREG,	TDOUBLE|TLDOUBLE,
 	SBREG,	TDOUBLE|TLDOUBLE,
 		0,	RDEST,
@@ -1181,55 +997,25 @@ struct optab table[] = {
                 "	udiv x0,AL,AR" COM "long/longlong unsigned divide\n",},
 
 
-{ DIV,	INCREG | FEATURE_FPA,
-	SCREG,		TFLOAT,
-	SCREG,		TFLOAT,
-		NCREG,	RESC1,
-		"	dvfs A1,AL,AL" COM "fast (float) divide\n", },
-
-{ DIV,	INCREG | FEATURE_VFP,
-	SCREG,		TFLOAT,
-	SCREG,		TFLOAT,
-		NCREG,	RESC1,
-		"	fdivs A1,AL,AL" COM "fast (float) divide\n", },
+{ DIV,		INCREG | FEATURE_FP,
+	SCREG,	TFLOAT|TDOUBLE|TLDOUBLE,
+	SCREG,	TFLOAT|TDOUBLE|TLDOUBLE,
+		NCREG,		RESC1,
+		"	fdiv A1,AL,AR" COM "float/double divide\n", },
 
-{ DIV,	INAREG,
+{ DIV,	INAREG | FEATURE_SOFTFLOAT,
 	SAREG,		TFLOAT,
 	SAREG,		TFLOAT,
 		NSPECIAL|NAREG,	RESC1,
 		"ZF", },
 
-{ DIV,	INCREG | FEATURE_FPA,
-	SCREG,		TDOUBLE,
-	SCREG,		TDOUBLE,
-		NCREG,	RESC1,
-		"	dvfd A1,AL,AL" COM "double divide\n", },
-
-{ DIV,	INCREG | FEATURE_VFP,
-	SCREG,		TDOUBLE,
-	SCREG,		TDOUBLE,
-		NCREG,	RESC1,
-		"	fdivd A1,AL,AL" COM "double divide\n", },
-
-{ DIV,	INBREG,
+{ DIV,	INBREG | FEATURE_SOFTFLOAT,
 	SBREG,		TDOUBLE,
 	SBREG,		TDOUBLE,
 		NSPECIAL|NBREG,	RESC1,
 		"ZF", },
 
-{ DIV,	INCREG | FEATURE_FPA,
-	SCREG,		TLDOUBLE,
-	SCREG,		TLDOUBLE,
-		NCREG,	RESC1,
-		"	dvfe A1,AL,AR" COM "long double load\n", },
-
-{ DIV,	INCREG | FEATURE_VFP,
-	SCREG,		TLDOUBLE,
-	SCREG,		TLDOUBLE,
-		NCREG,	RESC1,
-		"	fdivd A1,AL,AL" COM "double divide\n", },
-
-{ DIV,	INBREG,
+{ DIV,	INBREG | FEATURE_SOFTFLOAT,
 	SBREG,		TLDOUBLE,
 	SBREG,		TLDOUBLE,
 		NSPECIAL|NBREG,	RESC1,
@@ -1337,37 +1123,19 @@ struct optab table[] = {
 		NSPECIAL|NBREG,	RESC1,
 		"ZE", },
 
-{ MUL,	INCREG | FEATURE_FPA,
-	SCREG,		TFLOAT,
-	SCREG,		TFLOAT,
-		NCREG,	RESC1,
-		"	fmls A1,AL,AL" COM "fast (float) multiply\n", },
-
-{ MUL,	INCREG | FEATURE_VFP,
-	SCREG,		TFLOAT,
-	SCREG,		TFLOAT,
-		NCREG,	RESC1,
-		"	fmuls A1,AL,AL" COM "float multiply\n", },
+{ MUL,		INCREG | FEATURE_FP,
+	SCREG,	TFLOAT|TDOUBLE|TLDOUBLE,
+	SCREG,	TFLOAT|TDOUBLE|TLDOUBLE,
+		NCREG,		RESC1,
+		"	fmul A1,AL,AR" COM "float/double multiply\n", },
 
-{ MUL,	INAREG,
+{ MUL,	INAREG | FEATURE_SOFTFLOAT,
 	SAREG,		TFLOAT,
 	SAREG,		TFLOAT,
 		NSPECIAL|NAREG,	RESC1,
 		"ZF", },
 
-{ MUL,	INCREG | FEATURE_FPA,
-	SCREG,		TDOUBLE|TLDOUBLE,
-	SCREG,		TDOUBLE|TLDOUBLE,
-		NCREG,	RESC1,
-		"	mufd A1,AL,AL" COM "fast (l)double multiply\n", },
-
-{ MUL,	INCREG | FEATURE_VFP,
-	SCREG,		TDOUBLE|TLDOUBLE,
-	SCREG,		TDOUBLE|TLDOUBLE,
-		NCREG,	RESC1,
-		"	muld A1,AL,AL" COM "(l)double multiply\n", },
-
-{ MUL,	INBREG,
+{ MUL,	INBREG | FEATURE_SOFTFLOAT,
 	SBREG,		TDOUBLE|TLDOUBLE,
 	SBREG,		TDOUBLE|TLDOUBLE,
 		NSPECIAL|NBREG,	RESC1,
@@ -1419,56 +1187,26 @@ struct optab table[] = {
 		NBREG,	RESC1,
 		"	ldr A1,AL" COM "64-bit load\n", },
 
-{ UMUL, INCREG | FEATURE_FPA,
-	SANY,		TANY,
-	SOREG|SNAME,	TFLOAT,
-		NCREG,	RESC1,
-		"	ldfs A1,AL" COM "float load\n", },
-
-{ UMUL, INCREG | FEATURE_VFP,
-	SANY,		TANY,
-	SOREG|SNAME,	TFLOAT,
-		NCREG,	RESC1,
-		COM "not implemented\n", },
+{ UMUL,		INCREG | FEATURE_FP,
+	SANY,	TANY,
+	SOREG|SNAME,	TFLOAT|TDOUBLE|TLDOUBLE,
+		NCREG,		RESC1,
+		"	ldr A1,AL" COM "float/double load\n", },
 
-{ UMUL, INAREG,
+{ UMUL, INAREG | FEATURE_SOFTFLOAT,
 	SANY,		TANY,
 	SOREG|SNAME,	TFLOAT,
 		NAREG,	RESC1,
 		"	ldr A1,AL" COM "float load\n", },
 
-{ UMUL, INCREG | FEATURE_FPA,
-	SANY,		TANY,
-	SOREG|SNAME,	TDOUBLE,
-		NCREG,	RESC1,
-		"	ldfd A1,AL" COM "double load\n", },
-
-{ UMUL, INCREG | FEATURE_VFP,
-	SANY,		TANY,
-	SOREG|SNAME,	TDOUBLE,
-		NCREG,	RESC1,
-		COM "not implemented\n", },
-
-{ UMUL, INBREG,
+{ UMUL, INBREG | FEATURE_SOFTFLOAT,
 	SANY,		TANY,
 	SOREG|SNAME,	TDOUBLE,
 		NBREG,	RESC1,
 		"	ldr A1,AL" COM "double load\n"
 		"	ldr U1,UL\n", },
 
-{ UMUL, INCREG | FEATURE_FPA,
-	SANY,		TANY,
-	SOREG|SNAME,	TLDOUBLE,
-		NCREG,	RESC1,
-		"	ldfe A1,AL" COM "long double load\n", },
-
-{ UMUL, INCREG | FEATURE_VFP,
-	SANY,		TANY,
-	SOREG|SNAME,	TLDOUBLE,
-		NCREG,	RESC1,
-		COM "not implemented\n", },
-
-{ UMUL, INBREG,
+{ UMUL, INBREG | FEATURE_SOFTFLOAT,
 	SANY,		TANY,
 	SOREG|SNAME,	TLDOUBLE,
 		NBREG,	RESC1,
@@ -1500,55 +1238,26 @@ struct optab table[] = {
 		0, 	RESCC,
 		"	cmp AL,AR" COM "AR-AL (sets flags)\n", },
 
-{ OPLOG,	FORCC | FEATURE_FPA,
-	SCREG,	TFLOAT,
-	SCREG,	TFLOAT,
-		NSPECIAL,	RESCC,
-		"	cmfs AL,AR" COM "float compare\n", },
-
-{ OPLOG,	FORCC | FEATURE_VFP,
-	SCREG,	TFLOAT,
-	SCREG,	TFLOAT,
-		0,	RESCC,
-		"	fcmps AL,AR" COM "float compare\n", },
+{ OPLOG,	FORCC | FEATURE_FP,
+	SCREG,	TFLOAT|TDOUBLE|TLDOUBLE,
+	SCREG,	TFLOAT|TDOUBLE|TLDOUBLE,
+		0,		RNOP,
+		"	fcmp AL,AR\n"
+		"ZU", },
 
-{ OPLOG,	FORCC,
+{ OPLOG,	FORCC | FEATURE_SOFTFLOAT,
 	SAREG,	TFLOAT,
 	SAREG,	TFLOAT,
 		NSPECIAL,	RESCC,
 		"ZF", },
 
-{ OPLOG,	FORCC | FEATURE_FPA,
-	SCREG,	TDOUBLE,
-	SCREG,	TDOUBLE,
-		NSPECIAL,	RESCC,
-		"	cmfd AL,AR" COM "double compare\n", },
-
-{ OPLOG,	FORCC | FEATURE_VFP,
-	SCREG,	TDOUBLE,
-	SCREG,	TDOUBLE,
-		0,	RESCC,
-		"	fcmpd AL,AR" COM "double compare\n", },
-
-{ OPLOG,	FORCC,
+{ OPLOG,	FORCC | FEATURE_SOFTFLOAT,
 	SBREG,	TDOUBLE,
 	SBREG,	TDOUBLE,
 		NSPECIAL,	RESCC,
 		"ZF", },
 
-{ OPLOG,	FORCC | FEATURE_FPA,
-	SCREG,	TLDOUBLE,
-	SCREG,	TLDOUBLE,
-		NSPECIAL,	RESCC,
-		"	cmfe AL,AR" COM "ldouble compare\n", },
-
-{ OPLOG,	FORCC | FEATURE_VFP,
-	SCREG,	TLDOUBLE,
-	SCREG,	TLDOUBLE,
-		0,	RESCC,
-		"	fcmpd AL,AR" COM "double compare\n", },
-
-{ OPLOG,	FORCC,
+{ OPLOG,	FORCC | FEATURE_SOFTFLOAT,
 	SBREG,	TLDOUBLE,
 	SBREG,	TLDOUBLE,
 		NSPECIAL,	RESCC,
@@ -1665,56 +1374,32 @@ struct optab table[] = {
                 NBREG,  RESC1,
 		"	mov A1,AL" COM "load AL into A1\n", },
 
-{ OPLTYPE,	INCREG | FEATURE_FPA,
-	SANY,		TANY,
-	SOREG|SNAME,	TFLOAT,
-		NCREG,	RESC1,
-		"	ldfs A1,AL" COM "load float\n", },
+{ OPLTYPE,	INCREG | FEATURE_FP,
+	SANY,	TANY,
+	SOREG|SNAME,	TFLOAT|TDOUBLE|TLDOUBLE,
+		NCREG,		RESC1,
+		"	ldr A1,AL" COM "load float/double\n", },
 
-{ OPLTYPE,	INCREG | FEATURE_VFP,
-	SANY,		TANY,
-	SOREG|SNAME,	TFLOAT,
-		NCREG,	RESC1,
-		COM "not implemented\n", },
+{ OPLTYPE,	INCREG | FEATURE_FP,
+	SANY,	TANY,
+	SCREG,	TFLOAT|TDOUBLE|TLDOUBLE,
+		NCREG,		RESC1,
+		"	fmov A1,AL" COM "load AL into A1\n", },
 
-{ OPLTYPE,	INAREG,
+{ OPLTYPE,	INAREG | FEATURE_SOFTFLOAT,
 	SANY,		TANY,
 	SOREG|SNAME,	TFLOAT,
 		NAREG,	RESC1,
 		"	ldr A1,AL" COM "load float (soft-float)\n", },
 
-{ OPLTYPE,	INCREG | FEATURE_FPA,
-	SANY,		TANY,
-	SOREG|SNAME,	TDOUBLE,
-		NCREG,	RESC1,
-		"	ldfd A1,AL" COM "load double\n", },
-
-{ OPLTYPE,	INCREG | FEATURE_VFP,
-	SANY,		TANY,
-	SOREG|SNAME,	TDOUBLE,
-		NCREG,	RESC1,
-		COM "not implemented\n" },
-
-{ OPLTYPE,	INBREG,
+{ OPLTYPE,	INBREG | FEATURE_SOFTFLOAT,
 	SANY,		TANY,
 	SOREG|SNAME,	TDOUBLE,
 		NBREG,	RESC1,
 		"	ldr A1,AL" COM "load double (soft-float)\n"
 		"	ldr U1,UL\n", },
 
-{ OPLTYPE,	INCREG | FEATURE_FPA,
-	SANY,		TANY,
-	SOREG|SNAME,	TLDOUBLE,
-		NCREG,	RESC1,
-		"	ldfe A1,AL" COM "load ldouble\n", },
-
-{ OPLTYPE,	INCREG | FEATURE_VFP,
-	SANY,		TANY,
-	SOREG|SNAME,	TLDOUBLE,
-		NCREG,	RESC1,
-		COM "not implemented\n", },
-
-{ OPLTYPE,	INBREG,
+{ OPLTYPE,	INBREG | FEATURE_SOFTFLOAT,
 	SANY,		TANY,
 	SOREG|SNAME,	TLDOUBLE,
 		NBREG,	RESC1,
@@ -1737,55 +1422,25 @@ struct optab table[] = {
 		NBREG|NBSL,	RESC1,
 		"	neg A1,AL" COM "64-bit negation\n", },
 
-{ UMINUS,	INCREG | FEATURE_FPA,
-	SCREG,	TFLOAT,
-	SCREG,	TFLOAT,
-		NCREG,	RESC1,
-		"	mvfs A1,AL" COM "float negation\n", },
-
-{ UMINUS,	INCREG | FEATURE_VFP,
-	SCREG,	TFLOAT,
-	SCREG,	TFLOAT,
-		NCREG,	RESC1,
-		"	negs A1,AL" COM "float negation\n", },
+{ UMINUS,	INCREG | FEATURE_FP,
+	SCREG,	TFLOAT|TDOUBLE|TLDOUBLE,
+	SCREG,	TFLOAT|TDOUBLE|TLDOUBLE,
+		NCREG,		RESC1,
+		"	fneg A1,AL" COM "float/double negation\n", },
 
-{ UMINUS,	INAREG,
+{ UMINUS,	INAREG | FEATURE_SOFTFLOAT,
 	SAREG,	TFLOAT,
 	SAREG,	TFLOAT,
 		NSPECIAL|NAREG,	RESC1,
 		"ZF", },
 
-{ UMINUS,	INCREG | FEATURE_FPA,
-	SCREG,	TDOUBLE,
-	SCREG,	TDOUBLE,
-		NCREG,	RESC1,
-		"	mvfd A1,AL" COM "double negation\n", },
-
-{ UMINUS,	INCREG | FEATURE_VFP,
-	SCREG,	TDOUBLE,
-	SCREG,	TDOUBLE,
-		NCREG,	RESC1,
-		"	negd A1,AL" COM "double negation\n", },
-
-{ UMINUS,	INBREG,
+{ UMINUS,	INBREG | FEATURE_SOFTFLOAT,
 	SBREG,	TDOUBLE,
 	SBREG,	TDOUBLE,
 		NSPECIAL|NBREG,	RESC1,
 		"ZF", },
 
-{ UMINUS,	INCREG | FEATURE_FPA,
-	SCREG,	TLDOUBLE,
-	SCREG,	TLDOUBLE,
-		NCREG,	RESC1,
-		"	mvfe A1,AL" COM "ldouble negation\n", },
-
-{ UMINUS,	INCREG | FEATURE_VFP,
-	SCREG,	TLDOUBLE,
-	SCREG,	TLDOUBLE,
-		NCREG,	RESC1,
-		"	negd A1,AL" COM "ldouble negation\n", },
-
-{ UMINUS,	INBREG,
+{ UMINUS,	INBREG | FEATURE_SOFTFLOAT,
 	SBREG,	TLDOUBLE,
 	SBREG,	TLDOUBLE,
 		NSPECIAL|NBREG,	RESC1,
@@ -1803,6 +1458,79 @@ struct optab table[] = {
 		NBREG|NBSL,	RESC1,
 		"	mvn A1,AL" COM "64-bit complement\n", },
 
+/*
+ * Atomic operations.  Left is a pointer to the object.
+ * All are emitted as exclusive load/store loops by ZA.
+ */
+
+{ XADD,		INAREG|FOREFF,
+	SAREG,	TPOINT,
+	SAREG,	TINT|TUNSIGNED|TSHORT|TUSHORT|TCHAR|TUCHAR,
+		3*NAREG,	RESC1,
+		"ZA", },
+
+{ XCHG,		INAREG|FOREFF,
+	SAREG,	TPOINT,
+	SAREG,	TINT|TUNSIGNED|TSHORT|TUSHORT|TCHAR|TUCHAR,
+		2*NAREG,	RESC1,
+		"ZA", },
+
+{ CMPXCHG,	INAREG|FOREFF,
+	SAREG,	TPOINT,
+	SAREG,	TINT|TUNSIGNED|TSHORT|TUSHORT|TCHAR|TUCHAR,
+		NSPECIAL|NAREG,	RDEST,
+		"ZA", },
+
+/* old and new value of CMPXCHG, the new value goes to a fixed register */
+{ CM,		INAREG,
+	SAREG,	TINT|TUNSIGNED|TSHORT|TUSHORT|TCHAR|TUCHAR,
+	SAREG,	TINT|TUNSIGNED|TSHORT|TUSHORT|TCHAR|TUCHAR,
+		NSPECIAL,	RLEFT,
+		"", },
+
+/* 64-bit objects */
+{ XADD,		INBREG|FOREFF,
+	SAREG,	TPOINT,
+	SBREG,	TLONG|TULONG|TLONGLONG|TULONGLONG,
+		NSPECIAL|3*NBREG,	RESC1,
+		"ZA", },
+
+{ XCHG,		INBREG|FOREFF,
+	SAREG,	TPOINT,
+	SBREG,	TLONG|TULONG|TLONGLONG|TULONGLONG,
+		NSPECIAL|2*NBREG,	RESC1,
+		"ZA", },
+
+{ CMPXCHG,	INBREG|FOREFF,
+	SAREG,	TPOINT,
+	SBREG,	TLONG|TULONG|TLONGLONG|TULONGLONG,
+		NSPECIAL|NBREG,	RDEST,
+		"ZA", },
+
+{ CM,		INBREG,
+	SBREG,	TLONG|TULONG|TLONGLONG|TULONGLONG,
+	SBREG,	TLONG|TULONG|TLONGLONG|TULONGLONG,
+		NSPECIAL,	RLEFT,
+		"", },
+
+{ FENCE,	FOREFF,
+	SZERO,	TANY,
+	SANY,	TANY,
+		0,	0,
+		"	dmb ish" COM "full barrier\n", },
+
+{ FENCE,	FOREFF,
+	SONE,	TANY,
+	SANY,	TANY,
+		0,	0,
+		"	dmb ishld" COM "acquire barrier\n", },
+
+{ FENCE,	FOREFF,
+	SANY,	TANY,
+	SANY,	TANY,
+		0,	0,
+		"	dmb ish" COM "release barrier\n", },
+
 /*
  * Arguments to functions.
  */
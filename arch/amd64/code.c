@@ -104,11 +104,22 @@ setseg(int seg, char *name)
 void
 setseg(int seg, char *name)
 {
+	if (name != NULL && seg != NMSEG) { /* section of its own */
+		printf("\t.section %s,\"%s\",@%s\n", name,
+		    seg == PROG ? "ax" : seg == RDATA ? "a" :
+		    seg == TLSDATA || seg == TLSUDATA ? "awT" : "aw",
+		    seg == UDATA || seg == TLSUDATA ? "nobits" : "progbits");
+		return;
+	}
 	switch (seg) {
 	case PROG: name = ".text"; break;
 	case DATA:
 	case LDATA: name = ".data"; break;
+#ifdef ELFABI
+	case STRNG: name = ".section .rodata.str1.1,\"aMS\",@progbits,1"; break;
+#else
 	case STRNG:
+#endif
 	case RDATA: name = ".section .rodata"; break;
 	case UDATA: break;
 	case PICLDATA:
@@ -235,6 +246,7 @@ efcode(void)
 void
 bfcode(struct symtab **s, int cnt)
 {
+	extern int argsize;
 	union arglist *al;
 	struct symtab *sp;
 	NODE *p, *r;
@@ -349,6 +361,7 @@ bfcode(struct symtab **s, int cnt)
 			cerror("bfcode: %d", typ);
 		}
 	}
+	argsize = (nrsp - ARGINIT)/SZCHAR;
 
 	/* Check if there are varargs */
 	if (cftnsp->sdf == NULL || cftnsp->sdf->dfun == NULL)
@@ -735,6 +735,13 @@ defzero(struct symtab *sp)
 		printf("\t.comm %s,0%llo,%d\n", name, off, al);
 	}
 #else
+	if (sp->sclass == STATIC && datasects) {
+		/* in a .bss section of its own */
+		locctr(UDATA, sp);
+		defloc(sp);
+		printf("\t.zero %lld\n", off);
+		return;
+	}
 	if (sp->sclass == STATIC) {
 		if (sp->slevel == 0) {
 			printf("\t.local %s\n", name);
@@ -863,8 +870,28 @@ fixdef(struct symtab *sp)
 	}
 }
 
+int argsize;		/* args on stack, set by bfcode() */
+
 void
 pass1_lastchance(struct interpass *ip)
 {
+	if (ip->type == IP_PROLOG || ip->type == IP_EPILOG)
+		((struct interpass_prolog *)ip)->ipp_argsize = argsize;
 }
 
+#ifdef PASS1
+int mcmodel = MCSMALL;
+
+/*
+ * Pass1 part of the target-dependent command-line options,
+ * see also mflags() in local2.c.
+ */
+void
+mflags(char *str)
+{
+	if (strcmp(str, "cmodel=medium") == 0)
+		mcmodel = MCMEDIUM;
+	else if (strcmp(str, "cmodel=large") == 0)
+		mcmodel = MCLARGE;
+}
+#endif
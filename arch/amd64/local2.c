@@ -36,15 +36,38 @@ static int stkpos;
 void
 deflab(int label)
 {
-	printf(LABFMT ":\n", label);
+	outlab(label);
+	outstr(":\n");
 }
 
 static int regoff[MAXREGS];
 static TWORD ftype;
 char *rbyte[], *rshort[], *rlong[];
 static int needframe;
+static int swlab;	/* early returns jump here, past restregs() */
 int mcmodel = MCSMALL;
 
+/*
+ * Return the code to save the permanent registers.
+ */
+static char *
+savregs(void)
+{
+	char *s, *d;
+	int i, n;
+
+	for (i = n = 0; i < MAXREGS; i++)
+		if (TESTBIT(p2env.p_regs, i))
+			n++;
+	s = d = tmpalloc(n * 32 + 1);
+	*d = 0;
+	for (i = 0; i < MAXREGS; i++)
+		if (TESTBIT(p2env.p_regs, i))
+			d += sprintf(d, "\tmovq %s,-%d(%s)\n",
+			    rnames[i], regoff[i], rnames[FPREG]);
+	return s;
+}
+
 /*
  * Print out the prolog assembler.
  * addto and regoff are already calculated.
@@ -52,19 +75,18 @@ int mcmodel = MCSMALL;
 static void
 prtprolog(struct interpass_prolog *ipp, int addto)
 {
-	int i;
-
-	printf("\tpushq %%rbp\n");
-	printf("\tmovq %%rsp,%%rbp\n");
+	outstr("\tpushq %rbp\n");
+	outstr("\tmovq %rsp,%rbp\n");
 	addto = (addto+15) & ~15; /* 16-byte aligned */
-	if (addto)
-		printf("\tsubq $%d,%%rsp\n", addto);
+	if (addto) {
+		outstr("\tsubq $");
+		outnum(addto);
+		outstr(",%rsp\n");
+	}
 
 	/* save permanent registers */
-	for (i = 0; i < MAXREGS; i++)
-		if (TESTBIT(p2env.p_regs, i))
-			printf("\tmovq %s,-%d(%s)\n",
-			    rnames[i], regoff[i], rnames[FPREG]);
+	if (swlab == 0)
+		outstr(savregs());
 }
 
 /*
@@ -86,10 +108,12 @@ offcalc(struct interpass_prolog *ipp)
 	return addto;
 }
 
+static int stackargs(NODE *);
+
 /*
  * Traverse a tree to check if we need to emit a frame at all.
  * We emit it if:
- * - any function call
+ * - any function call, except tail calls without stack arguments
  * - rsp or rbp referenced
  * Return 1 if frame is needed, 0 otherwise.
  */
@@ -100,7 +124,8 @@ chkf(NODE *p)
 
 	if ((o == REG || o == OREG) && (regno(p) == RBP || regno(p) == RSP))
 		return 1;
-	if (callop(o))
+	if (callop(o) && (attr_find(p->n_ap, ATTR_TAILCALL) == NULL ||
+	    stackargs(p)))
 		return 1;
 	if (optype(o) == UTYPE)
 		return chkf(p->n_left);
@@ -150,24 +175,46 @@ prologue(struct interpass_prolog *ipp)
 	addto = offcalc(ipp);
 	if (addto)
 		needframe = 1;
+	swlab = 0;
+	if (xshrinkwrap && needframe)
+		swlab = shrinkwrap(&p2env, savregs());
 	if (needframe)
 		prtprolog(ipp, addto);
 }
 
-void
-eoftn(struct interpass_prolog *ipp)
+/*
+ * Restore the registers saved by the prologue.
+ */
+static void
+restregs(void)
 {
 	int i;
 
+	for (i = 0; i < MAXREGS; i++)
+		if (TESTBIT(p2env.p_regs, i)) {
+			outstr("\tmovq -");
+			outnum(regoff[i]);
+			outchr('(');
+			outreg(FPREG);
+			outstr("),");
+			outreg(i);
+			outchr('\n');
+		}
+}
+
+void
+eoftn(struct interpass_prolog *ipp)
+{
 	if (ipp->ipp_ip.ip_lbl == 0)
 		return; /* no code needs to be generated */
 
-	if (needframe) {
+	if (p2env.p_tailend && swlab == 0)
+		;	/* left by the tail jump */
+	else if (needframe) {
 		/* return from function code */
-		for (i = 0; i < MAXREGS; i++)
-			if (TESTBIT(p2env.p_regs, i))
-				printf("	movq -%d(%s),%s\n",
-				    regoff[i], rnames[FPREG], rnames[i]);
+		restregs();
+		if (swlab)
+			deflab(swlab);
 
 		/* struct return needs special treatment */
 		if (ftype == STRTY || ftype == UNIONTY) {
@@ -175,11 +222,11 @@ eoftn(struct interpass_prolog *ipp)
 			printf("	leave\n");
 			printf("	ret $%d\n", 4);
 		} else {
-			printf("	leave\n");
-			printf("	ret\n");
+			outstr("\tleave\n");
+			outstr("\tret\n");
 		}
 	} else
-		printf("\tret\n");
+		outstr("\tret\n");
 
 #ifndef MACHOABI
 	printf("\t.size %s,.-%s\n", ipp->ipp_name, ipp->ipp_name);
@@ -216,7 +263,8 @@ hopcode(int f, int o)
 		comperr("hopcode2: %d", o);
 		str = 0; /* XXX gcc */
 	}
-	printf("%s%c", str, f);
+	outstr(str);
+	outchr(f);
 }
 
 /*
@@ -391,8 +439,8 @@ zzzcode(NODE *p, int c)
 		break;
 
 	case 'C':  /* remove from stack after subroutine call */
-		pr = p->n_qual;
-		if (p->n_op == UCALL)
+		pr = (p->n_qual+15) & ~15;
+		if (p->n_op == UCALL || attr_find(p->n_ap, ATTR_TAILCALL))
 			return; /* XXX remove ZC from UCALL */
 		if (pr)
 			printf("	addq $%d, %s\n", pr, rnames[RSP]);
@@ -459,12 +507,16 @@ zzzcode(NODE *p, int c)
 		lr = DECRA(l->n_reg, 0);
 		if (pr == lr)
 			break;
-		printf("	movb %s,%s\n", rbyte[lr], rbyte[pr]);
+		outstr("\tmovb ");
+		outstr(rbyte[lr]);
+		outchr(',');
+		outstr(rbyte[pr]);
+		outchr('\n');
 		l->n_rval = l->n_reg = p->n_reg; /* XXX - not pretty */
 		break;
 
 	case 'N': /* output long reg name */
-		printf("%s", rlong[getlr(p, '1')->n_rval]);
+		outstr(rlong[getlr(p, '1')->n_rval]);
 		break;
 
 	case 'P': /* Put hidden argument in rdi */
@@ -486,7 +538,17 @@ zzzcode(NODE *p, int c)
 		case INT: case UNSIGNED: s = 'l'; break;
 		default: s = 'q'; break;
 		}
-		printf("%c", s);
+		outchr(s);
+		break;
+
+	case 'x': /* new value register of CMPXCHG, see nspecial() */
+		switch (p->n_type) {
+		case CHAR: case UCHAR: rt = rbyte; break;
+		case SHORT: case USHORT: rt = rshort; break;
+		case INT: case UNSIGNED: rt = rlong; break;
+		default: rt = rnames; break;
+		}
+		outstr(rt[RCX]);
 		break;
 
 	case 'U': { /* output branch insn for ucomi */
@@ -508,18 +570,45 @@ zzzcode(NODE *p, int c)
 	case '1': /* special reg name printout (32-bit) */
 		l = getlr(p, '1');
 		rt = c == '8' ? rnames : rlong;
-		printf("%s", rt[l->n_rval]);
+		outstr(rt[l->n_rval]);
 		break;
 
 	case 'g':
 		p = p->n_left;
 		/* FALLTHROUGH */
 	case 'f': /* float or double */
-		printf("%c", p->n_type == FLOAT ? 's' : 'd');
+		outchr(p->n_type == FLOAT ? 's' : 'd');
 		break;
 
 	case 'q': /* int or long */
-		printf("%c", p->n_left->n_type == LONG ? 'q' : ' ');
+		outchr(p->n_left->n_type == LONG ? 'q' : ' ');
+		break;
+
+	case 'W': /* call, or leave and jump if a tail call */
+		if (attr_find(p->n_ap, ATTR_TAILCALL) == NULL) {
+			outstr("\tcall");
+			break;
+		}
+		/* move the arguments up over those of this function */
+		for (pr = 0; pr < (int)p->n_qual; pr += SZLONG/SZCHAR)
+			printf("\tpushq %d(%%rsp)\n\tpopq %d(%%rbp)\n",
+			    pr, pr + ARGINIT/SZCHAR);
+		if (needframe) {
+			restregs();
+			outstr("\tleave\n");
+		}
+		outstr("\tjmp");
+		break;
+
+	case 'X': /* lea address for multiply by 3, 5 or 9 */
+		l = getlr(p, 'L');
+		outchr('(');
+		outreg(l->n_rval);
+		outchr(',');
+		outreg(l->n_rval);
+		outchr(',');
+		outnum(getlval(p->n_right) - 1);
+		outchr(')');
 		break;
 
 	default:
@@ -588,7 +677,8 @@ shtemp(NODE *p)
 void
 adrcon(CONSZ val)
 {
-	printf("$" CONFMT, val);
+	outchr('$');
+	outnum(val);
 }
 
 void
@@ -599,11 +689,13 @@ conput(FILE *fp, NODE *p)
 	switch (p->n_op) {
 	case ICON:
 		if (p->n_name[0] != '\0') {
-			fprintf(fp, "%s", p->n_name);
-			if (val)
-				fprintf(fp, "+%ld", val);
+			fputstr(p->n_name, fp);
+			if (val) {
+				fputchr('+', fp);
+				fputnum(val, fp);
+			}
 		} else
-			fprintf(fp, "%ld", val);
+			fputnum(val, fp);
 		return;
 
 	default:
@@ -658,33 +750,44 @@ adrput(FILE *io, NODE *p)
 
 	case NAME:
 		if (p->n_name[0] != '\0') {
-			if (getlval(p) != 0)
-				fprintf(io, CONFMT "+", getlval(p));
-			fprintf(io, "%s(%%rip)", p->n_name);
+			if (getlval(p) != 0) {
+				fputnum(getlval(p), io);
+				fputchr('+', io);
+			}
+			fputstr(p->n_name, io);
+			fputstr("(%rip)", io);
 		} else
-			fprintf(io, CONFMT, getlval(p));
+			fputnum(getlval(p), io);
 		return;
 
 	case OREG:
 		r = p->n_rval;
-		if (p->n_name[0])
-			printf("%s%s", p->n_name, getlval(p) ? "+" : "");
+		if (p->n_name[0]) {
+			fputstr(p->n_name, io);
+			if (getlval(p))
+				fputchr('+', io);
+		}
 		if (getlval(p))
-			fprintf(io, "%lld", getlval(p));
+			fputnum(getlval(p), io);
+		fputchr('(', io);
 		if (R2TEST(r)) {
 			int r1 = R2UPK1(r);
 			int r2 = R2UPK2(r);
-			int sh = R2UPK3(r);
 
-			fprintf(io, "(%s,%s,%d)", 
-			    r1 == MAXREGS ? "" : rnames[r1],
-			    r2 == MAXREGS ? "" : rnames[r2], sh);
+			if (r1 != MAXREGS)
+				fputstr(rnames[r1], io);
+			fputchr(',', io);
+			if (r2 != MAXREGS)
+				fputstr(rnames[r2], io);
+			fputchr(',', io);
+			fputnum(R2UPK3(r), io);
 		} else
-			fprintf(io, "(%s)", rnames[p->n_rval]);
+			fputstr(rnames[p->n_rval], io);
+		fputchr(')', io);
 		return;
 	case ICON:
 		/* addressable value of the constant */
-		fputc('$', io);
+		fputchr('$', io);
 		conput(io, p);
 		return;
 
@@ -706,7 +809,7 @@ adrput(FILE *io, NODE *p)
 			rc = rnames;
 			break;
 		}
-		fprintf(io, "%s", rc[p->n_rval]);
+		fputstr(rc[p->n_rval], io);
 		return;
 
 	default:
@@ -737,7 +840,66 @@ cbgen(int o, int lab)
 {
 	if (o < EQ || o > UGT)
 		comperr("bad conditional branch: %s", opst[o]);
-	printf("	%s " LABFMT "\n", ccbranches[o-EQ], lab);
+	outchr('\t');
+	outstr(ccbranches[o-EQ]);
+	outchr(' ');
+	outlab(lab);
+	outchr('\n');
+}
+
+/*
+ * Can the move p be done with cmovcc after the compare rel?
+ * cmov has no byte form and always reads its source, so only
+ * registers, stack slots and static data are accepted.
+ */
+int
+cmovok(NODE *rel, NODE *p)
+{
+	NODE *r = p->n_right;
+
+	if (rel->n_left->n_type >= FLOAT && rel->n_left->n_type <= LDOUBLE)
+		return 0;
+	if (p->n_left->n_op != REG)
+		return 0;
+	switch (p->n_type) {
+	case SHORT: case USHORT: case INT: case UNSIGNED:
+	case LONG: case ULONG: case LONGLONG: case ULONGLONG:
+		break;
+	default:
+		if (!ISPTR(p->n_type))
+			return 0;
+	}
+	switch (r->n_op) {
+	case REG:
+		return szty(r->n_type) == szty(p->n_type);
+	case OREG:
+		return !R2TEST(r->n_rval) &&
+		    (r->n_rval == FPREG || r->n_rval == STKREG);
+	case NAME:
+		return r->n_name[0] != '\0';
+	}
+	return 0;
+}
+
+/*
+ * Print the conditional move p, to be done if condition o is true.
+ */
+void
+cmovgen(int o, NODE *p)
+{
+	NODE *l = p->n_left, *r = p->n_right;
+
+	if (r->n_op == REG && r->n_rval == l->n_rval)
+		return;
+	if (r->n_op == REG)
+		r->n_type = l->n_type;
+	outstr("\tcmov");
+	outstr(ccbranches[o-EQ] + 1);
+	outchr(' ');
+	adrput(stdout, r);
+	outchr(',');
+	adrput(stdout, l);
+	outchr('\n');
 }
 
 /*
@@ -790,6 +952,38 @@ fixcalls(NODE *p, void *arg)
 	}
 }
 
+/*
+ * Multiply by 3, 5 or 9 times 2, 4 or 8 is done as lea and shift,
+ * so that offstar() can use the shift as index scale.
+ */
+static void
+mulea(NODE *p, void *arg)
+{
+	CONSZ c;
+	int s;
+
+	if (p->n_op != MUL || p->n_right->n_op != ICON ||
+	    p->n_right->n_name[0] != '\0')
+		return;
+	switch (p->n_type) {
+	case INT: case UNSIGNED: case LONG: case ULONG:
+		break;
+	default:
+		return;
+	}
+	c = getlval(p->n_right);
+	for (s = 1; s <= 3 && (c & ((1 << s) - 1)) == 0; s++) {
+		if ((c >> s) == 3 || (c >> s) == 5 || (c >> s) == 9) {
+			setlval(p->n_right, c >> s);
+			p->n_left = mkbinode(MUL, p->n_left, p->n_right,
+			    p->n_type);
+			p->n_right = mklnode(ICON, s, 0, INT);
+			p->n_op = LS;
+			return;
+		}
+	}
+}
+
 void
 myreader(struct interpass *ipole)
 {
@@ -800,6 +994,7 @@ myreader(struct interpass *ipole)
 		if (ip->type != IP_NODE)
 			continue;
 		walkf(ip->ip_node, fixcalls, 0);
+		walkf(ip->ip_node, mulea, 0);
 	}
 	if (stkpos > p2autooff)
 		p2autooff = stkpos;
@@ -860,28 +1055,100 @@ myoptim(struct interpass *ip)
 {
 }
 
+/*
+ * Peephole patterns, see mip/peep.c.  32-bit operations clear the
+ * upper half of the register, so a movl or addl that looks useless
+ * may still be needed.
+ */
+static int
+peepis(char *s, char *set)
+{
+	return s[0] != 0 && s[1] == 0 && strchr(set, s[0]) != NULL;
+}
+
+/* @2 is a suffix of an operation that keeps the rest of the register */
+static int
+peepsz(char **v)
+{
+	return peepis(v[2], "bwq");
+}
+
+/* @2 is an integer size suffix */
+static int
+peepszany(char **v)
+{
+	return peepis(v[2], "bwlq");
+}
+
+/*
+ * @5 sets the flags from its result like a compare with zero, as far
+ * as the jump or set condition @3 looks at them.
+ */
+static int
+peepflags(char **v)
+{
+	static char *ops[] = { "add", "sub", "and", "or", "xor", NULL };
+	static char *cc[] = { "e", "ne", "z", "nz", "s", "ns", NULL };
+	int i, n;
+
+	for (i = 0; ops[i]; i++) {
+		n = strlen(ops[i]);
+		if (strncmp(v[5], ops[i], n) == 0 && strcmp(v[5] + n, v[2]) == 0)
+			break;
+	}
+	if (ops[i] == NULL)
+		return 0;
+	for (i = 0; cc[i]; i++)
+		if (strcmp(v[3], cc[i]) == 0)
+			return 1;
+	return 0;
+}
+
+struct peep peeptab[] = {
+	{ "jump to next", { "\tjmp @0", "@0:" }, { "@0:" } },
+	{ "add zero", { "\tadd@2 $0,@0" }, { NULL }, peepsz },
+	{ "sub zero", { "\tsub@2 $0,@0" }, { NULL }, peepsz },
+	{ "move to self", { "\tmovq %@0,%@0" }, { NULL } },
+	{ "move back", { "\tmov@2 %@0,%@1", "\tmov@2 %@1,%@0" },
+	    { "\tmov@2 %@0,%@1" }, peepsz },
+	{ "reload", { "\tmov@2 %@0,@1(%rbp)", "\tmov@2 @1(%rbp),%@0" },
+	    { "\tmov@2 %@0,@1(%rbp)" }, peepsz },
+	{ "store and load", { "\tmov@2 %@0,@1(%rbp)", "\tmov@2 @1(%rbp),%@3" },
+	    { "\tmov@2 %@0,@1(%rbp)", "\tmov@2 %@0,%@3" }, peepszany },
+	{ "compare zero", { "\t@5 @0,%@1", "\tcmp@2 $0,%@1", "\tj@3 @4" },
+	    { "\t@5 @0,%@1", "\tj@3 @4" }, peepflags },
+	{ "compare zero", { "\t@5 @0,%@1", "\tcmp@2 $0,%@1", "\tset@3 @4" },
+	    { "\t@5 @0,%@1", "\tset@3 @4" }, peepflags },
+	{ NULL },
+};
+
 void
 rmove(int s, int d, TWORD t)
 {
+	char **rc = rnames;
+	char *op;
 
 	switch (t) {
 	case INT:
 	case UNSIGNED:
-		printf("	movl %s,%s\n", rlong[s], rlong[d]);
+		op = "movl";
+		rc = rlong;
 		break;
 	case CHAR:
 	case UCHAR:
-		printf("	movb %s,%s\n", rbyte[s], rbyte[d]);
+		op = "movb";
+		rc = rbyte;
 		break;
 	case SHORT:
 	case USHORT:
-		printf("	movw %s,%s\n", rshort[s], rshort[d]);
+		op = "movw";
+		rc = rshort;
 		break;
 	case FLOAT:
-		printf("	movss %s,%s\n", rnames[s], rnames[d]);
+		op = "movss";
 		break;
 	case DOUBLE:
-		printf("	movsd %s,%s\n", rnames[s], rnames[d]);
+		op = "movsd";
 		break;
 	case LDOUBLE:
 #ifdef notdef
@@ -889,11 +1156,18 @@ rmove(int s, int d, TWORD t)
 		/* XXX can it fail anyway? */
 		comperr("bad float rmove: %d %d", s, d);
 #endif
-		break;
+		return;
 	default:
-		printf("	movq %s,%s\n", rnames[s], rnames[d]);
+		op = "movq";
 		break;
 	}
+	outchr('\t');
+	outstr(op);
+	outchr(' ');
+	outstr(rc[s]);
+	outchr(',');
+	outstr(rc[d]);
+	outchr('\n');
 }
 
 /*
@@ -968,22 +1242,86 @@ argsiz(NODE *p)
 /*
  * Calculate argument sizes.
  */
-void
-lastcall(NODE *p)
+static int
+stackargs(NODE *p)
 {
-	NODE *op = p;
 	int size = 0;
 
-	p->n_qual = 0;
 	if (p->n_op != CALL && p->n_op != FORTCALL && p->n_op != STCALL)
-		return;
+		return 0;
 	for (p = p->n_right; p->n_op == CM; p = p->n_left)
 		size += argsiz(p->n_right);
 	size += argsiz(p);
-	size = (size+15) & ~15;
+	return size;
+}
+
+void
+lastcall(NODE *p)
+{
+	int size = stackargs(p);
+
 	if (size)
-		printf("	subq $%d,%s\n", size, rnames[RSP]);
-	op->n_qual = size; /* XXX */
+		printf("	subq $%d,%s\n", (size+15) & ~15, rnames[RSP]);
+	p->n_qual = size; /* XXX */
+}
+
+/*
+ * Can the call p in tail position be done with a jump?  The arguments
+ * on the stack are moved over those of this function, so they must
+ * fit there, and struct arguments are not moved.  The called function
+ * must not be in a register that is restored before the jump.
+ */
+int
+tailcallok(struct interpass_prolog *ipp, NODE *p)
+{
+	NODE *l = p->n_left, *q;
+
+	if (stackargs(p) > ipp->ipp_argsize)
+		return 0;
+	if (p->n_op == CALL) {
+		for (q = p->n_right; q->n_op == CM; q = q->n_left)
+			if (q->n_right->n_op == STASG)
+				return 0;
+		if (q->n_op == STASG)
+			return 0;
+	}
+	if (l->n_op == REG)
+		return regno(l) != FPREG && regno(l) != STKREG &&
+		    !TESTBIT(p2env.p_regs, regno(l));
+	return l->n_op == ICON;
+}
+
+/*
+ * Does the tree p use any of the registers in regs?  Registers the
+ * instructions need are looked for as well, and only those if leaves
+ * is 0.
+ */
+int
+regsuse(NODE *p, bittype *regs, int leaves)
+{
+	struct optab *q;
+	struct rspecial *rc;
+	int i, r;
+
+	if (leaves && (p->n_op == REG || p->n_op == OREG) &&
+	    TESTBIT(regs, regno(p)))
+		return 1;
+	if (TBLIDX(p->n_su)) {
+		for (i = 0; i < 4; i++)
+			if ((r = DECRA(p->n_reg, i)) < MAXREGS &&
+			    TESTBIT(regs, r))
+				return 1;
+		q = &table[TBLIDX(p->n_su)];
+		if (q->needs & NSPECIAL)
+			for (rc = nspecial(q); rc->op; rc++)
+				if (TESTBIT(regs, rc->num))
+					return 1;
+	}
+	if (optype(p->n_op) == BITYPE && regsuse(p->n_right, regs, leaves))
+		return 1;
+	if (optype(p->n_op) != LTYPE)
+		return regsuse(p->n_left, regs, leaves);
+	return 0;
 }
 
 /*
@@ -1022,6 +1360,12 @@ special(NODE *p, int shape)
 		if (getlval(p) < MIN_INT || getlval(p) > MAX_INT)
 			break;
 		return SRDIR;
+	case SMULEA:
+		if (o != ICON || p->n_name[0])
+			break;
+		if (getlval(p) != 3 && getlval(p) != 5 && getlval(p) != 9)
+			break;
+		return SRDIR;
 	default:
 		cerror("special: %x\n", shape);
 	}
@@ -121,6 +121,11 @@ typedef long long OFFSZ;
 #define	TARGET_ENDIAN TARGET_LE	/* little-endian only */
 
 #define FINDMOPS	/* i386 has instructions that modifies memory */
+#define	CONDMOVE	/* has cmovcc, see ifconvert() */
+#define	TAILCALL	/* see tailcall() */
+#define	PEEPHOLE	/* see peeptab[] */
+#define	SHRINKWRAP	/* see shrinkwrap() */
+#define	BLOBINIT	/* print static data as strings, see init.c */
 
 #define	CC_DIV_0	/* division by zero is safe in the compiler */
 
@@ -244,6 +249,7 @@ int COLORMAP(int c, int *r);
 #define SMILWXOR	(MAXSPECIAL+5)
 #define SMIHWXOR	(MAXSPECIAL+6)
 #define SCON32		(MAXSPECIAL+7)	/* 32-bit constant */
+#define SMULEA		(MAXSPECIAL+8)	/* 3, 5 or 9, multiply with lea */
 
 /*
  * i386-specific symbol table flags.
@@ -262,12 +268,25 @@ int numconv(void *ip, void *p, void *q);
 #define	XASM_NUMCONV(ip, p, q)	numconv(ip, p, q)
 #define	XASMCONSTREGS(x)	xasmconstregs(x)
 
+/*
+ * amd64-specific interpass stuff.
+ */
+#define TARGET_IPP_MEMBERS			\
+	int ipp_argsize;	/* args on stack */
+
+#define	target_members_print_prolog(ipp)	ipint(ipp->ipp_argsize)
+#define	target_members_print_epilog(ipp)	ipint(ipp->ipp_argsize)
+#define	target_members_read_prolog(ipp)		(ipp->ipp_argsize = rdint(&p))
+#define	target_members_read_epilog(ipp)		(ipp->ipp_argsize = rdint(&p))
+
 #define	HAVE_WEAKREF
 #define TARGET_FLT_EVAL_METHOD	0	/* all as their type */
 /*
  * builtins.
  */
 #define TARGET_VALIST
+#define	TARGET_ATOMICS	(1|2|4|8)	/* object sizes with atomic insns */
+#define	TARGET_MULH	(4|8)		/* object sizes with MULH insns */
 #define TARGET_STDARGS
 #define TARGET_BUILTINS							\
 	{ "__builtin_stdarg_start", amd64_builtin_stdarg_start, 	\
@@ -48,6 +48,7 @@ notoff(TWORD t, int r, CONSZ off, char *cp)
 /*
  * Check if LS and try to make it indexable.
  * Ignore SCONV to long.
+ * If check is 2 only test, otherwise generate the index.
  * Return 0 if failed.
  */
 static int
@@ -63,11 +64,45 @@ findls(NODE *p, int check)
 		return 0;
 	if (check == 1 && p->n_left->n_op != REG)
 		return 0;
+	if (check == 2)
+		return 1;
 	if (!isreg(p->n_left))
 		(void)geninsn(p->n_left, INAREG);
 	return 1;
 }
 
+/*
+ * Is p a constant that can be an address displacement?
+ */
+static int
+isdisp(NODE *p)
+{
+	return p->n_op == ICON && p->n_name[0] == '\0' &&
+	    notoff(0, 0, getlval(p), 0) == 0;
+}
+
+/*
+ * Setup base + index of an address; the index is put to the right.
+ */
+static void
+baseidx(NODE *p)
+{
+	NODE *q;
+
+	if (findls(p->n_left, 2) && !findls(p->n_right, 2)) {
+		q = p->n_left;
+		p->n_left = p->n_right;
+		p->n_right = q;
+	}
+	if (!isreg(p->n_left))
+		(void)geninsn(p->n_left, INAREG);
+	if (isreg(p->n_right))
+		return; /* Matched (%rax,%rbx) */
+	if (findls(p->n_right, 0))
+		return; /* Matched (%rax,%rbx,4) */
+	(void)geninsn(p->n_right, INAREG);
+}
+
 /*
  * Turn a UMUL-referenced node into OREG.
  * Be careful about register classes, this is a place where classes change.
@@ -94,34 +129,27 @@ offstar(NODE *p, int shape)
 	if (findls(p, 0))
 		return; /* Matched (,%rax,8) */
 
-	if ((p->n_op == PLUS || p->n_op == MINUS) &&
-	    p->n_left->n_op == ICON &&
-	    p->n_left->n_name[0] == '\0' &&
-	    notoff(0, 0,  getlval(p->n_left), 0) == 0) {
+	l = NULL;
+	if ((p->n_op == PLUS || p->n_op == MINUS) && isdisp(p->n_left))
 		l = p->n_right;
+	else if (p->n_op == PLUS && isdisp(p->n_right))
+		l = p->n_left;
+	if (l != NULL) {
 		if (isreg(l))
 			return; /* Matched 4(%rax) */
 		if (findls(l, 0))
 			return; /* Matched 4(,%rax,8) */
-		if (l->n_op == PLUS && isreg(l->n_right)) {
-			if (findls(l->n_left, 0))
-				return; /* Matched 4(%rbx,%rax,8) */
-			(void)geninsn(l->n_left, INAREG);
-			return; /* Generate 4(%rbx,%rax) */
+		if (l->n_op == PLUS) {
+			baseidx(l);
+			return; /* Matched 4(%rbx,%rax,8) */
 		}
 		(void)geninsn(l, INAREG);
 		return; /* Generate 4(%rbx) */
 	}
 
 	if (p->n_op == PLUS) {
-		if (!isreg(p->n_left)) /* ensure right is REG */
-			(void)geninsn(p->n_left, INAREG);
-		if (isreg(p->n_right))
-			return; /* Matched (%rax,%rbx) */
-		if (findls(p->n_right, 0))
-			return; /* Matched (%rax,%rbx,4) */
-		(void)geninsn(p->n_right, INAREG);
-		return; /* Generate (%rbx,%rax) */
+		baseidx(p);
+		return; /* Matched (%rax,%rbx,4) */
 	}
 		
 	(void)geninsn(p, INAREG);
@@ -155,6 +183,9 @@ myormake(NODE *q)
 		c = getlval(p->n_left);
 		n = p->n_left->n_name;
 		p = p->n_right;
+	} else if (p->n_op == PLUS && isdisp(p->n_right)) {
+		c = getlval(p->n_right);
+		p = p->n_left;
 	}
 
 	if (p->n_op == PLUS && risreg(p->n_left)) {
@@ -261,6 +292,7 @@ nspecial(struct optab *q)
 		break;
 
 	case MOD:
+	case MULH:
 		if (q->ltype & TUCHAR) {
 			static struct rspecial s[] = {
 				{ NEVER, RAX },
@@ -313,6 +345,22 @@ nspecial(struct optab *q)
 		}
 		break;
 
+	case CMPXCHG:
+		{
+			static struct rspecial s[] = {
+				{ NRIGHT, RAX }, { NOLEFT, RCX },
+				{ NRES, RAX }, { 0 } };
+			return s;
+		}
+
+	case CM: /* operands of CMPXCHG */
+		{
+			static struct rspecial s[] = {
+				{ NLEFT, RAX }, { NRIGHT, RCX },
+				{ NRES, RAX }, { 0 } };
+			return s;
+		}
+
 	default:
 		break;
 	}
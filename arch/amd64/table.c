@@ -486,97 +486,97 @@ struct optab table[] = {
 	SCON,	TANY,
 	SANY,	TANY,
 		0,	0,
-		"	call CL\nZC", },
+		"ZW CL\nZC", },
 
 { UCALL,	FOREFF|MCSMALL|MCMEDIUM,
 	SCON,	TANY,
 	SANY,	TANY,
 		0,	0,
-		"	call CL\n", },
+		"ZW CL\n", },
 
 { CALL,	INAREG|MCSMALL|MCMEDIUM,
 	SCON,	TANY,
 	SAREG,	TLL|ANYFIXED|TPOINT,
 		NAREG|NASL,	RESC1,	/* should be 0 */
-		"	call CL\nZC", },
+		"ZW CL\nZC", },
 
 { UCALL,	INAREG|MCSMALL|MCMEDIUM,
 	SCON,	TANY,
 	SAREG,	TLL|ANYFIXED|TPOINT,
 		NAREG|NASL,	RESC1,	/* should be 0 */
-		"	call CL\n", },
+		"ZW CL\n", },
 
 { CALL,	INBREG,
 	SCON,	TANY|MCSMALL|MCMEDIUM,
 	SBREG,	TANY,
 		NBREG|NBSL,	RESC1,	/* should be 0 */
-		"	call CL\nZC", },
+		"ZW CL\nZC", },
 
 { UCALL,	INBREG|MCSMALL|MCMEDIUM,
 	SCON,	TANY,
 	SBREG,	TANY,
 		NBREG|NBSL,	RESC1,	/* should be 0 */
-		"	call CL\nZC", },
+		"ZW CL\nZC", },
 
 { CALL, INCREG|MCSMALL|MCMEDIUM,
 	SCON,	TANY,
 	SCREG,	TANY,
 		NCREG|NCSL,	RESC1,	/* should be 0 */
-		"	call CL\nZC", },
+		"ZW CL\nZC", },
 
 { UCALL,	INCREG|MCSMALL|MCMEDIUM,
 	SCON,	TANY,
 	SCREG,	TANY,
 		NCREG|NCSL,	RESC1,	/* should be 0 */
-		"	call CL\nZC", },
+		"ZW CL\nZC", },
 
 { CALL,		FOREFF,
 	SAREG,	TANY,
 	SANY,	TANY,
 		0,	0,
-		"	call *AL\nZC", },
+		"ZW *AL\nZC", },
 
 { UCALL,	FOREFF,
 	SAREG,	TANY,
 	SANY,	TANY,
 		0,	0,
-		"	call *AL\nZC", },
+		"ZW *AL\nZC", },
 
 { CALL,		INAREG,
 	SAREG,	TANY,
 	SANY,	TANY,
 		NAREG|NASL,	RESC1,	/* should be 0 */
-		"	call *AL\nZC", },
+		"ZW *AL\nZC", },
 
 { UCALL,	INAREG,
 	SAREG,	TANY,
 	SANY,	TANY,
 		NAREG|NASL,	RESC1,	/* should be 0 */
-		"	call *AL\nZC", },
+		"ZW *AL\nZC", },
 
 { CALL,		INBREG,
 	SAREG,	TANY,
 	SANY,	TANY,
 		NBREG|NBSL,	RESC1,	/* should be 0 */
-		"	call *AL\nZC", },
+		"ZW *AL\nZC", },
 
 { UCALL,	INBREG,
 	SAREG,	TANY,
 	SANY,	TANY,
 		NBREG|NBSL,	RESC1,	/* should be 0 */
-		"	call *AL\nZC", },
+		"ZW *AL\nZC", },
 
 { CALL,		INCREG,
 	SAREG,	TANY,
 	SANY,	TANY,
 		NCREG|NCSL,	RESC1,	/* should be 0 */
-		"	call *AL\nZC", },
+		"ZW *AL\nZC", },
 
 { UCALL,	INCREG,
 	SAREG,	TANY,
 	SANY,	TANY,
 		NCREG|NCSL,	RESC1,	/* should be 0 */
-		"	call *AL\nZC", },
+		"ZW *AL\nZC", },
 
 /* struct return */
 { USTCALL,	FOREFF,
@@ -786,14 +786,12 @@ struct optab table[] = {
 		0,	RLEFT|RESCC,
 		"	Ob AR,AL\n", },
 
-/* m/r |= const */
-#ifdef notdef	/* amd64 lacks immediate 64-bit simple ops */
+/* m/r |= const, sign-extended 32-bit immediate */
 { OPSIMP,	INAREG|FOREFF|FORCC,
 	SAREG|SNAME|SOREG,	TLL|TPOINT,
-	SCON,	TANY,
+	SCON32,	TANY,
 		0,	RLEFT|RESCC,
 		"	Oq AR,AL\n", },
-#endif
 
 { OPSIMP,	INAREG|FOREFF|FORCC,
 	SAREG|SNAME|SOREG,	TWORD,
@@ -1209,6 +1207,49 @@ struct optab table[] = {
 		NAREG|NSPECIAL,	RESC1,
 		"	xorb %ah,%ah\n	divb AR\n	movb %ah,%al\n", },
 
+/* high half of a multiply, for division by constants */
+{ MULH,	INAREG,
+	SAREG,			TLONG,
+	SAREG|SNAME|SOREG,	TLONG,
+		NAREG|NSPECIAL,	RESC1,
+		"	imulq AR\n", },
+
+{ MULH,	INAREG,
+	SAREG,			TULONG,
+	SAREG|SNAME|SOREG,	TULONG,
+		NAREG|NSPECIAL,	RESC1,
+		"	mulq AR\n", },
+
+{ MULH,	INAREG,
+	SAREG,			TSWORD,
+	SAREG|SNAME|SOREG,	TSWORD,
+		NAREG|NSPECIAL,	RESC1,
+		"	imull AR\n", },
+
+{ MULH,	INAREG,
+	SAREG,			TUWORD,
+	SAREG|SNAME|SOREG,	TUWORD,
+		NAREG|NSPECIAL,	RESC1,
+		"	mull AR\n", },
+
+{ MUL,	INAREG,
+	SAREG,	TLL|TPOINT,
+	SMULEA,	TANY,
+		NAREG|NASL,	RESC1,
+		"	leaq ZX,A1\n", },
+
+{ MUL,	INAREG,
+	SAREG,	TWORD,
+	SMULEA,	TANY,
+		NAREG|NASL,	RESC1,
+		"	leal ZX,A1\n", },
+
+{ MUL,	INAREG,
+	SAREG,	TLL|TPOINT,
+	SCON32,	TANY,
+		0,	RLEFT,
+		"	imulq AR,AL\n", },
+
 { MUL,	INAREG,
 	SAREG,				TLL|TPOINT,
 	SAREG|SNAME|SOREG,		TLL|TPOINT,
@@ -1566,6 +1607,47 @@ struct optab table[] = {
 		0,	RLEFT,
 		"	notb AL\n", },
 
+/*
+ * Atomic operations.  Left is a pointer to the object.
+ */
+{ XADD,	INAREG|FOREFF,
+	SAREG,	TPOINT,
+	SAREG,	TANYINT,
+		0,	RRIGHT,
+		"	lock xaddZR AR,(AL)\n", },
+
+{ XCHG,	INAREG|FOREFF,
+	SAREG,	TPOINT,
+	SAREG,	TANYINT,
+		0,	RRIGHT,
+		"	xchgZR AR,(AL)\n", },
+
+/* right is CM(old, new), with old in %rax and new in %rcx */
+{ CMPXCHG,	INAREG|FOREFF,
+	SAREG,	TPOINT,
+	SAREG,	TANYINT,
+		NSPECIAL,	RDEST,
+		"	lock cmpxchgZR Zx,(AL)\n", },
+
+{ CM,	INAREG,
+	SAREG,	TANYINT,
+	SAREG,	TANYINT,
+		NSPECIAL,	RLEFT,
+		"", },
+
+{ FENCE,	FOREFF,
+	SZERO,	TANY,
+	SANY,	TANY,
+		0,	0,
+		"	mfence\n", },
+
+/* acquire and release ordering is implicit */
+{ FENCE,	FOREFF,
+	SANY,	TANY,
+	SANY,	TANY,
+		0,	0,
+		"", },
+
 { STARG,	FOREFF,
 	SAREG|SOREG|SNAME|SCON, TANY,
 	SANY,	TSTRUCT,
@@ -1200,6 +1200,63 @@ myoptim(struct interpass *ipp)
 {
 }
 
+/*
+ * Peephole patterns, see mip/peep.c.
+ */
+static int
+peepgpr(char *s)
+{
+	if (*s != 'r' || !isdigit((unsigned char)s[1]))
+		return 0;
+	while (isdigit((unsigned char)*++s))
+		;
+	return *s == 0;
+}
+
+/* @0 and @1, if used, are general registers, not pc */
+static int
+peepregs(char **v)
+{
+	return peepgpr(v[0]) && (v[1] == NULL || peepgpr(v[1]));
+}
+
+/* @0 and @2 are stored to and loaded from the stack slot @1 */
+static int
+peepsl(char **v)
+{
+	return peepgpr(v[0]) && (v[2] == NULL || peepgpr(v[2])) &&
+	    (strncmp(v[1], "fp,", 3) == 0 || strncmp(v[1], "sp,", 3) == 0);
+}
+
+/* @4 may set the flags as a compare of @0 with zero would do for b@3 */
+static int
+peepflags(char **v)
+{
+	if (strcmp(v[4], "add") && strcmp(v[4], "sub") && strcmp(v[4], "and") &&
+	    strcmp(v[4], "orr") && strcmp(v[4], "eor"))
+		return 0;
+	if (strcmp(v[3], "eq") && strcmp(v[3], "ne") &&
+	    strcmp(v[3], "mi") && strcmp(v[3], "pl"))
+		return 0;
+	return peepgpr(v[0]);
+}
+
+struct peep peeptab[] = {
+	{ "branch to next", { "\tb @0", "@0:" }, { "@0:" } },
+	{ "add zero", { "\tadd @0,@0,#0" }, { NULL }, peepregs },
+	{ "add zero", { "\tadd @0,@1,#0" }, { "\tmov @0,@1" }, peepregs },
+	{ "move to self", { "\tmov @0,@0" }, { NULL }, peepregs },
+	{ "move back", { "\tmov @0,@1", "\tmov @1,@0" },
+	    { "\tmov @0,@1" }, peepregs },
+	{ "reload", { "\tstr @0,[@1]", "\tldr @0,[@1]" },
+	    { "\tstr @0,[@1]" }, peepsl },
+	{ "store and load", { "\tstr @0,[@1]", "\tldr @2,[@1]" },
+	    { "\tstr @0,[@1]", "\tmov @2,@0" }, peepsl },
+	{ "compare zero", { "\t@4 @0,@1,@2", "\tcmp @0,#0", "\tb@3 @5" },
+	    { "\t@4s @0,@1,@2", "\tb@3 @5" }, peepflags },
+	{ NULL },
+};
+
 /*
  * Register move: move contents of register 's' to register 'r'.
  */
@@ -213,6 +213,7 @@ typedef long long OFFSZ;
 
 #undef	FIELDOPS		/* no bit-field instructions */
 #define TARGET_ENDIAN TARGET_LE
+#define	PEEPHOLE		/* see peeptab[] */
 
 /* XXX - to die */
 #define FPREG   FP	/* frame pointer */
@@ -43,6 +43,15 @@
 void
 setseg(int seg, char *name)
 {
+#ifdef ELFABI
+	if (name != NULL && seg != NMSEG) { /* section of its own */
+		printf(PRTPREF "\t.section %s,\"%s\",@%s\n", name,
+		    seg == PROG ? "ax" : seg == RDATA ? "a" :
+		    seg == TLSDATA || seg == TLSUDATA ? "awT" : "aw",
+		    seg == UDATA || seg == TLSUDATA ? "nobits" : "progbits");
+		return;
+	}
+#endif
 	switch (seg) {
 	case PROG: name = ".text"; break;
 	case DATA:
@@ -58,7 +67,11 @@ setseg(int seg, char *name)
 	case PICLDATA: name = ".section .data.rel.local,\"aw\",@progbits";break;
 	case PICDATA: name = ".section .data.rel.rw,\"aw\",@progbits"; break;
 	case PICRDATA: name = ".section .data.rel.ro,\"aw\",@progbits"; break;
+#ifdef ELFABI
+	case STRNG: name = ".section .rodata.str1.1,\"aMS\",@progbits,1"; break;
+#else
 	case STRNG:
+#endif
 #ifdef AOUTABI
 	case RDATA: name = ".data"; break;
 #else
@@ -208,7 +221,7 @@ static TWORD *regpregs;
 void
 bfcode(struct symtab **sp, int cnt)
 {
-	extern int argstacksize;
+	extern int argstacksize, argsize;
 #ifdef GCC_COMPAT
 	struct attr *ap;
 #endif
@@ -320,6 +333,7 @@ bfcode(struct symtab **sp, int cnt)
 	 * Now (argbase - ARGINIT) is used space on stack.
 	 * Move (if necessary) the args to something new.
 	 */
+	argsize = (argbase - ARGINIT)/SZCHAR;
 	for (i = 0; i < cnt; i++) {
 		int reg, j;
 
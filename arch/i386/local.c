@@ -146,7 +146,7 @@ import(P1ND *p)
 #endif
 
 int gotnr; /* tempnum for GOT register */
-int argstacksize;
+int argstacksize, argsize;
 
 /*
  * Create a reference for an extern variable.
@@ -881,6 +881,8 @@ andable(P1ND *p)
 int
 cisreg(TWORD t)
 {
+	if (ISXMM(t))
+		return 1;
 	if (t == FLOAT || t == DOUBLE || t == LDOUBLE)
 		return 0; /* not yet */
 	return 1;
@@ -1047,6 +1049,13 @@ defzero(struct symtab *sp)
 	if (attr_find(sp->sap, GCC_ATYP_WEAKREF) != NULL)
 		return;
 #endif
+	if (sp->sclass == STATIC && datasects) {
+		/* in a .bss section of its own */
+		locctr(UDATA, sp);
+		defloc(sp);
+		printf(PRTPREF "\t.zero %d\n", off);
+		return;
+	}
 	if (sp->sclass == STATIC) {
 		if (sp->slevel == 0) {
 			printf(PRTPREF "\t.local %s\n", name);
@@ -1280,12 +1289,21 @@ pass1_lastchance(struct interpass *ip)
 	if (ip->type == IP_EPILOG) {
 		struct interpass_prolog *ipp = (struct interpass_prolog *)ip;
 		ipp->ipp_argstacksize = argstacksize;
+		ipp->ipp_argsize = argsize;
 	}
 }
 
 #ifdef PASS1
+int msettings = MI686;
+
+/*
+ * Pass1 part of the target-dependent command-line options,
+ * see also mflags() in local2.c.
+ */
 void
 mflags(char *s)
 {
+	if (strcmp(s, "sse2") == 0)
+		msettings |= MSSE2;
 }
 #endif
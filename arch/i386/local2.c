@@ -43,11 +43,34 @@ static int flabwrtn, loadlab;
 void
 deflab(int label)
 {
-	printf(LABFMT ":\n", label);
+	outlab(label);
+	outstr(":\n");
 }
 
 static int regoff[7];
 static TWORD ftype;
+static int swlab;	/* early returns jump here, past restregs() */
+
+/*
+ * Return the code to save the permanent registers.
+ */
+static char *
+savregs(void)
+{
+	char *s, *d;
+	int i, n;
+
+	for (i = n = 0; i < MAXREGS; i++)
+		if (TESTBIT(p2env.p_regs, i))
+			n++;
+	s = d = tmpalloc(n * 32 + 1);
+	*d = 0;
+	for (i = 0; i < MAXREGS; i++)
+		if (TESTBIT(p2env.p_regs, i))
+			d += sprintf(d, "\tmovl %s,-%d(%s)\n",
+			    rnames[i], regoff[i], rnames[FPREG]);
+	return s;
+}
 
 /*
  * Print out the prolog assembler.
@@ -56,23 +79,25 @@ static TWORD ftype;
 static void
 prtprolog(struct interpass_prolog *ipp, int addto)
 {
-	int i;
-
 #if 1
 #if defined(MACHOABI)
 	addto += 8;
 #endif
 	if (addto == 0 || addto > 65535) {
-		printf("	pushl %%ebp\n\tmovl %%esp,%%ebp\n");
-		if (addto)
-			printf("	subl $%d,%%esp\n", addto);
-	} else
-		printf("	enter $%d,$0\n", addto);
+		outstr("\tpushl %ebp\n\tmovl %esp,%ebp\n");
+		if (addto) {
+			outstr("\tsubl $");
+			outnum(addto);
+			outstr(",%esp\n");
+		}
+	} else {
+		outstr("\tenter $");
+		outnum(addto);
+		outstr(",$0\n");
+	}
 #endif
-	for (i = 0; i < MAXREGS; i++)
-		if (TESTBIT(p2env.p_regs, i))
-			printf("	movl %s,-%d(%s)\n",
-			    rnames[i], regoff[i], rnames[FPREG]);
+	if (swlab == 0)
+		outstr(savregs());
 }
 
 /*
@@ -115,34 +140,65 @@ prologue(struct interpass_prolog *ipp)
 #if defined(MACHOABI)
 	addto = (addto + 15) & ~15;	/* stack alignment */
 #endif
+	swlab = 0;
+	if (xshrinkwrap)
+		swlab = shrinkwrap(&p2env, savregs());
 	prtprolog(ipp, addto);
 }
 
-void
-eoftn(struct interpass_prolog *ipp)
+/*
+ * Restore the registers saved by the prologue.
+ */
+static void
+restregs(void)
 {
 	int i;
 
+	for (i = 0; i < MAXREGS; i++)
+		if (TESTBIT(p2env.p_regs, i)) {
+			outstr("\tmovl -");
+			outnum(regoff[i]);
+			outchr('(');
+			outreg(FPREG);
+			outstr("),");
+			outreg(i);
+			outchr('\n');
+		}
+}
+
+void
+eoftn(struct interpass_prolog *ipp)
+{
 	if (ipp->ipp_ip.ip_lbl == 0)
 		return; /* no code needs to be generated */
 
-	/* return from function code */
-	for (i = 0; i < MAXREGS; i++)
-		if (TESTBIT(p2env.p_regs, i))
-			printf("	movl -%d(%s),%s\n",
-			    regoff[i], rnames[FPREG], rnames[i]);
-
-	/* struct return needs special treatment */
-	if (ftype == STRTY || ftype == UNIONTY) {
-		printf("	movl 8(%%ebp),%%eax\n");
-		printf("	leave\n");
-		printf("	ret $%d\n", 4 + ipp->ipp_argstacksize);
-	} else {
-		printf("	leave\n");
-		if (ipp->ipp_argstacksize)
-			printf("	ret $%d\n", ipp->ipp_argstacksize);
-		else
-			printf("	ret\n");
+	/* return from function code, unless left by a tail jump */
+	if (p2env.p_tailend == 0 || swlab) {
+		restregs();
+		if (swlab)
+			deflab(swlab);
+
+		/* struct return needs special treatment */
+		if (ftype == STRTY || ftype == UNIONTY) {
+			printf("	movl 8(%%ebp),%%eax\n");
+			printf("	leave\n");
+			printf("	ret $%d\n", 4 + ipp->ipp_argstacksize);
+		} else {
+			/* float and double are returned in %st0 */
+			if (DECREF(ftype) == FLOAT && ISXMM(FLOAT))
+				printf("	subl $4,%%esp\n	movss %%xmm0,(%%esp)\n"
+				    "	flds (%%esp)\n");
+			else if (DECREF(ftype) == DOUBLE && ISXMM(DOUBLE))
+				printf("	subl $8,%%esp\n	movsd %%xmm0,(%%esp)\n"
+				    "	fldl (%%esp)\n");
+			outstr("\tleave\n");
+			if (ipp->ipp_argstacksize) {
+				outstr("\tret $");
+				outnum(ipp->ipp_argstacksize);
+				outchr('\n');
+			} else
+				outstr("\tret\n");
+		}
 	}
 
 #if defined(ELFABI)
@@ -187,7 +243,8 @@ hopcode(int f, int o)
 		comperr("hopcode2: %d", o);
 		str = 0; /* XXX gcc */
 	}
-	printf("%s%c", str, f);
+	outstr(str);
+	outchr(f);
 }
 
 /*
@@ -353,6 +410,40 @@ fcomp(NODE *p)
 
 }
 
+/*
+ * Branch after ucomiss/ucomisd.  Unordered operands set ZF, PF and CF.
+ */
+static void
+ucomjmp(NODE *p)
+{
+	int failjump = attr_find(p->n_ap, ATTR_FP_SWAPPED) != 0;
+
+	switch (p->n_op) {
+	case EQ:
+		expand(p, 0, "\tjp 1f\n\tje LC\n1:\n");
+		break;
+	case NE:
+		expand(p, 0, "\tjp LC\n\tjne LC\n");
+		break;
+	case LT:
+	case LE:
+		if (failjump == 0)
+			expand(p, 0, "\tjp 1f\n");
+		expand(p, 0, p->n_op == LT ? "\tjb LC\n" : "\tjbe LC\n");
+		if (failjump == 0)
+			expand(p, 0, "1:\n");
+		break;
+	case GT:
+	case GE:
+		if (failjump)
+			expand(p, 0, "\tjp LC\n");
+		expand(p, 0, p->n_op == GT ? "\tja LC\n" : "\tjae LC\n");
+		break;
+	default:
+		comperr("ucomjmp: %s", opst[p->n_op]);
+	}
+}
+
 /*
  * Convert an unsigned long long to floating point number.
  */
@@ -453,6 +544,8 @@ zzzcode(NODE *p, int c)
 		if (attr_find(p->n_left->n_ap, GCC_ATYP_STDCALL))
 			break;
 #endif
+		if (attr_find(p->n_ap, ATTR_TAILCALL))
+			break;
 		pr = p->n_qual;
 		if (attr_find(p->n_ap, ATTR_I386_FPPOP))
 			printf("	fstp	%%st(0)\n");
@@ -477,6 +570,13 @@ zzzcode(NODE *p, int c)
 		twollcomp(p);
 		break;
 
+	case 'E': /* move float return value from %st0 to xmm register */
+		if (attr_find(p->n_ap, ATTR_TAILCALL))
+			break;
+		expand(p, INEREG, "\tsubl $8,%esp\n\tfstpZl (%esp)\n"
+		    "\tmovsZf (%esp),A1\n\taddl $8,%esp\n");
+		break;
+
 	case 'F': /* Structure argument */
 		starg(p);
 		break;
@@ -519,7 +619,7 @@ zzzcode(NODE *p, int c)
 #endif
 
 	case 'N': /* output extended reg name */
-		printf("%s", rnames[getlr(p, '1')->n_rval]);
+		outreg(getlr(p, '1')->n_rval);
 		break;
 
 	case 'O': /* print out emulated ops */
@@ -645,11 +745,53 @@ zzzcode(NODE *p, int c)
 		case EDX: ch = "%dl"; break;
 		default: ch = "ERROR"; break;
 		}
-		printf("%s", ch);
+		outstr(ch);
 		break;
 
 	case 'U': /* print a/h for right shift */
-		printf("%c", ISUNSIGNED(p->n_type) ? 'h' : 'a');
+		outchr(ISUNSIGNED(p->n_type) ? 'h' : 'a');
+		break;
+
+	case 'V': /* branch after xmm compare */
+		ucomjmp(p);
+		break;
+
+	case 'W': /* call, or leave and jump if a tail call */
+		if (attr_find(p->n_ap, ATTR_TAILCALL) == NULL) {
+			outstr("\tcall");
+			break;
+		}
+		/* move the arguments up over those of this function */
+		for (pr = 0; pr < (int)p->n_qual; pr += SZINT/SZCHAR)
+			printf("\tpushl %d(%%esp)\n\tpopl %d(%%ebp)\n",
+			    pr, pr + ARGINIT/SZCHAR);
+		restregs();
+		outstr("\tleave\n\tjmp");
+		break;
+
+	case 'X': /* lea address for multiply by 3, 5 or 9 */
+		l = getlr(p, 'L');
+		outchr('(');
+		outreg(l->n_rval);
+		outchr(',');
+		outreg(l->n_rval);
+		outchr(',');
+		outnum(getlval(p->n_right) - 1);
+		outchr(')');
+		break;
+
+	case 'g':
+		p = p->n_left;
+		/* FALLTHROUGH */
+	case 'f': /* sse suffix for float or double */
+		outchr(p->n_type == FLOAT ? 's' : 'd');
+		break;
+
+	case 'm':
+		p = p->n_left;
+		/* FALLTHROUGH */
+	case 'l': /* x87 suffix for float or double */
+		outchr(p->n_type == FLOAT ? 's' : 'l');
 		break;
 
 	default:
@@ -718,7 +860,8 @@ shtemp(NODE *p)
 void
 adrcon(CONSZ val)
 {
-	printf("$" CONFMT, val);
+	outchr('$');
+	outnum(val);
 }
 
 void
@@ -729,11 +872,13 @@ conput(FILE *fp, NODE *p)
 	switch (p->n_op) {
 	case ICON:
 		if (p->n_name[0] != '\0') {
-			fprintf(fp, "%s", p->n_name);
-			if (val)
-				fprintf(fp, "+%d", val);
+			fputstr(p->n_name, fp);
+			if (val) {
+				fputchr('+', fp);
+				fputnum(val, fp);
+			}
 		} else
-			fprintf(fp, "%d", val);
+			fputnum(val, fp);
 		return;
 
 	default:
@@ -786,24 +931,37 @@ adrput(FILE *io, NODE *p)
 
 	case NAME:
 		if (p->n_name[0] != '\0') {
-			fputs(p->n_name, io);
-			if (getlval(p) != 0)
-				fprintf(io, "+" CONFMT, getlval(p));
+			fputstr(p->n_name, io);
+			if (getlval(p) != 0) {
+				fputchr('+', io);
+				fputnum(getlval(p), io);
+			}
 		} else
-			fprintf(io, CONFMT, getlval(p));
+			fputnum(getlval(p), io);
 		return;
 
 	case OREG:
 		r = p->n_rval;
-		if (p->n_name[0])
-			printf("%s%s", p->n_name, getlval(p) ? "+" : "");
+		if (p->n_name[0]) {
+			fputstr(p->n_name, io);
+			if (getlval(p))
+				fputchr('+', io);
+		}
 		if (getlval(p))
-			fprintf(io, "%d", (int)getlval(p));
+			fputnum((int)getlval(p), io);
+		fputchr('(', io);
 		if (R2TEST(r)) {
-			fprintf(io, "(%s,%s,4)", rnames[R2UPK1(r)],
-			    rnames[R2UPK2(r)]);
+			int r1 = R2UPK1(r);
+
+			if (r1 != MAXREGS)
+				fputstr(rnames[r1], io);
+			fputchr(',', io);
+			fputstr(rnames[R2UPK2(r)], io);
+			fputchr(',', io);
+			fputnum(R2UPK3(r), io);
 		} else
-			fprintf(io, "(%s)", rnames[p->n_rval]);
+			fputstr(rnames[p->n_rval], io);
+		fputchr(')', io);
 		return;
 	case ICON:
 #ifdef PCC_DEBUG
@@ -819,7 +977,7 @@ adrput(FILE *io, NODE *p)
 		}
 #endif
 		/* addressable value of the constant */
-		fputc('$', io);
+		fputchr('$', io);
 		conput(io, p);
 		return;
 
@@ -835,7 +993,7 @@ adrput(FILE *io, NODE *p)
 			fprintf(io, "%%%s", &rnames[p->n_rval][2]);
 			break;
 		default:
-			fprintf(io, "%s", rnames[p->n_rval]);
+			fputstr(rnames[p->n_rval], io);
 		}
 		return;
 
@@ -867,7 +1025,11 @@ cbgen(int o, int lab)
 {
 	if (o < EQ || o > UGT)
 		comperr("bad conditional branch: %s", opst[o]);
-	printf("	%s " LABFMT "\n", ccbranches[o-EQ], lab);
+	outchr('\t');
+	outstr(ccbranches[o-EQ]);
+	outchr(' ');
+	outlab(lab);
+	outchr('\n');
 }
 
 static void
@@ -911,8 +1073,8 @@ storefloat(struct interpass *ip, NODE *p)
 			return 0; /* arguments, don't care */
 		if (callop(p->n_op))
 			return 1; /* found one */
-#define ISF(p) ((p)->n_type == FLOAT || (p)->n_type == DOUBLE || \
-	(p)->n_type == LDOUBLE)
+#define ISF(p) (((p)->n_type == FLOAT || (p)->n_type == DOUBLE || \
+	(p)->n_type == LDOUBLE) && !ISXMM((p)->n_type))
 		if (ISF(p->n_left) && ISF(p->n_right) && l && r) {
 			/* must store one. store left */
 			struct interpass *nip;
@@ -1075,6 +1237,38 @@ updatereg(NODE *p, void *arg)
 	q->n_right = mklnode(ICON, stkpos, 0, INT);
 }
 
+/*
+ * Split multiplies by 3, 5 or 9 shifted left by 1-3 into a lea
+ * and a shift.  The lea itself is matched in the table.
+ */
+static void
+mulea(NODE *p, void *arg)
+{
+	CONSZ c;
+	int s;
+
+	if (p->n_op != MUL || p->n_right->n_op != ICON ||
+	    p->n_right->n_name[0] != '\0')
+		return;
+	switch (p->n_type) {
+	case INT: case UNSIGNED: case LONG: case ULONG:
+		break;
+	default:
+		return;
+	}
+	c = getlval(p->n_right);
+	for (s = 1; s <= 3 && (c & ((1 << s) - 1)) == 0; s++) {
+		if ((c >> s) == 3 || (c >> s) == 5 || (c >> s) == 9) {
+			setlval(p->n_right, c >> s);
+			p->n_left = mkbinode(MUL, p->n_left, p->n_right,
+			    p->n_type);
+			p->n_right = mklnode(ICON, s, 0, INT);
+			p->n_op = LS;
+			return;
+		}
+	}
+}
+
 void
 myreader(struct interpass *ipole)
 {
@@ -1085,6 +1279,7 @@ myreader(struct interpass *ipole)
 		if (ip->type != IP_NODE)
 			continue;
 		walkf(ip->ip_node, fixcalls, 0);
+		walkf(ip->ip_node, mulea, 0);
 		storefloat(ip, ip->ip_node);
 		if (ip->ip_node->n_op == XASM)
 			fixxfloat(ip, ip->ip_node);
@@ -1141,11 +1336,88 @@ myoptim(struct interpass *ip)
 {
 }
 
+/*
+ * Peephole patterns, see mip/peep.c.
+ */
+static int
+peepis(char *s, char *set)
+{
+	return s[0] != 0 && s[1] == 0 && strchr(set, s[0]) != NULL;
+}
+
+/* @2 is a suffix of an operation that keeps the rest of the register */
+static int
+peepsz(char **v)
+{
+	return peepis(v[2], "bwl");
+}
+
+/* @2 is an integer size suffix */
+static int
+peepszany(char **v)
+{
+	return peepis(v[2], "bwl");
+}
+
+/*
+ * @5 sets the flags from its result like a compare with zero, as far
+ * as the jump or set condition @3 looks at them.
+ */
+static int
+peepflags(char **v)
+{
+	static char *ops[] = { "add", "sub", "and", "or", "xor", NULL };
+	static char *cc[] = { "e", "ne", "z", "nz", "s", "ns", NULL };
+	int i, n;
+
+	for (i = 0; ops[i]; i++) {
+		n = strlen(ops[i]);
+		if (strncmp(v[5], ops[i], n) == 0 && strcmp(v[5] + n, v[2]) == 0)
+			break;
+	}
+	if (ops[i] == NULL)
+		return 0;
+	for (i = 0; cc[i]; i++)
+		if (strcmp(v[3], cc[i]) == 0)
+			return 1;
+	return 0;
+}
+
+struct peep peeptab[] = {
+	{ "jump to next", { "\tjmp @0", "@0:" }, { "@0:" } },
+	{ "add zero", { "\tadd@2 $0,@0" }, { NULL }, peepsz },
+	{ "sub zero", { "\tsub@2 $0,@0" }, { NULL }, peepsz },
+	{ "move to self", { "\tmovl %@0,%@0" }, { NULL } },
+	{ "move back", { "\tmov@2 %@0,%@1", "\tmov@2 %@1,%@0" },
+	    { "\tmov@2 %@0,%@1" }, peepsz },
+	{ "reload", { "\tmov@2 %@0,@1(%ebp)", "\tmov@2 @1(%ebp),%@0" },
+	    { "\tmov@2 %@0,@1(%ebp)" }, peepsz },
+	{ "store and load", { "\tmov@2 %@0,@1(%ebp)", "\tmov@2 @1(%ebp),%@3" },
+	    { "\tmov@2 %@0,@1(%ebp)", "\tmov@2 %@0,%@3" }, peepszany },
+	{ "compare zero", { "\t@5 @0,%@1", "\tcmp@2 $0,%@1", "\tj@3 @4" },
+	    { "\t@5 @0,%@1", "\tj@3 @4" }, peepflags },
+	{ "compare zero", { "\t@5 @0,%@1", "\tcmp@2 $0,%@1", "\tset@3 @4" },
+	    { "\t@5 @0,%@1", "\tset@3 @4" }, peepflags },
+	{ NULL },
+};
+
 static char rl[] =
   { EAX, EAX, EAX, EAX, EAX, EDX, EDX, EDX, EDX, ECX, ECX, ECX, EBX, EBX, ESI };
 static char rh[] =
   { EDX, ECX, EBX, ESI, EDI, ECX, EBX, ESI, EDI, EBX, ESI, EDI, ESI, EDI, EDI };
 
+static void
+regmove(char *op, int s, int d)
+{
+	outchr('\t');
+	outstr(op);
+	outchr(' ');
+	outreg(s);
+	outchr(',');
+	outreg(d);
+	outchr('\n');
+}
+
 void
 rmove(int s, int d, TWORD t)
 {
@@ -1174,9 +1446,9 @@ rmove(int s, int d, TWORD t)
 			SW(dl, dh);
 		}
 		if (sl != dl)
-			printf("	movl %s,%s\n", rnames[sl], rnames[dl]);
+			regmove("movl", sl, dl);
 		if (sh != dh)
-			printf("	movl %s,%s\n", rnames[sh], rnames[dh]);
+			regmove("movl", sh, dh);
 #else
 		if (memcmp(rnames[s], rnames[d], 3) != 0)
 			printf("	movl %%%c%c%c,%%%c%c%c\n",
@@ -1191,12 +1463,17 @@ rmove(int s, int d, TWORD t)
 #ifndef NOBREGS
 	case CHAR:
 	case UCHAR:
-		printf("	movb %s,%s\n", rnames[s], rnames[d]);
+		regmove("movb", s, d);
 		break;
 #endif
 
 	case FLOAT:
 	case DOUBLE:
+		if (ISXMM(t)) {
+			regmove("movaps", s, d);
+			break;
+		}
+		/* FALLTHROUGH */
 	case LDOUBLE:
 #ifdef notdef
 		/* a=b()*c(); will generate this */
@@ -1204,7 +1481,7 @@ rmove(int s, int d, TWORD t)
 #endif
 		break;
 	default:
-		printf("	movl %s,%s\n", rnames[s], rnames[d]);
+		regmove("movl", s, d);
 	}
 }
 
@@ -1237,6 +1514,8 @@ COLORMAP(int c, int *r)
 		return num < 5;
 	case CLASSD:
 		return r[CLASSD] < DREGCNT;
+	case CLASSE:
+		return r[CLASSE] < 8;
 	}
 	return 0; /* XXX gcc */
 }
@@ -1248,6 +1527,8 @@ char *rnames[] = {
 	"edxebx", "edxesi", "edxedi", "ecxebx", "ecxesi", "ecxedi",
 	"ebxesi", "ebxedi", "esiedi",
 	"%st0", "%st1", "%st2", "%st3", "%st4", "%st5", "%st6", "%st7",
+	"%xmm0", "%xmm1", "%xmm2", "%xmm3",
+	"%xmm4", "%xmm5", "%xmm6", "%xmm7",
 };
 
 /*
@@ -1262,6 +1543,8 @@ gclass(TWORD t)
 #endif
 	if (t == LONGLONG || t == ULONGLONG)
 		return CLASSC;
+	if (ISXMM(t))
+		return CLASSE;
 	if (t == FLOAT || t == DOUBLE || t == LDOUBLE)
 		return CLASSD;
 	return CLASSA;
@@ -1270,15 +1553,14 @@ gclass(TWORD t)
 /*
  * Calculate argument sizes.
  */
-void
-lastcall(NODE *p)
+static int
+stackargs(NODE *p)
 {
 	NODE *op = p;
 	int nr = 0, size = 0;
 
-	p->n_qual = 0;
 	if (p->n_op != CALL && p->n_op != FORTCALL && p->n_op != STCALL)
-		return;
+		return 0;
 	for (p = p->n_right; p->n_op == CM; p = p->n_left) { 
 		if (p->n_right->n_op != ASSIGN)
 			size += argsiz(p->n_right);
@@ -1295,6 +1577,13 @@ lastcall(NODE *p)
 		if (nr == 0)
 			size -= 4; /* XXX OpenBSD? */
 	}
+	return size;
+}
+
+void
+lastcall(NODE *p)
+{
+	int size = stackargs(p);
 
 #if defined(MACHOABI)
 	int newsize = (size + 15) & ~15;	/* stack alignment */
@@ -1306,7 +1595,83 @@ lastcall(NODE *p)
 	size=newsize;
 #endif
 	
-	op->n_qual = size; /* XXX */
+	p->n_qual = size; /* XXX */
+}
+
+/*
+ * Can the call p in tail position be done with a jump?  The arguments
+ * on the stack are moved over those of this function, so they must
+ * fit there.  Not done if either function pops its own arguments,
+ * or in PIC code where %ebx must point to the GOT when calling.
+ */
+int
+tailcallok(struct interpass_prolog *ipp, NODE *p)
+{
+	NODE *l = p->n_left;
+
+#if defined(MACHOABI)
+	return 0; /* arguments are aligned, see lastcall() */
+#endif
+	if (kflag || stackargs(p) > ipp->ipp_argsize ||
+	    ipp->ipp_argstacksize || attr_find(p->n_ap, ATTR_I386_FPPOP))
+		return 0;
+#ifdef GCC_COMPAT
+	if (attr_find(l->n_ap, GCC_ATYP_STDCALL))
+		return 0;
+#endif
+	if (l->n_op == REG)
+		return regno(l) != FPREG && regno(l) != STKREG &&
+		    !TESTBIT(p2env.p_regs, regno(l));
+	return l->n_op == ICON;
+}
+
+/*
+ * Is register r, or a part of it, in regs?
+ */
+static int
+inregs(int r, bittype *regs)
+{
+	if (r >= EAXEDX && r <= ESIEDI)
+		return inregs(rl[r-EAXEDX], regs) || inregs(rh[r-EAXEDX], regs);
+	if (r >= AL && r <= BH)
+		r = (r - AL) >> 1;
+	return r < MAXREGS && TESTBIT(regs, r);
+}
+
+/*
+ * Does the tree p use any of the registers in regs?  Registers the
+ * instructions need are looked for as well, and only those if leaves
+ * is 0.
+ */
+int
+regsuse(NODE *p, bittype *regs, int leaves)
+{
+	char *w;
+	int i, r;
+
+	if (leaves && p->n_op == REG && inregs(regno(p), regs))
+		return 1;
+	if (leaves && p->n_op == OREG) {
+		r = regno(p);
+		if (R2TEST(r) ? inregs(R2UPK1(r), regs) ||
+		    inregs(R2UPK2(r), regs) : inregs(r, regs))
+			return 1;
+	}
+	if (TBLIDX(p->n_su)) {
+		for (i = 0; i < 4; i++)
+			if (inregs(DECRA(p->n_reg, i), regs))
+				return 1;
+		if ((w = table[TBLIDX(p->n_su)].needs) != NULL)
+			for (; *w; w += NEEDADD(*w))
+				if (*w >= cNL && *w <= cNRES &&
+				    inregs(w[1], regs))
+					return 1;
+	}
+	if (optype(p->n_op) == BITYPE && regsuse(p->n_right, regs, leaves))
+		return 1;
+	if (optype(p->n_op) != LTYPE)
+		return regsuse(p->n_left, regs, leaves);
+	return 0;
 }
 
 /*
@@ -1339,10 +1704,41 @@ special(NODE *p, int shape)
 		     getlval(p) == 0 || (getlval(p) >> 32) != 0)
 			break;
 		return SRDIR;
+	case SMULEA:
+		if (o != ICON || p->n_name[0])
+			break;
+		if (getlval(p) != 3 && getlval(p) != 5 && getlval(p) != 9)
+			break;
+		return SRDIR;
 	}
 	return SRNOPE;
 }
 
+/*
+ * With -msse2 the x87 entries in the table are only used for
+ * long double, so remove float and double from their types.
+ * The xmm entries are selected by acceptable().
+ */
+static void
+x87strip(void)
+{
+	extern int tablesize;
+	struct optab *q;
+	int i;
+
+#define	X87SH(s) (((s) & SPECIAL) == 0 && ((s) & SDREG))
+	for (i = 0; i < tablesize; i++) {
+		q = &table[i];
+		if (q->visit & MSSE2)
+			continue;
+		if ((q->visit & INDREG) || X87SH(q->lshape) ||
+		    X87SH(q->rshape)) {
+			q->ltype &= ~(TFLOAT|TDOUBLE);
+			q->rtype &= ~(TFLOAT|TDOUBLE);
+		}
+	}
+}
+
 /*
  * Target-dependent command-line options.
  */
@@ -1356,6 +1752,10 @@ mflags(char *str)
 	MSET("arch=i486",MI486);
 	MSET("arch=i586",MI586);
 	MSET("arch=i686",MI686);
+	if (strcmp(str, "sse2") == 0 && (msettings & MSSE2) == 0) {
+		msettings |= MSSE2;
+		x87strip();
+	}
 }
 
 /*
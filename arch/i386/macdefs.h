@@ -140,6 +140,10 @@ typedef long long OFFSZ;
 
 #define FINDMOPS	/* i386 has instructions that modifies memory */
 #define	CC_DIV_0	/* division by zero is safe in the compiler */
+#define	BLOBINIT	/* print static data as strings, see init.c */
+#define	TAILCALL	/* see tailcall() */
+#define	PEEPHOLE	/* see peeptab[] */
+#define	SHRINKWRAP	/* see shrinkwrap() */
 
 /* Definitions mostly used in pass2 */
 
@@ -166,6 +170,7 @@ typedef long long OFFSZ;
  *	B - char regs
  *	C - long long regs
  *	D - floating point
+ *	E - float and double in xmm registers, only used with -msse2
  */
 #define	EAX	000	/* Scratch and return register */
 #define	EDX	001	/* Scratch and secondary return register */
@@ -205,7 +210,16 @@ typedef long long OFFSZ;
 
 /* The 8 math registers in class D lacks names */
 
-#define	MAXREGS	047	/* 39 registers */
+#define	XMM0	047
+#define	XMM1	050
+#define	XMM2	051
+#define	XMM3	052
+#define	XMM4	053
+#define	XMM5	054
+#define	XMM6	055
+#define	XMM7	056
+
+#define	MAXREGS	057	/* 47 registers */
 
 #ifdef NOBREGS
 #define	RSTATUS	\
@@ -214,7 +228,9 @@ typedef long long OFFSZ;
 	0, 0, 0, 0, 0, 0, 0, 0,		\
 	SCREG, SCREG, SCREG, SCREG, SCREG, SCREG, SCREG, SCREG, 	\
 	SCREG, SCREG, SCREG, SCREG, SCREG, SCREG, SCREG,		\
-	SDREG, SDREG, SDREG, SDREG,  SDREG, SDREG, SDREG, SDREG,
+	SDREG, SDREG, SDREG, SDREG,  SDREG, SDREG, SDREG, SDREG,	\
+	SEREG|TEMPREG, SEREG|TEMPREG, SEREG|TEMPREG, SEREG|TEMPREG,	\
+	SEREG|TEMPREG, SEREG|TEMPREG, SEREG|TEMPREG, SEREG|TEMPREG,
 #else
 #define	RSTATUS	\
 	SAREG|TEMPREG, SAREG|TEMPREG, SAREG|TEMPREG, SAREG|PERMREG,	\
@@ -222,7 +238,9 @@ typedef long long OFFSZ;
 	SBREG, SBREG, SBREG, SBREG, SBREG, SBREG, SBREG, SBREG,		\
 	SCREG, SCREG, SCREG, SCREG, SCREG, SCREG, SCREG, SCREG, 	\
 	SCREG, SCREG, SCREG, SCREG, SCREG, SCREG, SCREG,		\
-	SDREG, SDREG, SDREG, SDREG,  SDREG, SDREG, SDREG, SDREG,
+	SDREG, SDREG, SDREG, SDREG,  SDREG, SDREG, SDREG, SDREG,	\
+	SEREG|TEMPREG, SEREG|TEMPREG, SEREG|TEMPREG, SEREG|TEMPREG,	\
+	SEREG|TEMPREG, SEREG|TEMPREG, SEREG|TEMPREG, SEREG|TEMPREG,
 #endif
 
 #ifdef NOBREGS
@@ -287,6 +305,16 @@ typedef long long OFFSZ;
 	{ -1 },\
 	{ -1 },\
 	{ -1 },\
+	{ -1 },\
+\
+	/* Neither do the xmm registers */\
+	{ -1 },\
+	{ -1 },\
+	{ -1 },\
+	{ -1 },\
+	{ -1 },\
+	{ -1 },\
+	{ -1 },\
 	{ -1 },
 #else
 #define	ROVERLAP \
@@ -350,37 +378,56 @@ typedef long long OFFSZ;
 	{ -1 },\
 	{ -1 },\
 	{ -1 },\
+	{ -1 },\
+\
+	/* Neither do the xmm registers */\
+	{ -1 },\
+	{ -1 },\
+	{ -1 },\
+	{ -1 },\
+	{ -1 },\
+	{ -1 },\
+	{ -1 },\
 	{ -1 },
 #endif
 
 
+/* float and double are kept in xmm registers with -msse2 */
+#define	ISXMM(t)	(((t) == FLOAT || (t) == DOUBLE) && (msettings & MSSE2))
+
 #ifdef NOBREGS
 /* Return a register class based on the type of the node */
 #define PCLASS(p) ((p->n_type == LONGLONG || p->n_type == ULONGLONG ? SCREG : \
+		  ISXMM(p->n_type) ? SEREG : \
 		  (p->n_type >= FLOAT && p->n_type <= LDOUBLE ? SDREG : SAREG)))
 #else
 /* Return a register class based on the type of the node */
 #define PCLASS(p) (p->n_type <= UCHAR ? SBREG : \
 		  (p->n_type == LONGLONG || p->n_type == ULONGLONG ? SCREG : \
+		  ISXMM(p->n_type) ? SEREG : \
 		  (p->n_type >= FLOAT && p->n_type <= LDOUBLE ? SDREG : SAREG)))
 #endif
 
-#define	NUMCLASS 	4	/* highest number of reg classes used */
+#define	NUMCLASS 	5	/* highest number of reg classes used */
 
 int COLORMAP(int c, int *r);
-#define	GCLASS(x) (x < 8 ? CLASSA : x < 16 ? CLASSB : x < 31 ? CLASSC : CLASSD)
+#define	GCLASS(x) (x < 8 ? CLASSA : x < 16 ? CLASSB : x < 31 ? CLASSC : \
+		   x < 39 ? CLASSD : CLASSE)
 #define DECRA(x,y)	(((x) >> (y*6)) & 63)	/* decode encoded regs */
 #define	ENCRD(x)	(x)		/* Encode dest reg in n_reg */
 #define ENCRA1(x)	((x) << 6)	/* A1 */
 #define ENCRA2(x)	((x) << 12)	/* A2 */
 #define ENCRA(x,y)	((x) << (6+y*6))	/* encode regs in int */
 /* XXX - return char in al? */
+/* with -msse2 the value in %xmm0 is moved to %st0 by eoftn() */
 #ifdef NOBREGS
 #define	RETREG(x)	(x == LONGLONG || x == ULONGLONG ? EAXEDX : \
+			 ISXMM(x) ? XMM0 : \
 			 x == FLOAT || x == DOUBLE || x == LDOUBLE ? 31 : EAX)
 #else
 #define	RETREG(x)	(x == CHAR || x == UCHAR ? AL : \
 			 x == LONGLONG || x == ULONGLONG ? EAXEDX : \
+			 ISXMM(x) ? XMM0 : \
 			 x == FLOAT || x == DOUBLE || x == LDOUBLE ? 31 : EAX)
 #endif
 
@@ -402,6 +449,7 @@ int COLORMAP(int c, int *r);
 #define SMIXOR		(MAXSPECIAL+4)
 #define SMILWXOR	(MAXSPECIAL+5)
 #define SMIHWXOR	(MAXSPECIAL+6)
+#define SMULEA		(MAXSPECIAL+7)	/* 3, 5 or 9, multiply with lea */
 
 /*
  * i386-specific pass1 attributes.
@@ -413,15 +461,22 @@ int COLORMAP(int c, int *r);
  */
 
 #define TARGET_IPP_MEMBERS			\
-	int ipp_argstacksize;
-
-#define	target_members_print_prolog(ipp) printf("%d", ipp->ipp_argstacksize)
-#define	target_members_print_epilog(ipp) printf("%d", ipp->ipp_argstacksize)
-#define target_members_read_prolog(ipp) ipp->ipp_argstacksize = rdint(&p)
-#define target_members_read_epilog(ipp) ipp->ipp_argstacksize = rdint(&p)
+	int ipp_argstacksize;	/* popped by callee */	\
+	int ipp_argsize;	/* args on stack */
+
+#define	target_members_print_prolog(ipp) \
+	(ipint(ipp->ipp_argstacksize), ipint(ipp->ipp_argsize))
+#define	target_members_print_epilog(ipp) \
+	(ipint(ipp->ipp_argstacksize), ipint(ipp->ipp_argsize))
+#define target_members_read_prolog(ipp) \
+	(ipp->ipp_argstacksize = rdint(&p), ipp->ipp_argsize = rdint(&p))
+#define target_members_read_epilog(ipp) \
+	(ipp->ipp_argstacksize = rdint(&p), ipp->ipp_argsize = rdint(&p))
 
 #define	HAVE_WEAKREF
 #define	TARGET_FLT_EVAL_METHOD	2	/* all as long double */
+#define	TARGET_ATOMICS	(1|2|4)	/* object sizes with atomic insns */
+#define	TARGET_MULH	4	/* object sizes with MULH insns */
 
 /*
  * Extended assembler macros.
@@ -454,6 +509,7 @@ extern int msettings;
 #define	MI586	0x004
 #define	MI686	0x008
 #define	MCPUMSK	0x00f
+#define	MSSE2	0x100	/* float/double in xmm, also marks table entries */
 
 /* target specific attributes */
 #define	ATTR_MI_TARGET	ATTR_I386_FCMPLRET, ATTR_I386_FPPOP
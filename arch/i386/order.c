@@ -42,14 +42,62 @@ notoff(TWORD t, int r, CONSZ off, char *cp)
 	return(0);  /* YES */
 }
 
+/*
+ * Check if LS and try to make it indexable.
+ * If check is 2 only test, otherwise generate the index.
+ * Return 0 if failed.
+ */
+static int
+findls(NODE *p, int check)
+{
+	CONSZ c;
+
+	if (p->n_op != LS || p->n_right->n_op != ICON)
+		return 0;
+	if ((c = getlval(p->n_right)) != 1 && c != 2 && c != 3)
+		return 0;
+	if (check == 1 && p->n_left->n_op != REG)
+		return 0;
+	if (check == 2)
+		return 1;
+	if (!isreg(p->n_left))
+		(void)geninsn(p->n_left, INAREG);
+	return 1;
+}
+
+/*
+ * Setup base + index of an address; the index is put to the right.
+ */
+static void
+baseidx(NODE *p)
+{
+	NODE *q;
+
+	if (findls(p->n_left, 2) && !findls(p->n_right, 2)) {
+		q = p->n_left;
+		p->n_left = p->n_right;
+		p->n_right = q;
+	}
+	if (!isreg(p->n_left))
+		(void)geninsn(p->n_left, INAREG);
+	if (isreg(p->n_right))
+		return; /* Matched (%eax,%ebx) */
+	if (findls(p->n_right, 0))
+		return; /* Matched (%eax,%ebx,4) */
+	(void)geninsn(p->n_right, INAREG);
+}
+
 /*
  * Turn a UMUL-referenced node into OREG.
  * Be careful about register classes, this is a place where classes change.
+ *
+ * i386 can address 4(%ebx,%eax,8), where each part may be left out
+ * and the 8 can be 1, 2, 4 or 8.
  */
 void
 offstar(NODE *p, int shape)
 {
-	NODE *r;
+	NODE *l;
 
 	if (x2debug)
 		printf("offstar(%p)\n", p);
@@ -57,46 +105,78 @@ offstar(NODE *p, int shape)
 	if (isreg(p))
 		return; /* Is already OREG */
 
-	r = p->n_right;
-	if( p->n_op == PLUS || p->n_op == MINUS ){
-		if( r->n_op == ICON ){
-			if (isreg(p->n_left) == 0)
-				(void)geninsn(p->n_left, INAREG);
-			/* Converted in ormake() */
-			return;
-		}
-		if (r->n_op == LS && r->n_right->n_op == ICON &&
-		    getlval(r->n_right) == 2 && p->n_op == PLUS) {
-			if (isreg(p->n_left) == 0)
-				(void)geninsn(p->n_left, INAREG);
-			if (isreg(r->n_left) == 0)
-				(void)geninsn(r->n_left, INAREG);
-			return;
+	if (findls(p, 0))
+		return; /* Matched (,%eax,8) */
+
+	if (p->n_op == PLUS && p->n_right->n_op == ICON) {
+		l = p->n_left;
+		if (isreg(l))
+			return; /* Matched 4(%eax) */
+		if (findls(l, 0))
+			return; /* Matched 4(,%eax,8) */
+		if (l->n_op == PLUS) {
+			baseidx(l);
+			return; /* Matched 4(%ebx,%eax,8) */
 		}
+		(void)geninsn(l, INAREG);
+		return; /* Generate 4(%ebx) */
+	}
+	if (p->n_op == MINUS && p->n_right->n_op == ICON) {
+		if (isreg(p->n_left) == 0)
+			(void)geninsn(p->n_left, INAREG);
+		/* Converted in ormake() */
+		return;
+	}
+
+	if (p->n_op == PLUS) {
+		baseidx(p);
+		return; /* Matched (%ebx,%eax,4) */
 	}
 	(void)geninsn(p, INAREG);
 }
 
 /*
  * Do the actual conversion of offstar-found OREGs into real OREGs.
+ * For simple OREGs conversion should already be done.
  */
 void
 myormake(NODE *q)
 {
+	static int shtbl[] = { 1,2,4,8 };
 	NODE *p, *r;
+	CONSZ c = 0;
+	int r1, r2, sh;
+	char *n = "";
 
 	if (x2debug)
 		printf("myormake(%p)\n", q);
 
-	p = q->n_left;
-	if (p->n_op == PLUS && (r = p->n_right)->n_op == LS &&
-	    r->n_right->n_op == ICON && getlval(r->n_right) == 2 &&
-	    p->n_left->n_op == REG && r->n_left->n_op == REG) {
-		q->n_op = OREG;
-		setlval(q, 0);
-		q->n_rval = R2PACK(p->n_left->n_rval, r->n_left->n_rval, 0);
-		tfree(p);
+	r1 = r2 = MAXREGS;
+	sh = 1;
+	r = p = q->n_left;
+
+	if (p->n_op == PLUS && p->n_right->n_op == ICON) {
+		c = getlval(p->n_right);
+		n = p->n_right->n_name;
+		p = p->n_left;
 	}
+	if (p->n_op == PLUS && p->n_left->n_op == REG) {
+		r1 = regno(p->n_left);
+		p = p->n_right;
+	}
+	if (findls(p, 1)) {
+		sh = shtbl[(int)getlval(p->n_right)];
+		r2 = regno(p->n_left);
+	} else if (p->n_op == REG && r1 != MAXREGS) {
+		r2 = regno(p);
+	} else
+		return;
+
+	q->n_op = OREG;
+	setlval(q, c);
+	q->n_rval = R2PACK(r1, r2, sh);
+	q->n_name = n;
+	tfree(r);
 }
 
 /*
@@ -178,5 +258,7 @@ livecall(NODE *p)
 int
 acceptable(struct optab *op)
 {
+	if (op->visit & MSSE2)
+		return (msettings & MSSE2) != 0;
 	return 1;
 }
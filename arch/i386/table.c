@@ -47,6 +47,8 @@
 #define	 INLL	INCREG
 #define	 SHFL	SDREG	/* shape for float/double */
 #define	 INFL	INDREG	/* shape for float/double */
+#define	 SHXM	SEREG	/* shape for float/double in xmm, -msse2 */
+#define	 INXM	(INEREG|MSSE2)
 
 #define	XSL(c)	NEEDS(NREG(c, 1), NSL(c))
 
@@ -106,6 +108,187 @@ struct optab table[] = {
 		0,	RLEFT,
 		"ZI", },
 
+/*
+ * With -msse2 float and double are kept in xmm registers.
+ * Conversions that have no sse2 instruction go via x87.
+ */
+{ SCONV,	INXM,
+	SHXM,	TFLOAT,
+	SHXM,	TFLOAT,
+		0,	RLEFT,
+		"", },
+
+{ SCONV,	INXM,
+	SHXM,	TDOUBLE,
+	SHXM,	TDOUBLE,
+		0,	RLEFT,
+		"", },
+
+/* convert float to double */
+{ SCONV,	INXM,
+	SHXM|SOREG|SNAME,	TFLOAT,
+	SHXM,			TDOUBLE,
+		NEEDS(NREG(E, 1), NSL(E)),	RESC1,
+		"	cvtss2sd AL,A1\n", },
+
+/* convert double to float */
+{ SCONV,	INXM,
+	SHXM|SOREG|SNAME,	TDOUBLE,
+	SHXM,			TFLOAT,
+		NEEDS(NREG(E, 1), NSL(E)),	RESC1,
+		"	cvtsd2ss AL,A1\n", },
+
+/* convert float/double (in memory) to long double */
+{ SCONV,	INFL|MSSE2,
+	SOREG|SNAME,	TFLOAT|TDOUBLE,
+	SHFL,		TLDOUBLE,
+		NEEDS(NREG(D, 1)),	RESC1,
+		"	fldZm AL\n", },
+
+/* convert float/double (in register) to long double */
+{ SCONV,	INFL|MSSE2,
+	SHXM,	TFLOAT|TDOUBLE,
+	SHFL,	TLDOUBLE,
+		NEEDS(NREG(D, 1), NTEMP(2)),	RESC1,
+		"	movsZg AL,A2\n	fldZm A2\n", },
+
+/* convert long double to float/double */
+{ SCONV,	INXM,
+	SHFL,	TLDOUBLE,
+	SHXM,	TFLOAT|TDOUBLE,
+		NEEDS(NREG(E, 1), NTEMP(2)),	RESC1,
+		"	fstpZl A2\n	movsZf A2,A1\n", },
+
+/* convert int to float/double */
+{ SCONV,	INXM,
+	SAREG|SOREG|SNAME,	TSWORD,
+	SHXM,			TFLOAT|TDOUBLE,
+		NEEDS(NREG(E, 1)),	RESC1,
+		"	cvtsi2sZfl AL,A1\n", },
+
+/* convert (u)short to float/double */
+{ SCONV,	INXM,
+	SAREG|SOREG|SNAME,	TSHORT,
+	SHXM,			TFLOAT|TDOUBLE,
+		NEEDS(NREG(A, 1), NREG(E, 1)),	RESC2,
+		"	movswl AL,A1\n	cvtsi2sZfl A1,A2\n", },
+
+{ SCONV,	INXM,
+	SAREG|SOREG|SNAME,	TUSHORT,
+	SHXM,			TFLOAT|TDOUBLE,
+		NEEDS(NREG(A, 1), NREG(E, 1)),	RESC2,
+		"	movzwl AL,A1\n	cvtsi2sZfl A1,A2\n", },
+
+/* convert (u)char to float/double */
+#ifdef NOBREGS
+{ SCONV,	INXM,
+	SAREG,	TCHAR|TUCHAR,
+	SHXM,	TFLOAT|TDOUBLE,
+		NEEDS(NREG(E, 1)),	RESC1,
+		"	cvtsi2sZfl AL,A1\n", },
+#else
+{ SCONV,	INXM,
+	SHCH|SOREG|SNAME,	TCHAR,
+	SHXM,			TFLOAT|TDOUBLE,
+		NEEDS(NREG(A, 1), NREG(E, 1)),	RESC2,
+		"	movsbl AL,A1\n	cvtsi2sZfl A1,A2\n", },
+
+{ SCONV,	INXM,
+	SHCH|SOREG|SNAME,	TUCHAR,
+	SHXM,			TFLOAT|TDOUBLE,
+		NEEDS(NREG(A, 1), NREG(E, 1)),	RESC2,
+		"	movzbl AL,A1\n	cvtsi2sZfl A1,A2\n", },
+#endif
+
+/* convert unsigned int to float/double */
+{ SCONV,	INXM,
+	SAREG|SOREG|SNAME,	TUWORD,
+	SHXM,			TFLOAT|TDOUBLE,
+		NEEDS(NREG(E, 1)),	RESC1,
+		"	pushl $0\n	pushl AL\n	fildq (%esp)\n"
+		"	fstpZl (%esp)\n	movsZf (%esp),A1\n"
+		"	addl $8,%esp\n", },
+
+/* convert long long (in memory) to float/double */
+{ SCONV,	INXM,
+	SOREG|SNAME,	TLONGLONG,
+	SHXM,		TFLOAT|TDOUBLE,
+		NEEDS(NREG(E, 1), NTEMP(2)),	RESC1,
+		"	fildq AL\n	fstpZl A2\n	movsZf A2,A1\n", },
+
+/* convert long long (in register) to float/double */
+{ SCONV,	INXM,
+	SHLL,	TLONGLONG,
+	SHXM,	TFLOAT|TDOUBLE,
+		NEEDS(NREG(E, 1)),	RESC1,
+		"	pushl UL\n	pushl AL\n	fildq (%esp)\n"
+		"	fstpZl (%esp)\n	movsZf (%esp),A1\n"
+		"	addl $8,%esp\n", },
+
+/* convert unsigned long long to float/double */
+{ SCONV,	INXM,
+	SHLL,	TULONGLONG,
+	SHXM,	TFLOAT|TDOUBLE,
+		NEEDS(NREG(E, 1), NTEMP(2)),	RESC1,
+		"ZJ	fstpZl A2\n	movsZf A2,A1\n", },
+
+/* convert float/double to int */
+{ SCONV,	INAREG|MSSE2,
+	SHXM|SOREG|SNAME,	TFLOAT|TDOUBLE,
+	SAREG,			TSWORD,
+		NEEDS(NREG(A, 1)),	RESC1,
+		"	cvttsZg2si AL,A1\n", },
+
+/* convert float/double to unsigned int */
+{ SCONV,	INAREG|MSSE2,
+	SHXM,	TFLOAT|TDOUBLE,
+	SAREG,	TUWORD,
+		NEEDS(NREG(A, 1), NTEMP(4)),	RESC1,
+		"	movsZg AL,8+A2\n"
+		"	fldZm 8+A2\n"
+		"	fnstcw A2\n"
+		"	fnstcw 4+A2\n"
+		"	movb $12,1+A2\n"
+		"	fldcw A2\n"
+		"	fistpq 8+A2\n"
+		"	movl 8+A2,A1\n"
+		"	fldcw 4+A2\n", },
+
+/* convert float/double to long long */
+{ SCONV,	INLL|MSSE2,
+	SHXM,	TFLOAT|TDOUBLE,
+	SHLL,	TLONGLONG,
+		NEEDS(NREG(C, 1), NTEMP(4)),	RESC1,
+		"	movsZg AL,8+A2\n"
+		"	fldZm 8+A2\n"
+		"	fnstcw A2\n"
+		"	fnstcw 4+A2\n"
+		"	movb $12,1+A2\n"
+		"	fldcw A2\n"
+		"	fistpq 8+A2\n"
+		"	movl 8+A2,A1\n"
+		"	movl 12+A2,U1\n"
+		"	fldcw 4+A2\n", },
+
+/* convert float/double to unsigned long long */
+{ SCONV,	INLL|MSSE2,
+	SHXM,	TFLOAT|TDOUBLE,
+	SHLL,	TULONGLONG,
+		NEEDS(NREG(C, 1), NTEMP(4)),	RESC1,
+		"	movsZg AL,8+A2\n"
+		"	fldZm 8+A2\n"
+		"	fnstcw A2\n"
+		"	fnstcw 4+A2\n"
+		"	movb $7,1+A2\n"	/* 64-bit, round down  */
+		"	fldcw A2\n"
+		"	movl $0x5f000000, 8+A2\n"	/* (float)(1<<63) */
+		"	fsubs 8+A2\n"	/* keep in range of fistpq */
+		"	fistpq 8+A2\n"
+		"	xorb $0x80,15+A2\n"	/* addq $1>>63 to 8(%esp) */
+		"	movl 8+A2,A1\n"
+		"	movl 12+A2,U1\n"
+		"	fldcw 4+A2\n", },
+
 /* convert pointers to pointers. */
 { SCONV,	ININT,
 	SHINT,	TPOINT,
@@ -603,127 +786,151 @@ struct optab table[] = {
 	SCON,	TANY,
 	SANY,	TANY,
 		0,	0,
-		"	call CL\nZC", },
+		"ZW CL\nZC", },
 
 { CALL,		FOREFF,
 	SCON,	TANY,
 	SANY,	TANY,
 		0,	0,
-		"	call CL\nZC", },
+		"ZW CL\nZC", },
 
 { UCALL,	FOREFF,
 	SCON,	TANY,
 	SAREG,	TWORD|TPOINT,
 		0,	0,
-		"	call CL\nZC", },
+		"ZW CL\nZC", },
 
 { CALL,	INAREG,
 	SCON,	TANY,
 	SAREG,	TSHORT|TUSHORT|TWORD|TPOINT,
 		NEEDS(NREG(A, 1), NSL(A)),	RESC1,	/* should be 0 */
-		"	call CL\nZC", },
+		"ZW CL\nZC", },
 
 { UCALL,	INAREG,
 	SCON,	TANY,
 	SAREG,	TSHORT|TUSHORT|TWORD|TPOINT,
 		NEEDS(NREG(A, 1), NSL(A)),	RESC1,	/* should be 0 */
-		"	call CL\nZC", },
+		"ZW CL\nZC", },
 
 { CALL,	INBREG,
 	SCON,	TANY,
 	SBREG,	TCHAR|TUCHAR,
 		NEEDS(NREG(B, 1)),	RESC1,	/* should be 0 */
-		"	call CL\nZC", },
+		"ZW CL\nZC", },
 
 { UCALL,	INBREG,
 	SCON,	TANY,
 	SBREG,	TCHAR|TUCHAR,
 		NEEDS(NREG(B, 1)),	RESC1,	/* should be 0 */
-		"	call CL\nZC", },
+		"ZW CL\nZC", },
 
 { CALL,		INCREG,
 	SCON,	TANY,
 	SCREG,	TANY,
 		NEEDS(NREG(C, 1), NSL(C)),	RESC1,	/* should be 0 */
-		"	call CL\nZC", },
+		"ZW CL\nZC", },
 
 { UCALL,	INCREG,
 	SCON,	TANY,
 	SCREG,	TANY,
 		NEEDS(NREG(C, 1), NSL(C)),	RESC1,	/* should be 0 */
-		"	call CL\nZC", },
+		"ZW CL\nZC", },
 
 { CALL,	INDREG,
 	SCON,	TANY,
 	SDREG,	TANY,
 		NEEDS(NREG(D, 1), NSL(D)),	RESC1,	/* should be 0 */
-		"	call CL\nZC", },
+		"ZW CL\nZC", },
 
 { UCALL,	INDREG,
 	SCON,	TANY,
 	SDREG,	TANY,
 		NEEDS(NREG(D, 1), NSL(D)),	RESC1,	/* should be 0 */
-		"	call CL\nZC", },
+		"ZW CL\nZC", },
+
+{ CALL,		INXM,
+	SCON,	TANY,
+	SHXM,	TANY,
+		NEEDS(NREG(E, 1)),	RESC1,
+		"ZW CL\nZCZE", },
+
+{ UCALL,	INXM,
+	SCON,	TANY,
+	SHXM,	TANY,
+		NEEDS(NREG(E, 1)),	RESC1,
+		"ZW CL\nZCZE", },
 
 { CALL,		FOREFF,
 	SAREG,	TANY,
 	SANY,	TANY,
 		0,	0,
-		"	call *AL\nZC", },
+		"ZW *AL\nZC", },
 
 { UCALL,	FOREFF,
 	SAREG,	TANY,
 	SANY,	TANY,
 		0,	0,
-		"	call *AL\nZC", },
+		"ZW *AL\nZC", },
 
 { CALL,		INAREG,
 	SAREG,	TANY,
 	SANY,	TANY,
 		XSL(A),	RESC1,	/* should be 0 */
-		"	call *AL\nZC", },
+		"ZW *AL\nZC", },
 
 { UCALL,	INAREG,
 	SAREG,	TANY,
 	SANY,	TANY,
 		XSL(A),	RESC1,	/* should be 0 */
-		"	call *AL\nZC", },
+		"ZW *AL\nZC", },
 
 { CALL,		INBREG,
 	SAREG,	TANY,
 	SANY,	TANY,
 		XSL(B),	RESC1,	/* should be 0 */
-		"	call *AL\nZC", },
+		"ZW *AL\nZC", },
 
 { UCALL,	INBREG,
 	SAREG,	TANY,
 	SANY,	TANY,
 		XSL(B),	RESC1,	/* should be 0 */
-		"	call *AL\nZC", },
+		"ZW *AL\nZC", },
 
 { CALL,		INCREG,
 	SAREG,	TANY,
 	SANY,	TANY,
 		XSL(C),	RESC1,	/* should be 0 */
-		"	call *AL\nZC", },
+		"ZW *AL\nZC", },
 
 { UCALL,	INCREG,
 	SAREG,	TANY,
 	SANY,	TANY,
 		XSL(C),	RESC1,	/* should be 0 */
-		"	call *AL\nZC", },
+		"ZW *AL\nZC", },
 
 { CALL,		INDREG,
 	SAREG,	TANY,
 	SANY,	TANY,
 		XSL(D),	RESC1,	/* should be 0 */
-		"	call *AL\nZC", },
+		"ZW *AL\nZC", },
 
 { UCALL,	INDREG,
 	SAREG,	TANY,
 	SANY,	TANY,
 		XSL(D),	RESC1,	/* should be 0 */
-		"	call *AL\nZC", },
+		"ZW *AL\nZC", },
+
+{ CALL,		INXM,
+	SAREG,	TANY,
+	SANY,	TANY,
+		NEEDS(NREG(E, 1)),	RESC1,
+		"ZW *AL\nZCZE", },
+
+{ UCALL,	INXM,
+	SAREG,	TANY,
+	SANY,	TANY,
+		NEEDS(NREG(E, 1)),	RESC1,
+		"ZW *AL\nZCZE", },
 
 { STCALL,	FOREFF,
 	SCON,	TANY,
@@ -778,6 +985,12 @@ struct optab table[] = {
 		0,	RLEFT,
 		"	faddp\n", },
 
+{ PLUS,		INXM|FOREFF,
+	SHXM,			TFLOAT|TDOUBLE,
+	SHXM|SNAME|SOREG,	TFLOAT|TDOUBLE,
+		0,	RLEFT,
+		"	addsZf AR,AL\n", },
+
 #ifdef NOBREGS
 { PLUS,		INAREG|FOREFF,
 	SAREG|SNAME|SOREG,	TAREG|TPOINT,
@@ -885,6 +1098,12 @@ struct optab table[] = {
 		0,	RLEFT,
 		"	fsubZAp\n", },
 
+{ MINUS,	INXM|FOREFF,
+	SHXM,			TFLOAT|TDOUBLE,
+	SHXM|SNAME|SOREG,	TFLOAT|TDOUBLE,
+		0,	RLEFT,
+		"	subsZf AR,AL\n", },
+
 /* Simple r/m->reg ops */
 /* m/r |= r */
 { OPSIMP,	INAREG|FOREFF|FORCC,
@@ -1453,6 +1672,18 @@ struct optab table[] = {
 		0,	RDEST,
 		"	flds AR\n", },
 
+{ ASSIGN,	INXM|FOREFF,
+	SHXM,			TFLOAT|TDOUBLE,
+	SHXM|SOREG|SNAME,	TFLOAT|TDOUBLE,
+		0,	RDEST,
+		"	movsZf AR,AL\n", },
+
+{ ASSIGN,	INXM|FOREFF,
+	SHXM|SOREG|SNAME,	TFLOAT|TDOUBLE,
+	SHXM,			TFLOAT|TDOUBLE,
+		0,	RDEST,
+		"	movsZf AR,AL\n", },
+
 /* Do not generate memcpy if return from funcall */
 #if 0
 { STASG,	INAREG|FOREFF,
@@ -1529,6 +1760,12 @@ struct optab table[] = {
 		0,	RLEFT,
 		"	fdivZAp\n", },
 
+{ DIV,	INXM,
+	SHXM,			TFLOAT|TDOUBLE,
+	SHXM|SNAME|SOREG,	TFLOAT|TDOUBLE,
+		0,	RLEFT,
+		"	divsZf AR,AL\n", },
+
 /* (u)longlong mod is emulated */
 { MOD,	INCREG,
 	SCREG|SNAME|SOREG|SCON, TLL,
@@ -1574,6 +1811,21 @@ struct optab table[] = {
 		"	xorb %ah,%ah\n	divb AR\n", },
 #endif
 
+/* high half of a multiply, for division by constants */
+{ MULH,	INAREG,
+	SAREG,			TSWORD,
+	SAREG|SNAME|SOREG,	TSWORD,
+		NEEDS(NREG(A,1), NEVER(EAX), NEVER(EDX), NLEFT(EAX),
+		    NRES(EDX), NORIGHT(EAX), NORIGHT(EDX)), RESC1,
+		"	imull AR\n", },
+
+{ MULH,	INAREG,
+	SAREG,			TUWORD,
+	SAREG|SNAME|SOREG,	TUWORD,
+		NEEDS(NREG(A,1), NEVER(EAX), NEVER(EDX), NLEFT(EAX),
+		    NRES(EDX), NORIGHT(EAX), NORIGHT(EDX)), RESC1,
+		"	mull AR\n", },
+
 /* (u)longlong mul is emulated */
 { MUL,	INCREG,
 	SCREG,	TLL,
@@ -1582,6 +1834,12 @@ struct optab table[] = {
 		    NRES(EAXEDX)), RDEST,
 		"ZO", },
 
+{ MUL,	INAREG,
+	SAREG,				TWORD|TPOINT,
+	SMULEA,				TANY,
+		XSL(A),	RESC1,
+		"	leal ZX,A1\n", },
+
 { MUL,	INAREG,
 	SAREG,				TWORD|TPOINT,
 	SAREG|SNAME|SOREG|SCON,		TWORD|TPOINT,
@@ -1621,6 +1879,12 @@ struct optab table[] = {
 		0,	RLEFT,
 		"	fmulp\n", },
 
+{ MUL,	INXM,
+	SHXM,			TFLOAT|TDOUBLE,
+	SHXM|SNAME|SOREG,	TFLOAT|TDOUBLE,
+		0,	RLEFT,
+		"	mulsZf AR,AL\n", },
+
 /*
  * Indirection operators.
  */
@@ -1679,6 +1943,12 @@ struct optab table[] = {
 		XSL(D),	RESC1,
 		"	flds AL\n", },
 
+{ UMUL,	INXM,
+	SANY,	TANY,
+	SOREG,	TFLOAT|TDOUBLE,
+		NEEDS(NREG(E, 1)),	RESC1,
+		"	movsZf AL,A1\n", },
+
 /*
  * Logical/branching operators
  */
@@ -1722,6 +1992,12 @@ struct optab table[] = {
 		NEEDS(NEVER(EAX)), 	RNOP,
 		"ZG", },
 
+{ OPLOG,	FORCC|MSSE2,
+	SHXM,			TFLOAT|TDOUBLE,
+	SHXM|SOREG|SNAME,	TFLOAT|TDOUBLE,
+		0, 	RNOP,
+		"	ucomisZg AR,AL\nZV", },
+
 { OPLOG,	FORCC,
 	SANY,	TANY,
 	SANY,	TANY,
@@ -1896,6 +2172,12 @@ struct optab table[] = {
 		XSL(D),	RESC1,
 		"	flds AL\n", },
 
+{ OPLTYPE,	INXM,
+	SANY,		TFLOAT|TDOUBLE,
+	SHXM|SOREG|SNAME,	TFLOAT|TDOUBLE,
+		NEEDS(NREG(E, 1)),	RESC1,
+		"	movsZf AL,A1\n", },
+
 /* Only used in ?: constructs. The stack already contains correct value */
 { OPLTYPE,	INDREG,
 	SANY,	TFLOAT|TDOUBLE|TLDOUBLE,
@@ -1937,6 +2219,19 @@ struct optab table[] = {
 		0,	RLEFT,
 		"	fchs\n", },
 
+/* flip the sign bit, the mask is made in a register */
+{ UMINUS,	INXM|FOREFF,
+	SHXM,	TFLOAT,
+	SHXM,	TFLOAT,
+		NEEDS(NREG(E, 1)),	RLEFT,
+		"	pcmpeqd A1,A1\n	pslld $31,A1\n	xorps A1,AL\n", },
+
+{ UMINUS,	INXM|FOREFF,
+	SHXM,	TDOUBLE,
+	SHXM,	TDOUBLE,
+		NEEDS(NREG(E, 1)),	RLEFT,
+		"	pcmpeqd A1,A1\n	psllq $63,A1\n	xorpd A1,AL\n", },
+
 { COMPL,	INCREG,
 	SCREG,	TLL,
 	SANY,	TANY,
@@ -2044,6 +2339,103 @@ struct optab table[] = {
 		0,	0,
 		"	subl $12,%esp\n	fstpt (%esp)\n", },
 
+{ FUNARG,	FOREFF|MSSE2,
+	SHXM,	TDOUBLE,
+	SANY,	TDOUBLE,
+		0,	0,
+		"	subl $8,%esp\n	movsd AL,(%esp)\n", },
+
+{ FUNARG,	FOREFF|MSSE2,
+	SHXM,	TFLOAT,
+	SANY,	TFLOAT,
+		0,	0,
+		"	subl $4,%esp\n	movss AL,(%esp)\n", },
+
+/*
+ * Atomic operations.  Left is a pointer to the object.
+ */
+{ XADD,	INAREG|FOREFF,
+	SAREG,	TPOINT,
+	SAREG,	TWORD|TPOINT,
+		0,	RRIGHT,
+		"	lock xaddl AR,(AL)\n", },
+
+{ XADD,	INAREG|FOREFF,
+	SAREG,	TPOINT,
+	SAREG,	TSHORT|TUSHORT,
+		0,	RRIGHT,
+		"	lock xaddw AR,(AL)\n", },
+
+{ XADD,	INCH|FOREFF,
+	SAREG,	TPOINT,
+	SHCH,	TCHAR|TUCHAR,
+		0,	RRIGHT,
+		"	lock xaddb AR,(AL)\n", },
+
+{ XCHG,	INAREG|FOREFF,
+	SAREG,	TPOINT,
+	SAREG,	TWORD|TPOINT,
+		0,	RRIGHT,
+		"	xchgl AR,(AL)\n", },
+
+{ XCHG,	INAREG|FOREFF,
+	SAREG,	TPOINT,
+	SAREG,	TSHORT|TUSHORT,
+		0,	RRIGHT,
+		"	xchgw AR,(AL)\n", },
+
+{ XCHG,	INCH|FOREFF,
+	SAREG,	TPOINT,
+	SHCH,	TCHAR|TUCHAR,
+		0,	RRIGHT,
+		"	xchgb AR,(AL)\n", },
+
+/* right is CM(old, new), with old in %eax and new in %ecx */
+{ CMPXCHG,	INAREG|FOREFF,
+	SAREG,	TPOINT,
+	SAREG,	TWORD|TPOINT,
+		NEEDS(NRIGHT(EAX), NOLEFT(ECX), NRES(EAX)),	RDEST,
+		"	lock cmpxchgl %ecx,(AL)\n", },
+
+{ CMPXCHG,	INAREG|FOREFF,
+	SAREG,	TPOINT,
+	SAREG,	TSHORT|TUSHORT,
+		NEEDS(NRIGHT(EAX), NOLEFT(ECX), NRES(EAX)),	RDEST,
+		"	lock cmpxchgw %cx,(AL)\n", },
+
+{ CMPXCHG,	INCH|FOREFF,
+	SAREG,	TPOINT,
+	SHCH,	TCHAR|TUCHAR,
+		NEEDS(NRIGHT(AL), NOLEFT(EAX), NOLEFT(ECX), NRES(AL)),
+		RDEST,
+		"	lock cmpxchgb %cl,(AL)\n", },
+
+{ CM,	INAREG,
+	SAREG,	TWORD|TPOINT|TSHORT|TUSHORT,
+	SAREG,	TWORD|TPOINT|TSHORT|TUSHORT,
+		NEEDS(NLEFT(EAX), NRIGHT(ECX), NRES(EAX)),	RLEFT,
+		"", },
+
+{ CM,	INCH,
+	SHCH,	TCHAR|TUCHAR,
+	SHCH,	TCHAR|TUCHAR,
+		NEEDS(NLEFT(AL), NRIGHT(CL), NRES(AL)),	RLEFT,
+		"", },
+
+/* mfence needs SSE2 */
+{ FENCE,	FOREFF,
+	SZERO,	TANY,
+	SANY,	TANY,
+		0,	0,
+		"	lock orl $0,(%esp)\n", },
+
+/* acquire and release ordering is implicit */
+{ FENCE,	FOREFF,
+	SANY,	TANY,
+	SANY,	TANY,
+		0,	0,
+		"", },
+
 { STARG,	FOREFF,
 	SAREG,	TPTRTO|TSTRUCT,
 	SANY,	TSTRUCT,
@@ -0,0 +1,464 @@
+/*	$Id$	*/
+
+/*
+ * Branch delay slot filling, done on the assembler output of a
+ * function (see asmrelease()).  The code generator writes a nop after
+ * each branch and load, but the output is assembled in reorder mode
+ * where the assembler inserts the nops needed itself, so the explicit
+ * nops are only wasted space.  They are removed, and each branch that
+ * is safe to handle gets an instruction from the same basic block
+ * before it, or for unconditional jumps the first instruction at the
+ * jump target, put into its delay slot.  Filled branches are emitted in
+ * noreorder mode, so the assembler does not add a nop of its own.
+ * This file is included by local2.c of both mips and mips64.
+ */
+#define	DSMAXSCAN	12	/* how far back to search for a filler */
+
+#define	DSOTHER		0	/* anything not understood, a barrier */
+#define	DSLABEL		1
+#define	DSNOP		2
+#define	DSINSN		3	/* movable single-word instruction */
+#define	DSBRANCH	4	/* branch which may be filled */
+
+struct dsline {
+	short type;
+	short isld, isst;	/* memory load/store */
+	short isjmp;		/* unconditional jump to a label */
+	char *lab;		/* label name, defined or jumped to */
+	unsigned long long rd, wr;	/* registers read/written */
+};
+
+#define	DSRR	1	/* d,s,t or d,s,imm */
+#define	DSRI	2	/* t,s,simm16 */
+#define	DSRU	3	/* t,s,uimm16 */
+#define	DSSH	4	/* d,t,shift */
+#define	DSMV	5	/* d,s */
+#define	DSLI	6	/* t,imm */
+#define	DSLUI	7	/* t,uimm16 */
+#define	DSLD	8	/* t,off(base) */
+#define	DSST	9	/* t,off(base) */
+#define	DSJ	10	/* label */
+#define	DSJR	11	/* s */
+#define	DSBZ	12	/* s,label */
+#define	DSBR	13	/* s,t,label */
+
+static const struct dsop {
+	char *name;
+	int fmt;
+	int imm;	/* accepted immediate operand for DSRR: 1 signed, 2 unsigned */
+} dsops[] = {
+	{ "add", DSRR, 1 }, { "addu", DSRR, 1 }, { "sub", DSRR, 1 },
+	{ "subu", DSRR, 1 }, { "dadd", DSRR, 1 }, { "daddu", DSRR, 1 },
+	{ "dsub", DSRR, 1 }, { "dsubu", DSRR, 1 }, { "slt", DSRR, 1 },
+	{ "sltu", DSRR, 1 }, { "and", DSRR, 2 }, { "or", DSRR, 2 },
+	{ "xor", DSRR, 2 }, { "nor", DSRR, 0 }, { "sllv", DSRR, 0 },
+	{ "srlv", DSRR, 0 }, { "srav", DSRR, 0 }, { "dsllv", DSRR, 0 },
+	{ "dsrlv", DSRR, 0 }, { "dsrav", DSRR, 0 },
+	{ "addi", DSRI }, { "addiu", DSRI }, { "daddi", DSRI },
+	{ "daddiu", DSRI }, { "slti", DSRI }, { "sltiu", DSRI },
+	{ "andi", DSRU }, { "ori", DSRU }, { "xori", DSRU },
+	{ "sll", DSSH }, { "srl", DSSH }, { "sra", DSSH },
+	{ "dsll", DSSH }, { "dsrl", DSSH }, { "dsra", DSSH },
+	{ "dsll32", DSSH }, { "dsrl32", DSSH }, { "dsra32", DSSH },
+	{ "move", DSMV }, { "neg", DSMV }, { "negu", DSMV }, { "not", DSMV },
+	{ "li", DSLI }, { "lui", DSLUI },
+	{ "lb", DSLD }, { "lbu", DSLD }, { "lh", DSLD }, { "lhu", DSLD },
+	{ "lw", DSLD }, { "lwu", DSLD }, { "ld", DSLD },
+	{ "sb", DSST }, { "sh", DSST }, { "sw", DSST }, { "sd", DSST },
+	{ "j", DSJ }, { "b", DSJ }, { "jr", DSJR },
+	{ "beqz", DSBZ }, { "bnez", DSBZ }, { "blez", DSBZ },
+	{ "bgtz", DSBZ }, { "bltz", DSBZ }, { "bgez", DSBZ },
+	{ "beq", DSBR }, { "bne", DSBR },
+	{ NULL },
+};
+
+static const char *dsrnames[] = {
+	"zero", "at", "v0", "v1", "a0", "a1", "a2", "a3",
+	"t0", "t1", "t2", "t3", "t4", "t5", "t6", "t7",
+	"s0", "s1", "s2", "s3", "s4", "s5", "s6", "s7",
+	"t8", "t9", "k0", "k1", "gp", "sp", "fp", "ra",
+};
+
+/*
+ * Return the register mask of a register operand, -1 if not a register.
+ * $zero is never a dependency.
+ */
+static long long
+dsreg(char *s)
+{
+	char *e;
+	long n;
+	int i;
+
+	if (*s++ != '$')
+		return -1;
+	if (isdigit((unsigned char)*s)) {
+		n = strtol(s, &e, 10);
+		if (*e || n > 31)
+			return -1;
+		return n ? 1LL << n : 0;
+	}
+	if (strcmp(s, "s8") == 0)
+		return 1LL << 30;
+	for (i = 0; i < 32; i++)
+		if (strcmp(s, dsrnames[i]) == 0)
+			return i ? 1LL << i : 0;
+	return -1;
+}
+
+/*
+ * Parse a numeric immediate into *v.
+ */
+static int
+dsimm(char *s, long long *v)
+{
+	char *e;
+
+	if (*s == 0)
+		return 0;
+	*v = strtoll(s, &e, 0);
+	return *e == 0;
+}
+
+/*
+ * Parse a memory operand off(base), return the base register mask.
+ * The offset must be a number that fits in 16 bits or a %lo(), or
+ * the assembler expands it to several instructions.
+ */
+static long long
+dsmem(char *s)
+{
+	char *b, *e;
+	long long v;
+
+	if ((b = strrchr(s, '(')) == NULL || (e = strchr(b, ')')) == NULL ||
+	    e[1] != 0)
+		return -1;
+	*e = 0;
+	if (strncmp(s, "%lo(", 4) == 0) {
+		if (b[-1] != ')')
+			return -1;
+	} else if (b > s) {
+		*b = 0;
+		if (!dsimm(s, &v) || v < -32768 || v > 32767)
+			return -1;
+	}
+	return dsreg(b+1);
+}
+
+/*
+ * Classify an assembler line.
+ */
+static void
+dsclass(char *line, struct dsline *d)
+{
+	char buf[256], *s, *t, *op[4];
+	const struct dsop *o;
+	long long r[3], v;
+	int i, c, nop;
+
+	memset(d, 0, sizeof(struct dsline));
+	if (strlen(line) >= sizeof(buf))
+		return;
+	strlcpy(buf, line, sizeof(buf));
+	if ((s = strchr(buf, '#')) != NULL)
+		*s = 0;
+	for (s = buf + strlen(buf); s > buf && isspace((unsigned char)s[-1]); )
+		*--s = 0;
+	if (buf[0] && !isspace((unsigned char)buf[0])) {
+		if (s[-1] != ':' || strchr(buf, ' ') != NULL)
+			return;
+		s[-1] = 0;
+		d->type = DSLABEL;
+		d->lab = tmpstrdup(buf);
+		return;
+	}
+	for (s = buf; isspace((unsigned char)*s); s++)
+		;
+	op[0] = s;
+	while (*s && !isspace((unsigned char)*s))
+		s++;
+	if (*s)
+		*s++ = 0;
+	if (strcmp(op[0], "nop") == 0 && *s == 0) {
+		d->type = DSNOP;
+		return;
+	}
+	for (o = dsops; o->name; o++)
+		if (strcmp(o->name, op[0]) == 0)
+			break;
+	if (o->name == NULL)
+		return;
+
+	/* split operands */
+	for (nop = 0; *s && nop < 3; ) {
+		while (isspace((unsigned char)*s))
+			s++;
+		op[++nop] = s;
+		while (*s && *s != ',')
+			s++;
+		for (t = s; t > op[nop] && isspace((unsigned char)t[-1]); )
+			t--;
+		c = *s;
+		*t = 0;
+		if (c)
+			s++;
+	}
+	if (*s)
+		return;		/* too many operands */
+
+	for (i = 1; i <= nop; i++)
+		r[i-1] = dsreg(op[i]);
+
+	switch (o->fmt) {
+	case DSRR:
+		if (nop != 3 || r[0] < 0 || r[1] < 0)
+			return;
+		if (r[2] < 0) {
+			if (!dsimm(op[3], &v))
+				return;
+			if (o->imm == 1 && (v < -32767 || v > 32767))
+				return;
+			if (o->imm == 2 && (v < 0 || v > 65535))
+				return;
+			if (o->imm == 0)
+				return;
+			r[2] = 0;
+		}
+		d->wr = r[0], d->rd = r[1] | r[2];
+		break;
+	case DSRI:
+	case DSRU:
+	case DSSH:
+		if (nop != 3 || r[0] < 0 || r[1] < 0 || !dsimm(op[3], &v))
+			return;
+		if (o->fmt == DSRI && (v < -32768 || v > 32767))
+			return;
+		if (o->fmt == DSRU && (v < 0 || v > 65535))
+			return;
+		if (o->fmt == DSSH && (v < 0 || v > 31))
+			return;
+		d->wr = r[0], d->rd = r[1];
+		break;
+	case DSMV:
+		if (nop != 2 || r[0] < 0 || r[1] < 0)
+			return;
+		d->wr = r[0], d->rd = r[1];
+		break;
+	case DSLI:
+	case DSLUI:
+		if (nop != 2 || r[0] < 0 || !dsimm(op[2], &v))
+			return;
+		if (v < (o->fmt == DSLI ? -32768 : 0) || v > 65535)
+			return;
+		d->wr = r[0];
+		break;
+	case DSLD:
+	case DSST:
+		if (nop != 2 || r[0] < 0 || (r[1] = dsmem(op[2])) < 0)
+			return;
+		if (o->fmt == DSLD)
+			d->wr = r[0], d->rd = r[1], d->isld = 1;
+		else
+			d->rd = r[0] | r[1], d->isst = 1;
+		break;
+	case DSJ:
+		if (nop != 1 || r[0] >= 0)
+			return;
+		d->lab = tmpstrdup(op[1]);
+		d->isjmp = 1;
+		d->type = DSBRANCH;
+		return;
+	case DSJR:
+		if (nop != 1 || r[0] < 0)
+			return;
+		d->rd = r[0];
+		d->type = DSBRANCH;
+		return;
+	case DSBZ:
+		if (nop != 2 || r[0] < 0 || r[1] >= 0)
+			return;
+		d->rd = r[0];
+		d->type = DSBRANCH;
+		return;
+	case DSBR:
+		if (nop != 3 || r[0] < 0 || r[1] < 0 || r[2] >= 0)
+			return;
+		d->rd = r[0] | r[1];
+		d->type = DSBRANCH;
+		return;
+	}
+	d->type = DSINSN;
+}
+
+/*
+ * Is c safe to move past instructions reading rd, writing wr and
+ * accessing memory?
+ */
+static int
+dsok(struct dsline *c, unsigned long long rd, unsigned long long wr,
+    int ld, int st)
+{
+	if ((c->wr & (rd | wr)) || (c->rd & wr))
+		return 0;
+	if (c->isst && (ld || st))
+		return 0;
+	if (c->isld && (st || mipsisa < 2))
+		return 0;
+	return 1;
+}
+
+/*
+ * Is this line a branch or jump instruction?
+ */
+static int
+dsisbr(char *s)
+{
+	if (!isspace((unsigned char)*s))
+		return 0;
+	while (isspace((unsigned char)*s))
+		s++;
+	return *s == 'j' || (*s == 'b' && strncmp(s, "break", 5) != 0);
+}
+
+/*
+ * Put ins into the delay slot of branch br.
+ */
+static char *
+dsgroup(char *br, char *ins)
+{
+	char *s;
+
+	s = tmpalloc(strlen(br) + strlen(ins) + 64);
+	sprintf(s, "\t.set push\n\t.set noreorder\n\t.set nomacro\n"
+	    "%s\n%s\n\t.set pop", br, ins);
+	return s;
+}
+
+#define	DSHSZ	256
+struct dslab {
+	struct dslab *next;
+	char *name;
+	int idx;
+};
+
+static int
+dshash(char *s)
+{
+	unsigned int h = 0;
+
+	while (*s)
+		h = h * 31 + (unsigned char)*s++;
+	return h % DSHSZ;
+}
+
+void
+myasmopt(char **lines, int n)
+{
+	struct dslab **htab, *h;
+	struct dsline *d;
+	unsigned long long rd, wr;
+	int i, j, k, f, ld, st, reg, *tlab;
+	char *s, *m, w[16];
+
+	d = tmpalloc(n * sizeof(struct dsline));
+	for (i = reg = 0; i < n; i++) {
+		s = lines[i];
+		if (strcmp(s, ASMBEG) == 0)
+			reg++;
+		else if (strcmp(s, ASMEND) == 0)
+			reg--;
+		else if (sscanf(s, " .set %15s", w) == 1) {
+			if (strcmp(w, "noreorder") == 0)
+				reg++;
+			else if (strcmp(w, "reorder") == 0 && reg > 0)
+				reg--;
+		}
+		if (reg)
+			memset(&d[i], 0, sizeof(struct dsline));
+		else
+			dsclass(s, &d[i]);
+	}
+
+	/* remove the nops, on ISA I only those following branches */
+	for (i = 0; i < n; i++) {
+		if (d[i].type != DSNOP)
+			continue;
+		for (j = i - 1; j >= 0 && lines[j] == NULL; j--)
+			;
+		if (mipsisa >= 2 || (j >= 0 && dsisbr(lines[j])))
+			lines[i] = NULL;
+		else
+			d[i].type = DSOTHER;
+	}
+
+	/* fill from the same basic block */
+	for (i = 0; i < n; i++) {
+		if (d[i].type != DSBRANCH)
+			continue;
+		rd = d[i].rd, wr = d[i].wr;
+		ld = st = 0;
+		for (j = i - 1, k = 0, f = -1; j >= 0 && k < DSMAXSCAN; j--) {
+			if (lines[j] == NULL)
+				continue;
+			if (d[j].type != DSINSN)
+				break;
+			if (dsok(&d[j], rd, wr, ld, st)) {
+				f = j;
+				break;
+			}
+			rd |= d[j].rd, wr |= d[j].wr;
+			ld |= d[j].isld, st |= d[j].isst;
+			k++;
+		}
+		if (f < 0)
+			continue;
+		lines[i] = dsgroup(lines[i], lines[f]);
+		lines[f] = NULL;
+		d[i].type = DSOTHER;
+	}
+
+	/* fill unconditional jumps from their target */
+	htab = tmpcalloc(DSHSZ * sizeof(struct dslab *));
+	for (i = 0; i < n; i++) {
+		if (lines[i] == NULL || d[i].type != DSLABEL)
+			continue;
+		h = tmpalloc(sizeof(struct dslab));
+		h->name = d[i].lab;
+		h->idx = i;
+		h->next = htab[dshash(h->name)];
+		htab[dshash(h->name)] = h;
+	}
+	tlab = tmpcalloc(n * sizeof(int));
+	for (i = 0; i < n; i++) {
+		if (d[i].type != DSBRANCH || !d[i].isjmp)
+			continue;
+		for (h = htab[dshash(d[i].lab)]; h; h = h->next)
+			if (strcmp(h->name, d[i].lab) == 0)
+				break;
+		if (h == NULL)
+			continue;
+		for (j = h->idx + 1; j < n; j++)
+			if (lines[j] && d[j].type != DSLABEL)
+				break;
+		if (j == n || d[j].type != DSINSN ||
+		    (d[j].isld && mipsisa < 2))
+			continue;
+		if (tlab[j] == 0)
+			tlab[j] = getlab2();
+		for (m = lines[i]; isspace((unsigned char)*m); m++)
+			;
+		k = strcspn(m, " \t");
+		s = tmpalloc(k + 32);
+		sprintf(s, "\t%.*s " LABFMT, k, m, tlab[j]);
+		lines[i] = dsgroup(s, lines[j]);
+		d[i].type = DSOTHER;
+	}
+	for (j = 0; j < n; j++) {
+		if (tlab[j] == 0)
+			continue;
+		s = tmpalloc(strlen(lines[j]) + 32);
+		sprintf(s, "%s\n" LABFMT ":", lines[j], tlab[j]);
+		lines[j] = s;
+	}
+}
@@ -46,6 +46,7 @@ int bigendian = 0;
 #endif
 
 int nargregs = MIPS_O32_NARGREGS;
+int mipsisa = 1;	/* ISA level, from -mipsN or -march=mipsN */
 
 static int argsiz(NODE *p);
 
@@ -1297,6 +1298,8 @@ special(NODE *p, int shape)
 	return SRNOPE;
 }
 
+#include "delay.c"
+
 /*
  * Target-dependent command-line options.
  */
@@ -1307,17 +1310,18 @@ mflags(char *str)
 		bigendian = 1;
 	} else if (strcasecmp(str, "little-endian") == 0) {
 		bigendian = 0;
+	} else if (strncmp(str, "ips", 3) == 0 && isdigit((unsigned char)str[3])) {
+		mipsisa = atoi(str+3);
+	} else if (strncmp(str, "arch=mips", 9) == 0 &&
+	    isdigit((unsigned char)str[9])) {
+		mipsisa = atoi(str+9);
 	} else {
 		fprintf(stderr, "unknown m option '%s'\n", str);
 		exit(1);
 	}
 
 #if 0
-	 else if (strcasecmp(str, "ips2")) {
-	} else if (strcasecmp(str, "ips2")) {
-	} else if (strcasecmp(str, "ips3")) {
-	} else if (strcasecmp(str, "ips4")) {
-	} else if (strcasecmp(str, "hard-float")) {
+	 else if (strcasecmp(str, "hard-float")) {
 	} else if (strcasecmp(str, "soft-float")) {
 	} else if (strcasecmp(str, "abi=32")) {
 		nargregs = MIPS_O32_NARGREGS;
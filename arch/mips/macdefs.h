@@ -123,6 +123,7 @@ typedef long long OFFSZ;
 #undef	FIELDOPS		/* no bit-field instructions */
 #define TARGET_ENDIAN TARGET_LE
 #define	MYALIGN
+#define	ASMOPT		/* see myasmopt() */
 
 /* Definitions mostly used in pass2 */
 
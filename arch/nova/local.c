@@ -258,25 +258,26 @@ cerror("spalloc");
 void
 instring(struct symtab *sp)
 {
-	unsigned short sh[2];
-	char *s;
+	unsigned short sh[64];
+	unsigned int cp[64];
+	char *s, *e;
 	TWORD t;
 	P1ND *p;
+	int i, n;
 
 	locctr(STRNG, sp);
 	defloc(sp);
 
 	t = BTYPE(sp->stype);
 	s = sp->sname;
+	e = s + strlen(s);
 	if (t == ctype(USHORT)) {
 		/* convert to UTF-16 */
 		p = xbcon(0, NULL, t);
-		while (*s) {
-			cp2u16(u82cp(&s), sh);
-			if ((glval(p) = sh[0]))
-				inval(0, SZSHORT, p);
-			if ((glval(p) = sh[1]))
-				inval(0, SZSHORT, p);
+		while ((n = u82u16(&s, e, sh, 64)) > 0) {
+			for (i = 0; i < n; i++)
+				if ((glval(p) = sh[i]))
+					inval(0, SZSHORT, p);
 		}
 		slval(p, 0);
 		inval(0, SZSHORT, p);
@@ -285,9 +286,11 @@ instring(struct symtab *sp)
 	    t == ctype(SZINT < 32 ? LONG : INT)) {
 		/* convert to UTF-32 */
 		p = xbcon(0, NULL, t);
-		while (*s) {
-			slval(p, u82cp(&s));
-			inval(0, SZINT < 32 ? SZLONG : SZINT, p);
+		while ((n = u82u32(&s, e, cp, 64)) > 0) {
+			for (i = 0; i < n; i++) {
+				slval(p, cp[i]);
+				inval(0, SZINT < 32 ? SZLONG : SZINT, p);
+			}
 		}
 		slval(p, 0);
 		inval(0, SZINT < 32 ? SZLONG : SZINT, p);
@@ -287,20 +287,20 @@ spalloc(NODE *t, NODE *p, OFFSZ off)
 void
 instring(struct symtab *sp)
 {
-	unsigned short sh[2];
-	int val, cnt;
+	unsigned short sh[64];
+	int val, cnt, i, n;
 	TWORD t;
-	char *s;
+	char *s, *e;
 
 	defloc(sp);
 	t = BTYPE(sp->stype);
 	s = sp->sname;
 	if (t == UNSIGNED) {
 		/* convert to UTF-16 */
-		while (*s) {
-			cp2u16(u82cp(&s), sh);
-			if (sh[0]) printf("%o\n", sh[0]);
-			if (sh[1]) printf("%o\n", sh[1]);
+		e = s + strlen(s);
+		while ((n = u82u16(&s, e, sh, 64)) > 0) {
+			for (i = 0; i < n; i++)
+				if (sh[i]) printf("%o\n", sh[i]);
 		}
 		printf("0\n");
 	} else if (t == CHAR) {
@@ -249,8 +249,11 @@ static char **lav;
 static int lac;
 static char *find_file(const char *file, struct strlist *path, int mode);
 static int preprocess_input(char *input, char *output, int dodep);
-static int compile_input(char *input, char *output);
+static int compile_input(char *input, char *output, struct strlist *);
 static int assemble_input(char *input, char *output);
+static int lto_compile(char *input, char *output);
+static int lto_link(void);
+static int prof_link(void);
 static int run_linker(void);
 static int strlist_exec(struct strlist *l);
 static char *select_linker(char *);
@@ -281,6 +284,10 @@ char *win32commandline(struct strlist *l);
 #endif
 int	sspflag;
 int	freestanding;
+int	ltoflag, wholeflag;
+int	inlfflag;
+int	funcsflag, datasflag;
+char	*profgen, *profuse;	/* -fprofile-generate, -fprofile-use file */
 int	Sflag;
 int	cflag;
 int	gflag;
@@ -327,6 +334,9 @@ int	bigendian = 0;
 #ifdef mach_amd64
 int amd64_i386;
 #endif
+#ifdef mach_i386
+int sse2;
+#endif
 
 #define	match(a,b)	(strcmp(a,b) == 0)
 
@@ -623,6 +633,22 @@ main(int argc, char *argv[])
 			} else if (match(u, "stack-protector") ||
 			    match(u, "stack-protector-all")) {
 				sspflag = j ? 0 : 1;
+			} else if (match(u, "lto")) {
+				ltoflag = j ? 0 : 1;
+			} else if (match(u, "whole-program")) {
+				wholeflag = j ? 0 : 1;
+			} else if (match(u, "inline-functions")) {
+				inlfflag = j ? 0 : 1;
+			} else if (match(u, "function-sections")) {
+				funcsflag = j ? 0 : 1;
+			} else if (match(u, "data-sections")) {
+				datasflag = j ? 0 : 1;
+			} else if (strncmp(u, "profile-generate", 16) == 0 &&
+			    (u[16] == 0 || u[16] == '=')) {
+				profgen = j ? NULL : u[16] ? &u[17] : "pcc.prof";
+			} else if (strncmp(u, "profile-use", 11) == 0 &&
+			    (u[11] == 0 || u[11] == '=')) {
+				profuse = j ? NULL : u[11] ? &u[12] : "pcc.prof";
 			} else if (match(u, "use-ld=")) {
 				/* ignore nonsense -fno-use-ld=* command */
 				if (j)
@@ -698,6 +724,13 @@ main(int argc, char *argv[])
 				break;
 			}
 #endif
+#ifdef mach_i386
+			if (match(argp, "-msse2")) {
+				sse2 = 1;
+				strlist_append(&compiler_flags, argp);
+				break;
+			}
+#endif
 #if defined(mach_arm) || defined(mach_mips) || defined(mach_mips64)
 			if (match(argp, "-mbig-endian")) {
 				bigendian = 1;
@@ -715,7 +748,21 @@ main(int argc, char *argv[])
 				break;
 			}
 #endif
+#ifdef mach_aarch64
+			if (match(argp, "-msoft-float")) {
+				softfloat = 1;
+				strlist_append(&compiler_flags, argp);
+				break;
+			}
+#endif
 #if defined(mach_mips) || defined(mach_mips64)
+			if (strncmp(argp, "-mips", 5) == 0) {
+				strlist_append(&compiler_flags, argp);
+				strlist_append(&assembler_flags, argp);
+				break;
+			}
+#endif
+#if defined(mach_mips) || defined(mach_mips64) || defined(mach_aarch64)
 			if (match(argp, "-mhard-float")) {
 				softfloat = 0;
 				strlist_append(&compiler_flags, argp);
@@ -1112,6 +1159,19 @@ main(int argc, char *argv[])
 		/*
 		 * C compiler
 		 */
+		if (match(suffix, "i") && ltoflag && !Sflag) {
+			/* object is a summary and the source, see lto_link */
+			if (cflag) {
+				ofile = outfile;
+				if (ofile == NULL)
+					ofile = setsuf(s->value, 'o');
+			} else
+				strlist_append(&temp_outputs, ofile = gettmp());
+			if (lto_compile(ifile, ofile))
+				exandrm(ofile);
+			strlist_append(&middle_linker_flags, ofile);
+			continue;
+		}
 		if (match(suffix, "i")) {
 			/* find out next output file */
 			if (Sflag) {
@@ -1120,7 +1180,7 @@ main(int argc, char *argv[])
 					ofile = setsuf(s->value, 's');
 			} else
 				strlist_append(&temp_outputs, ofile = gettmp());
-			if (compile_input(ifile, ofile))
+			if (compile_input(ifile, ofile, NULL))
 				exandrm(ofile);
 			if (Sflag)
 				continue;
@@ -1154,6 +1214,8 @@ main(int argc, char *argv[])
 	/*
 	 * Linker
 	 */
+	if (lto_link() || prof_link())
+		exandrm(0);
 	setup_ld_flags();
 	if (run_linker())
 		exandrm(0);
@@ -1258,7 +1320,7 @@ find_file(const char *file, struct strlist *path, int mode)
 
 #ifdef TWOPASS
 static int
-compile_input(char *input, char *output)
+compile_input(char *input, char *output, struct strlist *extra)
 {
 	struct strlist args;
 	char *tfile;
@@ -1268,6 +1330,8 @@ compile_input(char *input, char *output)
 
 	strlist_init(&args);
 	strlist_append_list(&args, &compiler_flags);
+	if (extra)
+		strlist_append_list(&args, extra);
 	strlist_append(&args, input);
 	strlist_append(&args, tfile);
 	strlist_prepend(&args,
@@ -1289,13 +1353,15 @@ compile_input(char *input, char *output)
 }
 #else
 static int
-compile_input(char *input, char *output)
+compile_input(char *input, char *output, struct strlist *extra)
 {
 	struct strlist args;
 	int retval;
 
 	strlist_init(&args);
 	strlist_append_list(&args, &compiler_flags);
+	if (extra)
+		strlist_append_list(&args, extra);
 	strlist_append(&args, input);
 	strlist_append(&args, output);
 	strlist_prepend(&args,
@@ -1306,6 +1372,173 @@ compile_input(char *input, char *output)
 }
 #endif
 
+/*
+ * Compile for -flto.  The assembler output is thrown away, ccom
+ * writes the object itself.
+ */
+static int
+lto_compile(char *input, char *output)
+{
+	struct strlist extra;
+	char *tfile;
+	int retval;
+
+	strlist_append(&temp_outputs, tfile = gettmp());
+	strlist_init(&extra);
+	strlist_append(&extra, cat("-flto-write=", output));
+	retval = compile_input(input, tfile, &extra);
+	strlist_free(&extra);
+	return retval;
+}
+
+#define	LTOMAGIC	"\177lto"	/* see mip/manifest.h */
+
+static int
+islto(char *file)
+{
+	char buf[sizeof(LTOMAGIC)-1];
+	FILE *fp;
+	int rv;
+
+	if ((fp = fopen(file, "r")) == NULL)
+		return 0;
+	rv = fread(buf, 1, sizeof(buf), fp) == sizeof(buf) &&
+	    memcmp(buf, LTOMAGIC, sizeof(buf)) == 0;
+	fclose(fp);
+	return rv;
+}
+
+/*
+ * Compile the objects written by -flto, now that all of them
+ * are known, and replace them with real objects.
+ */
+static int
+lto_link(void)
+{
+	struct strlist extra;
+	struct string *s;
+	char *tfile, *ofile;
+	int retval = 0;
+
+	strlist_init(&extra);
+	STRLIST_FOREACH(s, &middle_linker_flags)
+		if (s->value[0] != '-' && islto(s->value))
+			strlist_append(&extra, cat("-flto-read=", s->value));
+	if (STRLIST_EMPTY(&extra))
+		return 0;
+	if (wholeflag && !shared && !rflag)
+		strlist_append(&extra, "-fwhole-program");
+
+	STRLIST_FOREACH(s, &middle_linker_flags) {
+		if (s->value[0] == '-' || !islto(s->value))
+			continue;
+		strlist_append(&temp_outputs, tfile = gettmp());
+		if ((retval = compile_input(s->value, tfile, &extra)))
+			break;
+		strlist_append(&temp_outputs, ofile = gettmp());
+		if ((retval = assemble_input(tfile, ofile)))
+			break;
+		s->value = ofile;
+	}
+	strlist_free(&extra);
+	return retval;
+}
+
+/*
+ * Runtime for -fprofile-generate, linked in with the program.  At
+ * exit it writes section pcc_prof, the counters of all files, to the
+ * profile.  If the profile is from the same program the counts of
+ * the earlier runs are added.
+ */
+static char *profrt[] = {
+	"extern unsigned long long __start_pcc_prof[] __attribute__((weak));",
+	"extern unsigned long long __stop_pcc_prof[] __attribute__((weak));",
+	"void *fopen(const char *, const char *);",
+	"unsigned long fread(void *, unsigned long, unsigned long, void *);",
+	"unsigned long fwrite(const void *, unsigned long, unsigned long,",
+	"    void *);",
+	"int fclose(void *);",
+	"void *malloc(unsigned long);",
+	"void free(void *);",
+	"int atexit(void (*)(void));",
+	"",
+	"static void",
+	"__pcc_prof_dump(void)",
+	"{",
+	"	unsigned long long *b = __start_pcc_prof, *e = __stop_pcc_prof;",
+	"	unsigned long long *o, *p, *q, i;",
+	"	unsigned long n = e - b;",
+	"	void *f;",
+	"",
+	"	if (b == 0 || n == 0)",
+	"		return;",
+	"	if ((o = malloc(n * 8 + 8)) != 0 &&",
+	"	    (f = fopen(__pcc_prof_name, \"rb\")) != 0) {",
+	"		if (fread(o, 8, n + 1, f) == n) {",
+	"			for (p = b, q = o; p < e && p[0] == q[0] &&",
+	"			    p[1] == q[1]; p += p[1] + 2, q += q[1] + 2)",
+	"				;",
+	"			if (p == e)",
+	"				for (p = b, q = o; p < e;",
+	"				    p += p[1] + 2, q += q[1] + 2)",
+	"					for (i = 0; i < p[1]; i++)",
+	"						p[i + 2] += q[i + 2];",
+	"		}",
+	"		fclose(f);",
+	"	}",
+	"	free(o);",
+	"	if ((f = fopen(__pcc_prof_name, \"wb\")) != 0) {",
+	"		fwrite(b, 8, n, f);",
+	"		fclose(f);",
+	"	}",
+	"}",
+	"",
+	"static void __attribute__((constructor))",
+	"__pcc_prof_init(void)",
+	"{",
+	"	atexit(__pcc_prof_dump);",
+	"}",
+	NULL
+};
+
+/*
+ * Compile the -fprofile-generate runtime and add it to the link.
+ */
+static int
+prof_link(void)
+{
+	struct strlist extra;
+	char *ifile, *sfile, *ofile, *s;
+	FILE *fp;
+	int i, retval;
+
+	if (profgen == NULL)
+		return 0;
+	strlist_append(&temp_outputs, ifile = gettmp());
+	if ((fp = fopen(ifile, "w")) == NULL)
+		errorx(8, "%s: %s", ifile, strerror(errno));
+	fprintf(fp, "static char __pcc_prof_name[] = \"");
+	for (s = profgen; *s; s++)
+		fprintf(fp, *s == '"' || *s == '\\' ? "\\%c" : "%c", *s);
+	fprintf(fp, "\";\n");
+	for (i = 0; profrt[i]; i++)
+		fprintf(fp, "%s\n", profrt[i]);
+	fclose(fp);
+
+	strlist_init(&extra);
+	strlist_append(&extra, "-fno-profile-generate");
+	strlist_append(&temp_outputs, sfile = gettmp());
+	retval = compile_input(ifile, sfile, &extra);
+	strlist_free(&extra);
+	if (retval)
+		return retval;
+	strlist_append(&temp_outputs, ofile = gettmp());
+	if ((retval = assemble_input(sfile, ofile)))
+		return retval;
+	strlist_append(&middle_linker_flags, ofile);
+	return 0;
+}
+
 static int
 assemble_input(char *input, char *output)
 {
@@ -1713,6 +1946,14 @@ struct flgcheck {
 	{ &Oflag, 1, "-D__OPTIMIZE__" },
 	{ &tflag, 1, "-t" },
 	{ &kflag, 1, "-D__PIC__" },
+#ifdef mach_i386
+	{ &sse2, 1, "-D__SSE__" },
+	{ &sse2, 1, "-D__SSE2__" },
+	{ &sse2, 1, "-D__SSE_MATH__" },
+	{ &sse2, 1, "-D__SSE2_MATH__" },
+	{ &sse2, 1, "-D__FLT_EVAL_METHOD__=0" },
+	{ &sse2, 0, "-D__FLT_EVAL_METHOD__=" MKS(TARGET_FLT_EVAL_METHOD) },
+#endif
 	{ 0 },
 };
 
@@ -1791,6 +2032,12 @@ static char *gcppflags[] = {
 	"-D__GNUC_PATCHLEVEL__=1",
 	"-D__REGISTER_PREFIX__=" REGISTER_PREFIX,
 	"-D__USER_LABEL_PREFIX__=" USER_LABEL_PREFIX,
+	"-D__ATOMIC_RELAXED=0",
+	"-D__ATOMIC_CONSUME=1",
+	"-D__ATOMIC_ACQUIRE=2",
+	"-D__ATOMIC_RELEASE=3",
+	"-D__ATOMIC_ACQ_REL=4",
+	"-D__ATOMIC_SEQ_CST=5",
 #if SZLONG == 64
 	"-D__SIZEOF_LONG__=8",
 #elif SZLONG == 32
@@ -1809,7 +2056,7 @@ static char *gcppflags[] = {
 /* Use floating point definitions form softfloat.h */
 
 static char *fpflags[] = {
-#ifdef TARGET_FLT_EVAL_METHOD
+#if defined(TARGET_FLT_EVAL_METHOD) && !defined(mach_i386)
 	"-D__FLT_EVAL_METHOD__=" MKS(TARGET_FLT_EVAL_METHOD),
 #endif
 #ifdef mach_i386
@@ -1918,8 +2165,15 @@ struct flgcheck ccomflgcheck[] = {
 	{ &Oflag, 1, "-xdeljumps" },
 	{ &Oflag, 1, "-xinline" },
 	{ &Oflag, 1, "-xdce" },
+	{ &Oflag, 1, "-xifconv" },
+	{ &Oflag, 1, "-xdelay" },
+	{ &Oflag, 1, "-xpeep" },
+	{ &Oflag, 1, "-xshrinkwrap" },
 	{ &Oflag, 1, "-xssa" },
 	{ &freestanding, 1, "-ffreestanding" },
+	{ &inlfflag, 1, "-finline-functions" },
+	{ &funcsflag, 1, "-ffunction-sections" },
+	{ &datasflag, 1, "-fdata-sections" },
 	{ &pgflag, 1, "-p" },
 	{ &gflag, 1, "-g" },
 	{ &xgnu89, 1, "-xgnu89" },
@@ -1945,6 +2199,10 @@ setup_ccom_flags(void)
 {
 
 	cksetflags(ccomflgcheck, &compiler_flags, 'a');
+	if (profgen)
+		strlist_append(&compiler_flags, "-fprofile-generate");
+	if (profuse)
+		strlist_append(&compiler_flags, cat("-fprofile-use=", profuse));
 }
 
 #if defined(USE_YASM) || defined(os_win32) || defined(os_darwin) || \
@@ -79,20 +79,33 @@ builtin_constant_p(const struct bitable *bt, P1ND *a)
 
 /*
  * Hint to the compiler whether this expression will evaluate true or false.
- * Just ignored for now.
+ * Only used when it is the condition of an if or loop, see xcbranch().
  */
 static P1ND *
 builtin_expect(const struct bitable *bt, P1ND *a)
 {
 	P1ND *f;
+	int c = -1;
 
 	if (a && a->n_op == CM) {
+		if (a->n_right->n_op == ICON && a->n_right->n_sp == NULL)
+			c = glval(a->n_right) != 0;
 		p1tfree(a->n_right);
 		f = a->n_left;
 		p1nfree(a);
 		a = f;
 	}
-
+	if (a && a->n_op == SCONV && clogop(a->n_left->n_op)) {
+		/* keep comparisons as branches */
+		f = a->n_left;
+		p1nfree(a);
+		a = f;
+	}
+	if (c >= 0) {
+		/* if used as a condition, xcbranch() passes the hint on */
+		expnode = a;
+		expval = c;
+	}
 	return a;
 }
 
@@ -474,6 +487,14 @@ builtin_va_arg(const struct bitable *bt, P1ND *a)
 	P1ND *p, *q, *r, *rv;
 	int sz, nodnum;
 
+#ifdef NOFPVAARG
+	if (NOFPVAARG && ISFTY(a->n_right->n_type)) {
+		uerror("va_arg of floating type not supported");
+		p1tfree(a);
+		return bcon(0);
+	}
+#endif
+
 	/* create a copy to a temp node of current ap */
 	p = ccopy(a->n_left);
 	q = tempnode(0, p->n_type, p->n_df, p->n_ap);
@@ -556,6 +577,522 @@ builtin_unimp_f(P1ND *f, P1ND *a, TWORD rt)
 }
 #endif
 
+/*
+ * Atomic builtins, both the __sync and the __atomic families.
+ *
+ * A target that can do atomic operations on some object sizes
+ * defines TARGET_ATOMICS as a mask of those sizes (in bytes) and
+ * implements the FENCE, XADD, XCHG and CMPXCHG nodes; all other
+ * read-modify-write operations are built as compare-and-swap loops.
+ * Read-modify-write operations on other sizes are calls to the
+ * __atomic_*_N functions in libatomic, which get the memory orders.
+ * Inline they are always full barriers, the weaker memory orders are
+ * only used for plain loads and stores.
+ */
+#ifdef TARGET_ATOMICS
+#define	atomszinl(sz)	(((TARGET_ATOMICS) & (sz)) != 0)
+#else
+#define	atomszinl(sz)	0
+#endif
+#define	atominl(t)	atomszinl(atomsz(t))
+
+#define	ATOMIC_RELAXED	0	/* memory orders, as in __ATOMIC_* */
+#define	ATOMIC_CONSUME	1
+#define	ATOMIC_ACQUIRE	2
+#define	ATOMIC_RELEASE	3
+#define	ATOMIC_ACQ_REL	4
+#define	ATOMIC_SEQ_CST	5
+
+#define	A_ADD	0
+#define	A_SUB	1
+#define	A_OR	2
+#define	A_AND	3
+#define	A_XOR	4
+#define	A_NAND	5
+static char *atomops[] = { "add", "sub", "or", "and", "xor", "nand" };
+
+static union dimfun *atomdf;	/* of the object, set by atomargs() */
+static struct attr *atomap;
+
+static int
+atomsz(TWORD t)
+{
+	return (int)(tsize(t, 0, 0)/SZCHAR);
+}
+
+/*
+ * Split up the arguments to an atomic builtin into av[] and return
+ * the type of the object pointed to by the first one.  If anyptr is
+ * set the first argument may point to anything.
+ * Returns 0 if something is wrong.
+ */
+static TWORD
+atomargs(const struct bitable *bt, P1ND *a, P1ND **av, int anyptr)
+{
+	P1ND *q;
+	TWORD t;
+	int i, n;
+
+	n = 0;
+	if (a != NULL)
+		for (n = 1, q = a; q->n_op == CM; q = q->n_left)
+			n++;
+	if (n != bt->narg) {
+		uerror("wrong argument count to %s", bt->name);
+		if (a != NULL)
+			p1tfree(a);
+		return 0;
+	}
+	for (i = n-1; i > 0; i--) {
+		av[i] = a->n_right;
+		q = a;
+		a = a->n_left;
+		p1nfree(q);
+	}
+	av[0] = a;
+
+	t = DECREF(a->n_type);
+	atomdf = a->n_df;
+	atomap = a->n_ap;
+	if (ISPTR(a->n_type) && anyptr)
+		return t;
+	if (!ISPTR(a->n_type) || (!ISPTR(t) && (t < BOOL || t > ULONGLONG)) ||
+	    (atomsz(t) & (atomsz(t)-1)) != 0) {
+		uerror("bad pointer argument to %s", bt->name);
+		for (i = 0; i < n; i++)
+			p1tfree(av[i]);
+		return 0;
+	}
+	return t;
+}
+
+/*
+ * Memory order argument.  Non-constant orders are taken as seq_cst.
+ */
+static int
+atomord(P1ND *p)
+{
+	int m = ATOMIC_SEQ_CST;
+
+	if (nncon(p))
+		m = (int)glval(p);
+	p1tfree(p);
+	return m;
+}
+
+/*
+ * Integer type to do arithmetic on t in, pointers are treated as
+ * unscaled integers.
+ */
+static TWORD
+atomtype(TWORD t)
+{
+	return ISPTR(t) ? ctype(INTPTR) : t;
+}
+
+/*
+ * Call the libatomic version of an atomic operation on t, which
+ * returns rt.
+ */
+static P1ND *
+atomcall(char *fmt, char *op, TWORD t, TWORD rt, P1ND *a)
+{
+	char buf[40];
+
+	snprintf(buf, sizeof(buf), fmt, op, atomsz(t));
+	return binhelp(a, rt, buf);
+}
+
+/*
+ * Cast the result p of an atomic operation back to the object type
+ * t, which may be a struct pointer.
+ */
+static P1ND *
+atomcast(P1ND *p, TWORD t)
+{
+	P1ND *q;
+
+	q = block(NAME, NULL, NULL, t, atomdf, atomap);
+	q = buildtree(CAST, q, p);
+	p = q->n_right;
+	p1nfree(q->n_left);
+	p1nfree(q);
+	return p;
+}
+
+/*
+ * Put pointer p in a temporary, return the assignment in *rn.
+ */
+static P1ND *
+atomptr(P1ND *p, P1ND **rn)
+{
+	P1ND *tp;
+
+	tp = tempnode(0, p->n_type, p->n_df, p->n_ap);
+	*rn = buildtree(ASSIGN, ccopy(tp), p);
+	return tp;
+}
+
+static P1ND *
+atomfence(int kind)
+{
+#ifdef TARGET_ATOMICS
+	return block(FENCE, bcon(kind), NULL, INT, 0, 0);
+#else
+	return binhelp(NULL, VOID, "__sync_synchronize");
+#endif
+}
+
+/*
+ * Compare-and-swap *tp from o to n, returns the old value of *tp.
+ * tp must be a temporary.  ms and mf are the memory orders on
+ * success and failure.
+ */
+static P1ND *
+atomcas(P1ND *tp, P1ND *o, P1ND *n, TWORD t, int ms, int mf)
+{
+	P1ND *te, *rn, *p;
+	TWORD at = atomtype(t);
+
+	o = cast(o, at, 0);
+	n = cast(n, at, 0);
+	if (atominl(t))
+		return block(CMPXCHG, tp, block(CM, o, n, at, 0, 0), at, 0, 0);
+
+	/* the expected value is replaced by the old one if they differ */
+	te = tempnode(0, at, 0, 0);
+	rn = buildtree(ASSIGN, ccopy(te), o);
+	p = buildtree(CM, tp, buildtree(ADDROF, ccopy(te), NULL));
+	p = buildtree(CM, buildtree(CM, p, n), bcon(0));
+	p = buildtree(CM, buildtree(CM, p, bcon(ms)), bcon(mf));
+	p = atomcall("__atomic_compare_exchange_%s%d", "", t, BOOL, p);
+	return cmop(cmop(rn, p), te);
+}
+
+/*
+ * Store v into *tp with memory order m, returns the old value of *tp.
+ */
+static P1ND *
+atomxchg(P1ND *tp, P1ND *v, TWORD t, int m)
+{
+	TWORD at = atomtype(t);
+
+	v = cast(v, at, 0);
+	if (atominl(t))
+		return block(XCHG, tp, v, at, 0, 0);
+	return atomcall("__atomic_exchange_%s%d", "", t, at,
+	    buildtree(CM, buildtree(CM, tp, v), bcon(m)));
+}
+
+/*
+ * Do *tp = *tp op v with memory order m.  Returns the old value of
+ * *tp, or the new value if isnew is set.
+ */
+static P1ND *
+atomrmw(int op, P1ND *tp, P1ND *v, TWORD t, int isnew, int m)
+{
+	P1ND *rn, *tv, *to, *tn, *p;
+	TWORD at = atomtype(t);
+	int l;
+
+	if (!atominl(t))
+		return atomcall(isnew ? "__atomic_%s_fetch_%d" :
+		    "__atomic_fetch_%s_%d", atomops[op], t, at,
+		    buildtree(CM, buildtree(CM, tp, cast(v, at, 0)), bcon(m)));
+
+	tv = tempnode(0, at, 0, 0);
+	rn = buildtree(ASSIGN, ccopy(tv), v);
+	if (op == A_ADD || op == A_SUB) {
+		p = ccopy(tv);
+		if (op == A_SUB)
+			p = cast(buildtree(UMINUS, p, NULL), at, 0);
+		p = block(XADD, tp, p, at, 0, 0);
+		if (isnew)
+			p = cast(buildtree(op == A_ADD ? PLUS : MINUS,
+			    p, ccopy(tv)), at, 0);
+		p1tfree(tv);
+		return cmop(rn, p);
+	}
+
+	/*
+	 * Compare-and-swap loop:
+	 *	l: to = *tp; tn = to op tv; if (cas(tp, to, tn) != to) goto l;
+	 */
+	to = tempnode(0, at, 0, 0);
+	tn = tempnode(0, at, 0, 0);
+	l = getlab();
+	rn = cmop(rn, lblnod(l));
+	rn = cmop(rn, buildtree(ASSIGN, ccopy(to),
+	    cast(buildtree(UMUL, ccopy(tp), NULL), at, 0)));
+	switch (op) {
+	case A_OR: p = buildtree(OR, ccopy(to), tv); break;
+	case A_AND: p = buildtree(AND, ccopy(to), tv); break;
+	case A_XOR: p = buildtree(ER, ccopy(to), tv); break;
+	default: /* A_NAND */
+		p = buildtree(COMPL, buildtree(AND, ccopy(to), tv), NULL);
+		break;
+	}
+	rn = cmop(rn, buildtree(ASSIGN, ccopy(tn), p));
+	p = atomcas(tp, ccopy(to), ccopy(tn), t, m, m);
+	rn = cmop(rn, buildtree(CBRANCH,
+	    buildtree(NE, p, ccopy(to)), bcon(l)));
+	if (isnew) {
+		p1tfree(to);
+		return cmop(rn, tn);
+	}
+	p1tfree(tn);
+	return cmop(rn, to);
+}
+
+/*
+ * Load *tp with memory order m.
+ */
+static P1ND *
+atomload(P1ND *tp, TWORD t, int m)
+{
+	P1ND *p, *tv;
+
+	p = buildtree(UMUL, tp, NULL);
+	if (m == ATOMIC_RELAXED)
+		return p;
+	tv = tempnode(0, t, p->n_df, p->n_ap);
+	p = buildtree(ASSIGN, ccopy(tv), p);
+	return cmop(cmop(p, atomfence(FENCE_ACQ)), tv);
+}
+
+/*
+ * Store v into *tp with memory order m.
+ */
+static P1ND *
+atomstore(P1ND *tp, P1ND *v, TWORD t, int m)
+{
+	P1ND *p;
+
+	if (m == ATOMIC_SEQ_CST && atominl(t))
+		return atomxchg(tp, v, t, m);
+	p = buildtree(ASSIGN, buildtree(UMUL, tp, NULL), v);
+	if (m == ATOMIC_RELAXED)
+		return p;
+	p = cmop(atomfence(FENCE_REL), p);
+	if (m == ATOMIC_SEQ_CST)
+		p = cmop(p, atomfence(FENCE_FULL));
+	return p;
+}
+
+/*
+ * __sync_fetch_and_<op>, __sync_<op>_and_fetch,
+ * __atomic_fetch_<op> and __atomic_<op>_fetch.
+ */
+static P1ND *
+builtin_atomic_rmw(const struct bitable *bt, P1ND *a)
+{
+	P1ND *av[3], *rn, *tp;
+	char *s;
+	TWORD t;
+	int op, isnew, m;
+
+	if ((t = atomargs(bt, a, av, 0)) == 0)
+		return bcon(0);
+	m = bt->narg == 3 ? atomord(av[2]) : ATOMIC_SEQ_CST;
+	if (strncmp(bt->name, "__sync_", 7) == 0) {
+		s = &bt->name[7];
+		if ((isnew = strncmp(s, "fetch_and_", 10)) == 0)
+			s += 10;
+	} else {
+		s = &bt->name[9];
+		if ((isnew = strncmp(s, "fetch_", 6)) == 0)
+			s += 6;
+	}
+	for (op = A_ADD; op < A_NAND; op++)
+		if (strncmp(s, atomops[op], strlen(atomops[op])) == 0 &&
+		    s[strlen(atomops[op])] == (isnew ? '_' : 0))
+			break;
+
+	tp = atomptr(av[0], &rn);
+	return atomcast(cmop(rn, atomrmw(op, tp, av[1], t, isnew != 0, m)), t);
+}
+
+/*
+ * __sync_bool_compare_and_swap and __sync_val_compare_and_swap.
+ */
+static P1ND *
+builtin_sync_cas(const struct bitable *bt, P1ND *a)
+{
+	P1ND *av[3], *rn, *tp, *to, *p;
+	TWORD t;
+
+	if ((t = atomargs(bt, a, av, 0)) == 0)
+		return bcon(0);
+	tp = atomptr(av[0], &rn);
+	if (bt->name[7] == 'v')
+		return atomcast(cmop(rn, atomcas(tp, av[1], av[2], t,
+		    ATOMIC_SEQ_CST, ATOMIC_SEQ_CST)), t);
+
+	to = tempnode(0, atomtype(t), 0, 0);
+	rn = cmop(rn, buildtree(ASSIGN, ccopy(to), cast(av[1], atomtype(t), 0)));
+	p = atomcas(tp, ccopy(to), av[2], t, ATOMIC_SEQ_CST, ATOMIC_SEQ_CST);
+	return cmop(rn, buildtree(EQ, p, to));
+}
+
+/*
+ * __atomic_compare_exchange_n and __atomic_compare_exchange.
+ * The weak flag is ignored.
+ */
+static P1ND *
+builtin_atomic_cas(const struct bitable *bt, P1ND *a)
+{
+	P1ND *av[6], *rn, *r2, *tp, *te, *to, *tr, *d;
+	TWORD t;
+	int l, ms, mf;
+
+	if ((t = atomargs(bt, a, av, 0)) == 0)
+		return bcon(0);
+	p1tfree(av[3]);
+	ms = atomord(av[4]);
+	mf = atomord(av[5]);
+	d = av[2];
+	if (bt->name[25] == 0)
+		d = buildtree(UMUL, d, NULL);
+
+	tp = atomptr(av[0], &rn);
+	te = atomptr(av[1], &r2);
+	rn = cmop(rn, r2);
+	to = tempnode(0, atomtype(t), 0, 0);
+	tr = tempnode(0, atomtype(t), 0, 0);
+	rn = cmop(rn, buildtree(ASSIGN, ccopy(to),
+	    cast(buildtree(UMUL, ccopy(te), NULL), atomtype(t), 0)));
+	rn = cmop(rn, buildtree(ASSIGN, ccopy(tr),
+	    atomcas(tp, ccopy(to), d, t, ms, mf)));
+	l = getlab();
+	rn = cmop(rn, buildtree(CBRANCH,
+	    buildtree(EQ, ccopy(tr), ccopy(to)), bcon(l)));
+	rn = cmop(rn, buildtree(ASSIGN, buildtree(UMUL, te, NULL),
+	    atomcast(ccopy(tr), t)));
+	rn = cmop(rn, lblnod(l));
+	return cmop(rn, buildtree(EQ, tr, to));
+}
+
+/*
+ * __sync_lock_test_and_set, __atomic_exchange_n and __atomic_exchange.
+ */
+static P1ND *
+builtin_atomic_xchg(const struct bitable *bt, P1ND *a)
+{
+	P1ND *av[4], *rn, *tp, *p;
+	TWORD t;
+	int m = ATOMIC_ACQUIRE;		/* __sync_lock_test_and_set */
+
+	if ((t = atomargs(bt, a, av, 0)) == 0)
+		return bcon(0);
+	if (bt->narg > 2)
+		m = atomord(av[bt->narg-1]);
+	if (bt->narg == 4)
+		av[1] = buildtree(UMUL, av[1], NULL);
+	tp = atomptr(av[0], &rn);
+	p = atomcast(cmop(rn, atomxchg(tp, av[1], t, m)), t);
+	if (bt->narg == 4)
+		p = buildtree(ASSIGN, buildtree(UMUL, av[2], NULL), p);
+	return p;
+}
+
+/*
+ * __atomic_load_n and __atomic_load.
+ */
+static P1ND *
+builtin_atomic_load(const struct bitable *bt, P1ND *a)
+{
+	P1ND *av[3], *p;
+	TWORD t;
+
+	if ((t = atomargs(bt, a, av, 0)) == 0)
+		return bcon(0);
+	p = atomload(av[0], t, atomord(av[bt->narg-1]));
+	if (bt->narg == 3)
+		p = buildtree(ASSIGN, buildtree(UMUL, av[1], NULL), p);
+	return p;
+}
+
+/*
+ * __atomic_store_n, __atomic_store and __sync_lock_release.
+ */
+static P1ND *
+builtin_atomic_store(const struct bitable *bt, P1ND *a)
+{
+	P1ND *av[3], *v, *rn, *tp;
+	TWORD t;
+	int m;
+
+	if ((t = atomargs(bt, a, av, 0)) == 0)
+		return bcon(0);
+	if (bt->narg == 1) {
+		v = bcon(0);
+		m = ATOMIC_RELEASE;
+	} else {
+		v = av[1];
+		if (bt->name[14] == 0)
+			v = buildtree(UMUL, v, NULL);
+		m = atomord(av[2]);
+	}
+	tp = atomptr(av[0], &rn);
+	return cmop(rn, atomstore(tp, v, t, m));
+}
+
+/*
+ * __atomic_test_and_set and __atomic_clear work on bytes.
+ */
+static P1ND *
+builtin_atomic_tas(const struct bitable *bt, P1ND *a)
+{
+	P1ND *av[2], *rn, *tp;
+	int m;
+
+	if (atomargs(bt, a, av, 1) == 0)
+		return bcon(0);
+	m = atomord(av[1]);
+	tp = atomptr(cast(av[0], INCREF(UCHAR), 0), &rn);
+	if (bt->name[9] == 'c')
+		return cmop(rn, atomstore(tp, bcon(0), UCHAR, m));
+	return buildtree(NE, cmop(rn, atomxchg(tp, bcon(1), UCHAR, m)), bcon(0));
+}
+
+/*
+ * __atomic_thread_fence, __atomic_signal_fence and __sync_synchronize.
+ * Nothing is moved across statements, so signal fences need no code.
+ */
+static P1ND *
+builtin_atomic_fence(const struct bitable *bt, P1ND *a)
+{
+	int m = a ? atomord(a) : ATOMIC_SEQ_CST;
+
+	if (m == ATOMIC_RELAXED || bt->name[9] == 's')
+		return bcon(0);
+	if (m == ATOMIC_ACQUIRE || m == ATOMIC_CONSUME)
+		return atomfence(FENCE_ACQ);
+	if (m == ATOMIC_RELEASE)
+		return atomfence(FENCE_REL);
+	return atomfence(FENCE_FULL);
+}
+
+/*
+ * __atomic_always_lock_free and __atomic_is_lock_free.
+ */
+static P1ND *
+builtin_atomic_lockfree(const struct bitable *bt, P1ND *a)
+{
+	int sz = 0;
+
+	if (a == NULL || a->n_op != CM) {
+		uerror("wrong argument count to %s", bt->name);
+		if (a != NULL)
+			p1tfree(a);
+		return bcon(0);
+	}
+	if (nncon(a->n_left))
+		sz = (int)glval(a->n_left);
+	p1tfree(a);
+	return bcon(sz > 0 && (sz & (sz-1)) == 0 && atomszinl(sz));
+}
+
 #ifndef TARGET_PREFETCH
 static P1ND *
 builtin_prefetch(const struct bitable *bt, P1ND *a)
@@ -993,6 +1530,85 @@ static const struct bitable bitable[] = {
 	    builtin_frame_address, 0, 1, bitt, VOID|PTR },
 	{ "__builtin_return_address",
 	    builtin_return_address, 0, 1, bitt, VOID|PTR },
+
+	/* atomic operations */
+	{ "__sync_fetch_and_add",
+	    builtin_atomic_rmw, BTNOPROTO|BTNORVAL, 2, 0, 0 },
+	{ "__sync_fetch_and_sub",
+	    builtin_atomic_rmw, BTNOPROTO|BTNORVAL, 2, 0, 0 },
+	{ "__sync_fetch_and_or",
+	    builtin_atomic_rmw, BTNOPROTO|BTNORVAL, 2, 0, 0 },
+	{ "__sync_fetch_and_and",
+	    builtin_atomic_rmw, BTNOPROTO|BTNORVAL, 2, 0, 0 },
+	{ "__sync_fetch_and_xor",
+	    builtin_atomic_rmw, BTNOPROTO|BTNORVAL, 2, 0, 0 },
+	{ "__sync_fetch_and_nand",
+	    builtin_atomic_rmw, BTNOPROTO|BTNORVAL, 2, 0, 0 },
+	{ "__sync_add_and_fetch",
+	    builtin_atomic_rmw, BTNOPROTO|BTNORVAL, 2, 0, 0 },
+	{ "__sync_sub_and_fetch",
+	    builtin_atomic_rmw, BTNOPROTO|BTNORVAL, 2, 0, 0 },
+	{ "__sync_or_and_fetch",
+	    builtin_atomic_rmw, BTNOPROTO|BTNORVAL, 2, 0, 0 },
+	{ "__sync_and_and_fetch",
+	    builtin_atomic_rmw, BTNOPROTO|BTNORVAL, 2, 0, 0 },
+	{ "__sync_xor_and_fetch",
+	    builtin_atomic_rmw, BTNOPROTO|BTNORVAL, 2, 0, 0 },
+	{ "__sync_nand_and_fetch",
+	    builtin_atomic_rmw, BTNOPROTO|BTNORVAL, 2, 0, 0 },
+	{ "__sync_bool_compare_and_swap",
+	    builtin_sync_cas, BTNOPROTO, 3, 0, INT },
+	{ "__sync_val_compare_and_swap",
+	    builtin_sync_cas, BTNOPROTO|BTNORVAL, 3, 0, 0 },
+	{ "__sync_lock_test_and_set",
+	    builtin_atomic_xchg, BTNOPROTO|BTNORVAL, 2, 0, 0 },
+	{ "__sync_lock_release", builtin_atomic_store, BTNOPROTO, 1, 0, VOID },
+	{ "__sync_synchronize", builtin_atomic_fence, 0, 0, 0, VOID },
+	{ "__atomic_fetch_add",
+	    builtin_atomic_rmw, BTNOPROTO|BTNORVAL, 3, 0, 0 },
+	{ "__atomic_fetch_sub",
+	    builtin_atomic_rmw, BTNOPROTO|BTNORVAL, 3, 0, 0 },
+	{ "__atomic_fetch_or",
+	    builtin_atomic_rmw, BTNOPROTO|BTNORVAL, 3, 0, 0 },
+	{ "__atomic_fetch_and",
+	    builtin_atomic_rmw, BTNOPROTO|BTNORVAL, 3, 0, 0 },
+	{ "__atomic_fetch_xor",
+	    builtin_atomic_rmw, BTNOPROTO|BTNORVAL, 3, 0, 0 },
+	{ "__atomic_fetch_nand",
+	    builtin_atomic_rmw, BTNOPROTO|BTNORVAL, 3, 0, 0 },
+	{ "__atomic_add_fetch",
+	    builtin_atomic_rmw, BTNOPROTO|BTNORVAL, 3, 0, 0 },
+	{ "__atomic_sub_fetch",
+	    builtin_atomic_rmw, BTNOPROTO|BTNORVAL, 3, 0, 0 },
+	{ "__atomic_or_fetch",
+	    builtin_atomic_rmw, BTNOPROTO|BTNORVAL, 3, 0, 0 },
+	{ "__atomic_and_fetch",
+	    builtin_atomic_rmw, BTNOPROTO|BTNORVAL, 3, 0, 0 },
+	{ "__atomic_xor_fetch",
+	    builtin_atomic_rmw, BTNOPROTO|BTNORVAL, 3, 0, 0 },
+	{ "__atomic_nand_fetch",
+	    builtin_atomic_rmw, BTNOPROTO|BTNORVAL, 3, 0, 0 },
+	{ "__atomic_load_n", builtin_atomic_load, BTNOPROTO|BTNORVAL, 2, 0, 0 },
+	{ "__atomic_load", builtin_atomic_load, BTNOPROTO, 3, 0, VOID },
+	{ "__atomic_store_n", builtin_atomic_store, BTNOPROTO, 3, 0, VOID },
+	{ "__atomic_store", builtin_atomic_store, BTNOPROTO, 3, 0, VOID },
+	{ "__atomic_exchange_n",
+	    builtin_atomic_xchg, BTNOPROTO|BTNORVAL, 3, 0, 0 },
+	{ "__atomic_exchange", builtin_atomic_xchg, BTNOPROTO, 4, 0, VOID },
+	{ "__atomic_compare_exchange_n",
+	    builtin_atomic_cas, BTNOPROTO, 6, 0, INT },
+	{ "__atomic_compare_exchange",
+	    builtin_atomic_cas, BTNOPROTO, 6, 0, INT },
+	{ "__atomic_test_and_set", builtin_atomic_tas, BTNOPROTO, 2, 0, INT },
+	{ "__atomic_clear", builtin_atomic_tas, BTNOPROTO, 2, 0, VOID },
+	{ "__atomic_thread_fence",
+	    builtin_atomic_fence, BTNOPROTO, 1, 0, VOID },
+	{ "__atomic_signal_fence",
+	    builtin_atomic_fence, BTNOPROTO, 1, 0, VOID },
+	{ "__atomic_always_lock_free",
+	    builtin_atomic_lockfree, BTNOPROTO, 2, 0, INT },
+	{ "__atomic_is_lock_free",
+	    builtin_atomic_lockfree, BTNOPROTO, 2, 0, INT },
 #ifdef TARGET_BUILTINS
 	TARGET_BUILTINS
 #endif
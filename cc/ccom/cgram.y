@@ -1863,6 +1863,8 @@ fundef(P1ND *tp, P1ND *p)
 
 	cftnsp = s;
 	defid(p, class);
+	if ((ltomode || inlfuncs) && !fun_inline)
+		inline_save(s);
 	if (s->sdf->dfun == 0 && !issyshdr)
 		warner(Wstrict_prototypes);
 #ifdef GCC_COMPAT
@@ -2145,7 +2147,7 @@ eve(P1ND *p)
 	case NAME:
 		sp = lookup((char *)p->n_sp,
 		    attr_find(p->n_ap, ATTR_P1LABELS) ? SLBLNAME|STEMP : 0);
-		if (sp->sflags & SINLINE)
+		if ((sp->sflags & SINLINE) || ((ltomode || inlfuncs) && ISFTN(sp->stype)))
 			inline_ref(sp);
 		r = nametree(sp);
 		if (sp->sflags & SDYNARRAY)
@@ -2549,11 +2551,19 @@ mkclabs(void)
 void
 xcbranch(P1ND *p, int lab)
 {
+	int e;
+
+	if (p == expnode)
+		explab = lab; /* mark branches from __builtin_expect() */
+	if ((e = profbranch()) >= 0 && explab == NOLAB)
+		explab = lab, expval = e;
 #ifndef NO_COMPLEX
 	if (ANYCX(p))
 		p = cxop(NE, p, bcon(0));
 #endif
 	cbranch(buildtree(NOT, p, NULL), bcon(lab));
+	explab = NOLAB;
+	profheld();
 }
 
 /*
@@ -409,6 +409,8 @@ struct atax {
 	CS(GCC_ATYP_NOCLONE)	{ A_0ARG, "noclone" },
 	CS(GCC_ATYP_REGPARM)	{ A_1ARG, "regparm" },
 	CS(GCC_ATYP_FASTCALL)	{ A_0ARG, "fastcall" },
+	CS(GCC_ATYP_HOT)	{ A_0ARG, "hot" },
+	CS(GCC_ATYP_COLD)	{ A_0ARG, "cold" },
 
 	CS(GCC_ATYP_BOUNDED)	{ A_3ARG|A_MANY|A1_NAME, "bounded" },
 
@@ -87,9 +87,11 @@
  *   out in memory. Static or extern variables outside functions.
  * - Initialization at run-time, written to their values as code.
  *
- * Currently run-time-initialized variables are only initialized by using
- * move instructions.  An optimization might be to detect that it is
- * initialized with constants and therefore copied from readonly memory.
+ * Small run-time-initialized variables are initialized by using move
+ * instructions.  Bigger ones that are mostly constant are first copied
+ * from a template in readonly memory, and those that are mostly zero
+ * are copied from a zero block in bss, see autoinit().  Then only the
+ * remaining elements are moved.
  */
 
 /*
@@ -128,6 +130,7 @@ static struct instk {
 	TWORD	in_t;		/* type for this level */
 	int	in_n;		/* number of arrays seen so far */
 	int	in_fl;	/* flag which says if this level is controlled by {} */
+	struct	instk *in_nxt;	/* next level, reused by stkpush() */
 } *pstk, pbase;
 
 int doing_init, statinit;
@@ -156,16 +159,27 @@ struct llist {
 	struct ilist *il;
 };
 static SLIST_HEAD(llh, llist) lpole;
+static struct llist *lastll;	/* last entry found by setll() */
 static CONSZ basesz;
-static int numents; /* # of array entries allocated */
+static int numents; /* # of array entries seen */
+static int numlls; /* # of array entries allocated */
+#ifdef BLOBINIT
+static unsigned char *iblob;	/* image of constant data, see blobset() */
+static size_t iblobsz;		/* # of bytes allocated in iblob */
+#endif
 
 static struct initctx {
 	struct initctx *prev;
 	struct instk *pstk;
 	struct symtab *psym;
 	struct llh lpole;
+	struct llist *lastll;
 	CONSZ basesz;
-	int numents;
+	int numents, numlls;
+#ifdef BLOBINIT
+	unsigned char *iblob;
+	size_t iblobsz;
+#endif
 } *inilnk;
 
 static struct ilist *
@@ -190,10 +204,10 @@ getll(void)
 	struct llist *ll;
 
 	ll = tmpalloc(sizeof(struct llist));
-	ll->begsz = numents * basesz;
+	ll->begsz = numlls * basesz;
 	ll->il = NULL;
 	SLIST_INSERT_LAST(&lpole, ll, next);
-	numents++;
+	numlls++;
 	return ll;
 }
 
@@ -204,19 +218,20 @@ getll(void)
 static struct llist *
 setll(OFFSZ off)
 {
-	struct llist *ll = NULL;
+	struct llist *ll;
 
 	/* Ensure that we have enough entries */
-	while (off >= basesz * numents)
-		 ll = getll();
+	while (off >= basesz * numlls)
+		 lastll = getll();
 
+	ll = lastll;
 	if (ll != NULL && ll->begsz <= off && ll->begsz + basesz > off)
 		return ll;
 
 	SLIST_FOREACH(ll, &lpole, next)
 		if (ll->begsz <= off && ll->begsz + basesz > off)
 			break;
-	return ll; /* ``cannot fail'' */
+	return lastll = ll; /* ``cannot fail'' */
 }
 char *astypnames[] = { 0, 0, "\t.byte", "\t.byte", "\t.short", "\t.short",
 	"\t.word", "\t.word", "\t.long", "\t.long", "\t.quad", "\t.quad",
@@ -414,13 +429,22 @@ beginit(struct symtab *sp)
 		ict->pstk = pstk;
 		ict->psym = csym;
 		ict->lpole = lpole;
+		ict->lastll = lastll;
 		ict->basesz = basesz;
 		ict->numents = numents;
+		ict->numlls = numlls;
+#ifdef BLOBINIT
+		ict->iblob = iblob;
+		ict->iblobsz = iblobsz;
+		iblob = NULL;
+		iblobsz = 0;
+#endif
 		is = tmpalloc(sizeof(struct instk));
 	}
 	csym = sp;
 
-	numents = 0; /* no entries in array list */
+	numents = numlls = 0; /* no entries in array list */
+	lastll = NULL;
 	if (ISARY(sp->stype)) {
 		basesz = tsize(DECREF(sp->stype), sp->sdf+1, sp->sap);
 		if (basesz == 0) {
@@ -442,6 +466,7 @@ beginit(struct symtab *sp)
 	is->in_df = sp->sdf;
 	is->in_fl = 0;
 	is->in_prev = NULL;
+	is->in_nxt = NULL;
 	pstk = is;
 	doing_init++;
 	if (sp->sclass == STATIC || sp->sclass == EXTDEF)
@@ -481,8 +506,15 @@ stkpush(void)
 	 * Figure out what the next initializer will be, and push it on 
 	 * the stack.  If this is an array, just decrement type, if it
 	 * is a struct or union, extract the next element.
+	 * Only one entry per level is in use at a time, so the one
+	 * left from the last push is reused.
 	 */
-	is = tmpalloc(sizeof(struct instk));
+	if (pstk == NULL || (is = pstk->in_nxt) == NULL) {
+		is = tmpalloc(sizeof(struct instk));
+		is->in_nxt = NULL;
+		if (pstk != NULL)
+			pstk->in_nxt = is;
+	}
 	is->in_fl = 0;
 	is->in_n = 0;
 	if (pstk == NULL) {
@@ -622,6 +654,236 @@ findoff(void)
 	return off;
 }
 
+#ifdef BLOBINIT
+/*
+ * Constant static data is not kept in the ilist until endinit(), it
+ * is written to an image of the object as it is seen.  Only address
+ * constants and such are left as nodes.  The image is then printed
+ * out as byte strings, with runs of repeated values compressed.
+ */
+#define	BLOBRUN	16	/* shortest run to compress */
+#define	BLOBLINE 32	/* max bytes per .ascii line, fits in pass2 SZIBUF */
+
+/*
+ * Check if p can be written to the image.
+ */
+static int
+isblob(NODE *p, int fsz)
+{
+	if (csym->sclass == AUTO || fsz > SZLONGLONG || fsz < -SZLONGLONG)
+		return 0;
+	if (p->n_op == ICON)
+		return p->n_sp == NULL;
+	return p->n_op == FCON && fsz > 0 &&
+	    (p->n_type == FLOAT || p->n_type == DOUBLE || p->n_type == LDOUBLE);
+}
+
+/*
+ * Set fsz bits at bit offset off in the image to val.
+ */
+static void
+blobset(CONSZ off, int fsz, U_CONSZ val)
+{
+	unsigned char *b;
+	size_t n, o;
+	int i, sh, m;
+
+	n = (size_t)((off + fsz + SZCHAR-1) / SZCHAR);
+	if (n > iblobsz) {
+		o = iblobsz;
+		iblobsz = n < 2*o ? 2*o : n;
+		if ((iblob = realloc(iblob, iblobsz)) == NULL)
+			cerror("out of memory");
+		memset(iblob + o, 0, iblobsz - o);
+	}
+	val &= SZMASK(fsz);
+	b = &iblob[off / SZCHAR];
+	if ((off % SZCHAR) == 0 && (fsz % SZCHAR) == 0) {
+		for (i = 0; i < fsz / SZCHAR; i++)
+#if TARGET_ENDIAN == TARGET_BE
+			b[fsz/SZCHAR-1-i] = (unsigned char)(val >> (i*SZCHAR));
+#else
+			b[i] = (unsigned char)(val >> (i*SZCHAR));
+#endif
+		return;
+	}
+
+	/* bitfield, bit by bit */
+	sh = (int)(off % SZCHAR);
+	for (i = 0; i < fsz; i++, sh++) {
+		if (sh == SZCHAR)
+			sh = 0, b++;
+#if TARGET_ENDIAN == TARGET_BE
+		m = 1 << (SZCHAR-1-sh);
+		if ((val >> (fsz-1-i)) & 1)
+#else
+		m = 1 << sh;
+		if ((val >> i) & 1)
+#endif
+			*b |= m;
+		else
+			*b &= ~m;
+	}
+}
+
+/*
+ * Write the constant p of size fsz to the image at off, as inval()
+ * or infld() would have printed it.
+ */
+static void
+blobval(CONSZ off, int fsz, NODE *p)
+{
+	uint32_t *ufp;
+	int i, nbits;
+
+	if (p->n_op == FCON) {
+		ufp = soft_toush(p->n_scon, p->n_type, &nbits);
+		for (i = 0; i < fsz; i += SZINT)
+			blobset(off + i, SZINT, i < nbits ? ufp[i/SZINT] : 0);
+	} else if (fsz < 0)
+		blobset(off, -fsz, glval(p));
+	else if (p->n_type == BOOL)
+		blobset(off, fsz, glval(p) != 0);
+	else
+		blobset(off, fsz, glval(p));
+}
+
+#define	BLOBAT(i)	((i) < iblobsz ? iblob[i] : 0)
+
+/*
+ * Return the length in bytes of the run of repeated values at byte
+ * a, not passing e, if long enough to be worth compressing.  The
+ * size of the repeated value is returned in *szp.
+ */
+static size_t
+blobrun(size_t a, size_t e, int *szp)
+{
+	size_t n;
+	int sz;
+
+	if (a >= iblobsz) {
+		*szp = 1;
+		return e - a; /* all zero */
+	}
+	for (sz = 1; sz <= 4; sz *= 2) {
+		for (n = a + sz; n < e && BLOBAT(n) == BLOBAT(n - sz); n++)
+			;
+		n -= (n - a) % sz;
+		if (n - a >= BLOBRUN && n - a > (size_t)sz) {
+			*szp = sz;
+			return n - a;
+		}
+	}
+	return 0;
+}
+
+/*
+ * Print out bytes a up to e of the image as a string.
+ */
+static void
+blobascii(size_t a, size_t e)
+{
+	size_t i;
+	int c;
+
+	for (i = a; i < e; i++) {
+		if ((i - a) % BLOBLINE == 0)
+			outstr(i == a ? PRTPREF "\t.ascii \"" :
+			    "\"\n" PRTPREF "\t.ascii \"");
+		c = BLOBAT(i);
+		if (c >= ' ' && c < 0177 && c != '"' && c != '\\') {
+			outchr(c);
+		} else {
+			outchr('\\');
+			outchr('0' + ((c >> 6) & 7));
+			outchr('0' + ((c >> 3) & 7));
+			outchr('0' + (c & 7));
+		}
+	}
+	outstr("\"\n");
+}
+
+/*
+ * Print out the image from bit offset off up to end.
+ * Without an image it is all zero.
+ */
+static void
+blobprint(OFFSZ off, OFFSZ end)
+{
+	size_t a, e, s, n, i;
+	U_CONSZ v;
+	int sz;
+
+	if (end <= off)
+		return;
+	if (iblob == NULL) {
+		zbits(off, end - off);
+		return;
+	}
+	a = s = (size_t)(off / SZCHAR);
+	e = (size_t)(end / SZCHAR);
+	while (a < e) {
+		if ((n = blobrun(a, e, &sz)) == 0) {
+			a++;
+			continue;
+		}
+		if (a > s)
+			blobascii(s, a);
+		for (v = 0, i = 0; i < (size_t)sz; i++)
+#if TARGET_ENDIAN == TARGET_BE
+			v = (v << SZCHAR) | BLOBAT(a + i);
+#else
+			v |= (U_CONSZ)BLOBAT(a + i) << (i * SZCHAR);
+#endif
+		if (v == 0) {
+			printf(PRTPREF "%s " CONFMT "\n", asspace, (CONSZ)n);
+		} else {
+			outstr(PRTPREF "\t.fill ");
+			outnum((CONSZ)(n / sz));
+			outchr(',');
+			outnum(sz);
+			outchr(',');
+			outnum((CONSZ)v);
+			outchr('\n');
+		}
+		a = s = a + n;
+	}
+	if (a > s)
+		blobascii(s, a);
+}
+
+static void
+blobfree(void)
+{
+	free(iblob);
+	iblob = NULL;
+	iblobsz = 0;
+}
+
+/*
+ * Remove the ilist entry at off, if any.
+ */
+static void
+ilremove(CONSZ off)
+{
+	struct llist *ll;
+	struct ilist *il, **ilp;
+
+	if (off >= basesz * numlls)
+		return;
+	ll = setll(off);
+	off -= ll->begsz;
+	for (ilp = &ll->il; (il = *ilp) != NULL && il->off <= off;
+	    ilp = &il->next) {
+		if (il->off == off) {
+			tfree(il->n);
+			*ilp = il->next;
+			break;
+		}
+	}
+}
+#endif
+
 /*
  * Insert the node p with size fsz at position off.
  * Bit fields are already dealt with, so a node of correct type
@@ -639,6 +901,16 @@ nsetval(CONSZ off, int fsz, NODE *p)
 	if (fsz == 0)
 		return;
 
+	if (off >= basesz * numents)
+		numents = (int)(off / basesz) + 1;
+#ifdef BLOBINIT
+	if (isblob(p, fsz)) {
+		blobval(off, fsz, p);
+		ilremove(off);
+		nfree(p);
+		return;
+	}
+#endif
 	ll = setll(off);
 	off -= ll->begsz;
 	if (ll->il == NULL) {
@@ -734,16 +1006,35 @@ scalinit(NODE *p)
 		fsz = (int)tsize(pstk->in_t, pstk->in_sym->sdf,
 		    pstk->in_sym->sap);
 
-	nsetval(woff, fsz, q);
 	if (q->n_op == ICON && q->n_sp &&
 	    ((q->n_sp->sflags & SMASK) == SSTRING))
 		q->n_sp->sflags |= SASG;
+	nsetval(woff, fsz, q);
 
 	stkpop();
 	ID(("scalinit end(%p)\n", q));
 	return woff;
 }
 
+/*
+ * Return a type of size fsz that may be stored at off in csym, or 0.
+ */
+static TWORD
+instype(OFFSZ off, int fsz)
+{
+	int al = talign(csym->stype, csym->sap);
+
+	if (fsz == SZCHAR && (off % ALCHAR) == 0)
+		return CHAR;
+	if (fsz == SZSHORT && (off % ALSHORT) == 0 && al >= ALSHORT)
+		return SHORT;
+	if (fsz == SZINT && (off % ALINT) == 0 && al >= ALINT)
+		return INT;
+	if (fsz == SZLONGLONG && (off % ALLONGLONG) == 0 && al >= ALLONGLONG)
+		return ctype(LONGLONG);
+	return 0;
+}
+
 /*
  * Generate code to insert a value into a bitfield.
  */
@@ -762,10 +1053,8 @@ insbf(OFFSZ off, int fsz, int val)
 	if (fsz == 0)
 		return;
 
-	/* small opt: do char instead of bf asg */
-	if ((off & (ALCHAR-1)) == 0 && fsz == SZCHAR)
-		typ = CHAR;
-	else
+	/* small opt: do a plain store instead of bf asg */
+	if ((typ = instype(off, fsz)) == 0)
 		typ = INT;
 	/* Fake a struct reference */
 	p = buildtree(ADDROF, nametree(csym), NIL);
@@ -774,7 +1063,7 @@ insbf(OFFSZ off, int fsz, int val)
 	sym.sdf = 0;
 	sym.sap = NULL;
 	sym.soffset = (int)off;
-	sym.sclass = (char)(typ == INT ? FIELD | fsz : MOU);
+	sym.sclass = (char)(instype(off, fsz) == 0 ? FIELD | fsz : MOU);
 	r = xbcon(0, &sym, typ);
 	p = block(STREF, p, r, INT, 0, 0);
 	ecomp(buildtree(ASSIGN, stref(p), bcon(val)));
@@ -786,6 +1075,8 @@ insbf(OFFSZ off, int fsz, int val)
 static void
 clearbf(OFFSZ off, OFFSZ fsz)
 {
+	int sz;
+
 	/* Pad up to the next even initializer */
 	if ((off & (ALCHAR-1)) || (fsz < SZCHAR)) {
 		int ba = (int)(((off + (SZCHAR-1)) & ~(SZCHAR-1)) - off);
@@ -796,14 +1087,189 @@ clearbf(OFFSZ off, OFFSZ fsz)
 		fsz -= ba;
 	}
 	while (fsz >= SZCHAR) {
-		insbf(off, SZCHAR, 0);
-		off += SZCHAR;
-		fsz -= SZCHAR;
+		/* use the widest aligned store */
+		if (fsz >= SZLONGLONG && instype(off, SZLONGLONG))
+			sz = SZLONGLONG;
+		else if (fsz >= SZINT && instype(off, SZINT))
+			sz = SZINT;
+		else if (fsz >= SZSHORT && instype(off, SZSHORT))
+			sz = SZSHORT;
+		else
+			sz = SZCHAR;
+		insbf(off, sz, 0);
+		off += sz;
+		fsz -= sz;
 	}
 	if (fsz)
 		insbf(off, fsz, 0);
 }
 
+#define	AI_STORE	0	/* move each element */
+#define	AI_COPY		1	/* copy from template, move the rest */
+#define	AI_ZERO		2	/* copy from zero block, move the rest */
+#define	AIMIN		(16*SZINT)	/* smallest size to block copy */
+
+static struct symtab *zblk;	/* zero block, see zblkprint() */
+
+/*
+ * Check if an initializer can be laid out in readonly memory.
+ */
+static int
+iscon(struct ilist *il)
+{
+	NODE *p = il->n;
+
+	if (p->n_op == ICON && p->n_sp == NULL)
+		return 1;
+	return p->n_op == FCON && il->fsz > 0;
+}
+
+/*
+ * Check if an initializer is zero.
+ */
+static int
+iszero(struct ilist *il)
+{
+	return il->n->n_op == ICON && il->n->n_sp == NULL && glval(il->n) == 0;
+}
+
+/*
+ * Decide how to initialize the automatic aggregate csym of size tbit.
+ */
+static int
+autoinit(OFFSZ tbit)
+{
+	struct llist *ll;
+	struct ilist *il;
+	OFFSZ cbits, vbits;
+
+	if (tbit < AIMIN || nerrors)
+		return AI_STORE;
+	cbits = vbits = 0;
+	SLIST_FOREACH(ll, &lpole, next) {
+		for (il = ll->il; il; il = il->next) {
+			if (!iscon(il))
+				vbits += il->fsz < 0 ? -il->fsz : il->fsz;
+			else if (!iszero(il))
+				cbits += il->fsz < 0 ? -il->fsz : il->fsz;
+		}
+	}
+	if ((cbits + vbits) * 2 <= tbit)
+		return AI_ZERO;
+	if (cbits >= vbits)
+		return AI_COPY;
+	return AI_STORE;
+}
+
+/*
+ * Write the constant elements of csym to a template in readonly memory.
+ */
+static struct symtab *
+tmplinit(OFFSZ tbit)
+{
+	struct symtab *sp;
+	struct llist *ll;
+	struct ilist *il;
+#ifndef BLOBINIT
+	OFFSZ lastoff;
+	int fsz;
+#endif
+
+	sp = getsymtab(csym->sname, STEMP);
+	sp->stype = csym->stype;
+	sp->sdf = csym->sdf;
+	sp->sap = csym->sap;
+	sp->sclass = STATIC;
+	sp->slevel = (char)blevel;
+	sp->soffset = getlab();
+	locctr(RDATA, sp);
+	defloc(sp);
+
+#ifdef BLOBINIT
+	/* non-constants are left as zero */
+	SLIST_FOREACH(ll, &lpole, next)
+		for (il = ll->il; il; il = il->next)
+			if (iscon(il))
+				blobval(ll->begsz + il->off, il->fsz, il->n);
+	blobprint(0, tbit);
+	blobfree();
+#else
+	lastoff = 0;
+	SLIST_FOREACH(ll, &lpole, next) {
+		for (il = ll->il; il; il = il->next) {
+			if (!iscon(il))
+				continue; /* left as zero */
+			if (ll->begsz + il->off > lastoff)
+				zbits(lastoff, (ll->begsz + il->off) - lastoff);
+			fsz = il->fsz;
+			if (fsz < 0) {
+				fsz = -fsz;
+				infld(il->off, fsz, glval(il->n));
+			} else
+				inval(il->off, fsz, il->n);
+			lastoff = ll->begsz + il->off + fsz;
+		}
+	}
+	zbits(lastoff, tbit-lastoff);
+#endif
+	return sp;
+}
+
+/*
+ * Get the zero block, big enough for csym.
+ */
+static struct symtab *
+zeroblk(OFFSZ tbit)
+{
+	struct attr *ap;
+	int al;
+
+	if (zblk == NULL) {
+		zblk = getsymtab("zero", SNORMAL);
+		zblk->stype = ARY+CHAR;
+		zblk->sdf = permalloc(sizeof(union dimfun));
+		zblk->sdf->ddim = 0;
+		zblk->sap = attr_new(ATTR_ALIGNED, 1);
+		zblk->sap->iarg(0) = ALCHAR;
+		zblk->sclass = STATIC;
+		zblk->slevel = 1;
+		zblk->soffset = getlab();
+	}
+	if (zblk->sdf->ddim < (tbit + SZCHAR - 1) / SZCHAR)
+		zblk->sdf->ddim = (int)((tbit + SZCHAR - 1) / SZCHAR);
+	ap = zblk->sap;
+	if ((al = talign(csym->stype, csym->sap)) > ap->iarg(0))
+		ap->iarg(0) = al;
+	return zblk;
+}
+
+/*
+ * Print out the zero block, if used.
+ */
+void
+zblkprint(void)
+{
+	if (zblk != NULL)
+		defzero(zblk);
+}
+
+/*
+ * Copy sp, which has the same type as csym, to csym.
+ */
+static void
+blkinit(struct symtab *sp)
+{
+	NODE *p, *q;
+
+	q = nametree(sp);
+	q->n_type = csym->stype;
+	q->n_df = csym->sdf;
+	q->n_ap = csym->sap;
+	q = block(ADDROF, q, NIL, INCREF(csym->stype), csym->sdf, csym->sap);
+	p = block(STASG, nametree(csym), q, csym->stype, csym->sdf, csym->sap);
+	ecomp(clocal(p));
+}
+
 /*
  * final step of initialization.
  * print out init nodes and generate copy code (if needed).
@@ -813,7 +1279,7 @@ endinit(int seg)
 {
 	struct llist *ll;
 	struct ilist *il;
-	int fsz;
+	int fsz, how;
 	OFFSZ lastoff, tbit;
 
 	ID(("endinit()\n"));
@@ -830,10 +1296,14 @@ endinit(int seg)
 		tbit = tsize(csym->stype, csym->sdf, csym->sap);
 
 	/* Setup symbols */
+	how = AI_STORE;
 	if (csym->sclass != AUTO) {
 		locctr(seg ? UDATA : DATA, csym);
 		defloc(csym);
-	}
+	} else if ((how = autoinit(tbit)) == AI_COPY)
+		blkinit(tmplinit(tbit));
+	else if (how == AI_ZERO)
+		blkinit(zeroblk(tbit));
 
 	/* Traverse all entries and print'em out */
 	lastoff = 0;
@@ -848,11 +1318,18 @@ endinit(int seg)
 			}
 #endif
 			fsz = il->fsz;
-			if (csym->sclass == AUTO) {
+			if (csym->sclass == AUTO && how != AI_STORE &&
+			    (how == AI_COPY ? iscon(il) : iszero(il))) {
+				/* already there */
+				tfree(il->n);
+				if (fsz < 0)
+					fsz = -fsz;
+			} else if (csym->sclass == AUTO) {
 				struct symtab sym;
 				NODE *p, *r, *n;
 
-				if (ll->begsz + il->off > lastoff)
+				if (how == AI_STORE &&
+				    ll->begsz + il->off > lastoff)
 					clearbf(lastoff,
 					    (ll->begsz + il->off) - lastoff);
 
@@ -872,9 +1349,13 @@ endinit(int seg)
 					fsz = -fsz;
 
 			} else {
+#ifdef BLOBINIT
+				blobprint(lastoff, ll->begsz + il->off);
+#else
 				if (ll->begsz + il->off > lastoff)
 					zbits(lastoff,
 					    (ll->begsz + il->off) - lastoff);
+#endif
 				if (fsz < 0) {
 					fsz = -fsz;
 					infld(il->off, fsz, glval(il->n));
@@ -886,10 +1367,17 @@ endinit(int seg)
 		}
 	}
 	if (csym->sclass == AUTO) {
-		clearbf(lastoff, tbit-lastoff);
-	} else
+		if (how == AI_STORE)
+			clearbf(lastoff, tbit-lastoff);
+	} else {
+#ifdef BLOBINIT
+		blobprint(lastoff, tbit);
+		blobfree();
+#else
 		zbits(lastoff, tbit-lastoff);
-	
+#endif
+	}
+
 	doing_init--;
 	if (csym->sclass == STATIC || csym->sclass == EXTDEF)
 		statinit--;
@@ -908,8 +1396,14 @@ endictx(void)
 	pstk = ict->pstk;
 	csym = ict->psym;
 	lpole = ict->lpole;
+	lastll = ict->lastll;
 	basesz = ict->basesz;
 	numents = ict->numents;
+	numlls = ict->numlls;
+#ifdef BLOBINIT
+	iblob = ict->iblob;
+	iblobsz = ict->iblobsz;
+#endif
 	inilnk = inilnk->prev;
 #ifdef PCC_DEBUG
 	if (idebug)
@@ -1076,8 +1570,9 @@ static void
 strcvt(NODE *p)
 {
 	NODE *q = p;
-	char *s;
-	int i;
+	unsigned int cp[64];
+	char *s, *e;
+	int i, n;
 
 #ifdef mach_arm
 	/* XXX */
@@ -1085,15 +1580,21 @@ strcvt(NODE *p)
 		p = p->n_left->n_left;
 #endif
 
-	for (s = p->n_sp->sname; *s != 0; ) {
-		if (p->n_type == ARY+WCHAR_TYPE)
-			i = (int)u82cp(&s);
-		else if (*s == '\\')
-			i = esccon(&s);
-		else
-			i = (unsigned char)*s++;
-		asginit(bcon(i));
-	} 
+	s = p->n_sp->sname;
+	if (p->n_type == ARY+WCHAR_TYPE) {
+		e = s + strlen(s);
+		while ((n = u82u32(&s, e, cp, 64)) > 0)
+			for (i = 0; i < n; i++)
+				asginit(bcon((int)cp[i]));
+	} else {
+		while (*s != 0) {
+			if (*s == '\\')
+				i = esccon(&s);
+			else
+				i = (unsigned char)*s++;
+			asginit(bcon(i));
+		}
+	}
 	tfree(q);
 }
 
@@ -36,6 +36,7 @@
  * If it has the keyword "static" it will be written out if it is referenced.
  * inlining will only be done if -xinline is given, and only if it is 
  * possible to inline the function.
+ * Functions from other objects may also be inlined, see -flto below.
  */
 static void printip(struct interpass *pole);
 
@@ -46,24 +47,62 @@ struct ntds {
 	struct attr *attr;
 };
 
+/*
+ * Functions referenced from a function, for -flto-write.
+ */
+struct ltoref {
+	char *name;
+	int kind;
+#define	LR_CALL		0	/* direct call */
+#define	LR_ADDR		1	/* any other reference */
+#define	LR_LOCAL	2	/* static function */
+};
+
 /*
  * ilink from ipole points to the next struct in the list of functions.
+ * The struct is also found through sp->sinl, and rnext links the
+ * functions that are referenced but not yet written out.
  */
 static struct istat {
 	SLIST_ENTRY(istat) link;
+	struct istat *rnext;
 	struct symtab *sp;
+	int seq;	/* position on ipole, higher is newer */
 	int flags;
 #define	CANINL	1	/* function is possible to inline */
 #define	WRITTEN	2	/* function is written out */
 #define	REFD	4	/* Referenced but not yet written out */
+#define	SAVED	8	/* not inline, saved for -flto */
+#define	LOCREF	16	/* references file-local symbols */
+#define	CALLS	32	/* function is not a leaf */
+#define	QUEUED	64	/* on the refq list */
 	struct ntds *nt;/* Array of arg temp type data */
 	int nargs;	/* number of args in array */
 	int retval;	/* number of return temporary, if any */
+	int nodes;	/* size of saved trees, for -finline-functions */
 	struct interpass shead;
-} *cifun;
+	struct ltoref *refs;	/* functions referenced */
+	int nrefs, szrefs;
+} *cifun, ltoglob;
 
 static SLIST_HEAD(, istat) ipole = { NULL, &ipole.q_forw };
-static int nlabs, svclass;
+static struct istat *refq;	/* to write out, sorted on seq, newest first */
+static int nlabs, svclass, nseq;
+
+/*
+ * Cost model for -finline-functions.  Sizes are counted in nodes.
+ * Functions not declared inline are inlined if they are small, or
+ * leaves that are not much bigger, as long as neither the caller
+ * nor the translation unit grows too much.  With -fprofile-use,
+ * callers that never ran get nothing and hot callers twice as much.
+ */
+#define	INLSMALL	30	/* max size of any auto-inlined function */
+#define	INLLEAF		60	/* max size of an auto-inlined leaf */
+#define	INLCALLER	200	/* max growth of a single caller */
+#define	INLUNIT		1000	/* base growth of the translation unit */
+static int savnodes;	/* total size of saved functions */
+static int callgrowth, unitgrowth;
+static struct symtab *growsp;	/* function callgrowth belongs to */
 
 #define	IP_REF	(MAXIP+1)
 #ifdef PCC_DEBUG
@@ -74,6 +113,11 @@ static int nlabs, svclass;
 
 int isinlining;
 int inlstatcnt;
+int ltomode, ltowhole;
+char *ltoout;
+
+static void lto_addref(struct istat *, struct symtab *, int);
+static struct istat *lto_find(struct symtab *);
 
 #define	SZSI	sizeof(struct istat)
 int istatsz = SZSI;
@@ -97,14 +141,60 @@ getprol(struct istat *is, int type)
 static struct istat *
 findfun(struct symtab *sp)
 {
-	struct istat *is;
+	struct istat *is = sp->sinl;
 
-	SLIST_FOREACH(is, &ipole, link)
-		if (is->sp == sp)
-			return is;
+	/* copies of the symtab entry may carry the pointer */
+	if (is != NULL && is->sp == sp)
+		return is;
 	return NULL;
 }
 
+static struct istat *
+newfun(struct symtab *sp)
+{
+	struct istat *is;
+
+	is = ialloc();
+	is->sp = sp;
+	is->seq = ++nseq;
+	sp->sinl = is;
+	SLIST_INSERT_FIRST(&ipole, is, link);
+	DLIST_INIT(&is->shead, qelem);
+	return is;
+}
+
+/*
+ * Put a defined function on the list to write out.  The list is kept
+ * in ipole order so that functions are written in the same order as
+ * if ipole was searched.
+ */
+static void
+enqueue(struct istat *is)
+{
+	struct istat **pp;
+
+	if (is->flags & (WRITTEN|QUEUED))
+		return;
+	for (pp = &refq; *pp != NULL && (*pp)->seq > is->seq;
+	    pp = &(*pp)->rnext)
+		;
+	is->rnext = *pp;
+	*pp = is;
+	is->flags |= QUEUED;
+}
+
+/*
+ * Mark a function referenced.  If not yet defined it is queued by
+ * inline_end().
+ */
+static void
+setrefd(struct istat *is)
+{
+	is->flags |= REFD;
+	if (is->sp != NULL && !DLIST_ISEMPTY(&is->shead, qelem))
+		enqueue(is);
+}
+
 static void
 refnode(struct symtab *sp)
 {
@@ -141,9 +231,12 @@ intcopy(NODE *p)
 	int o = coptype(p->n_op); /* XXX pass2 optype? */
 
 	*q = *p;
+	cifun->nodes++;
+	if (cdope(p->n_op) & CALLFLG)
+		cifun->flags |= CALLS;
 	if (nlabs > 1 && (p->n_op == REG || p->n_op == OREG) &&
 	    regno(p) == FPREG)
-		SLIST_FIRST(&ipole)->flags &= ~CANINL; /* no stack refs */
+		cifun->flags &= ~CANINL; /* no stack refs */
 	if (q->n_ap)
 		q->n_ap = inapcopy(q->n_ap);
 	if (q->n_op == NAME || q->n_op == ICON ||
@@ -184,6 +277,18 @@ inline_addarg(struct interpass *ip)
 		break;
 	case IP_EPILOG:
 		ipp = (struct interpass_prolog *)ip;
+		if (ipp->ip_labels[0] && (cifun->flags & SAVED)) {
+			int i, *lp;
+
+			/* keep them, labels are not renumbered in puto() */
+			for (i = 0; ipp->ip_labels[i]; i++)
+				;
+			lp = permalloc(sizeof(int) * (i+1));
+			ipp->ip_labels = memcpy(lp, ipp->ip_labels,
+			    sizeof(int) * (i+1));
+			cifun->flags |= LOCREF;
+			break;
+		}
 		if (ipp->ip_labels[0])
 			uerror("no computed goto in inlined functions");
 		ipp->ip_labels = &g;
@@ -210,12 +315,8 @@ inline_start(struct symtab *sp, int class)
 	if ((is = findfun(sp)) != 0) {
 		if (!DLIST_ISEMPTY(&is->shead, qelem))
 			uerror("inline function already defined");
-	} else {
-		is = ialloc();
-		is->sp = sp;
-		SLIST_INSERT_FIRST(&ipole, is, link);
-		DLIST_INIT(&is->shead, qelem);
-	}
+	} else
+		is = newfun(sp);
 	cifun = is;
 	nlabs = 0;
 	isinlining++;
@@ -253,6 +354,14 @@ inline_end(void)
 	if (sdebug)printip(&cifun->shead);
 	isinlining = 0;
 
+	if (cifun->flags & REFD)
+		enqueue(cifun); /* referenced before defined */
+
+	if (cifun->flags & SAVED) {
+		savnodes += cifun->nodes;
+		return; /* written out when referenced */
+	}
+
 	if (xgnu89 && svclass == SNULL)
 		sp->sclass = EXTERN;
 
@@ -267,7 +376,7 @@ inline_end(void)
 #endif
 
 	if (sp->sclass == EXTDEF) {
-		cifun->flags |= REFD;
+		setrefd(cifun);
 		inline_prtout();
 	}
 }
@@ -285,21 +394,16 @@ inline_ref(struct symtab *sp)
 	SDEBUG(("inline_ref(\"%s\")\n", sp->sname));
 	if (sp->sclass == SNULL)
 		return; /* only inline, no references */
-	if (isinlining) {
+	if (ltomode == LTO_WRITE)
+		lto_addref(isinlining && !statinit ? cifun : NULL, sp, LR_ADDR);
+	if (isinlining && !statinit) {
+		/* static initializers are written out directly */
 		refnode(sp);
 	} else {
-		SLIST_FOREACH(w,&ipole, link) {
-			if (w->sp != sp)
-				continue;
-			w->flags |= REFD;
-			return;
-		}
-		/* function not yet defined, print out when found */
-		w = ialloc();
-		w->sp = sp;
-		w->flags |= REFD;
-		SLIST_INSERT_FIRST(&ipole, w, link);
-		DLIST_INIT(&w->shead, qelem);
+		/* if not yet defined, print out when found */
+		if ((w = findfun(sp)) == NULL)
+			w = newfun(sp);
+		setrefd(w);
 	}
 }
 
@@ -317,7 +421,14 @@ puto(struct istat *w)
 		switch (ip->type) {
 		case IP_EPILOG:
 		case IP_PROLOG:
-			if (ip->type == IP_PROLOG) {
+			/*
+			 * Saved functions are only written out once and
+			 * keep their labels, inline functions get new ones.
+			 */
+			if (w->flags & SAVED) {
+				if (ip->type == IP_PROLOG)
+					ipp = (struct interpass_prolog *)ip;
+			} else if (ip->type == IP_PROLOG) {
 				ipp = (struct interpass_prolog *)ip;
 				/* fix label offsets */
 				lbloff = crslab - ipp->ip_lblnum;
@@ -329,7 +440,8 @@ puto(struct istat *w)
 			memcpy(pp, ip, sizeof(struct interpass_prolog));
 			pp->ip_lblnum += lbloff;
 #ifdef PCC_DEBUG
-			if (ip->type == IP_EPILOG && crslab != pp->ip_lblnum)
+			if (ip->type == IP_EPILOG && (w->flags & SAVED) == 0 &&
+			    crslab != pp->ip_lblnum)
 				cerror("puto: %d != %d", crslab, pp->ip_lblnum);
 #endif
 			pass2_compile((struct interpass *)pp);
@@ -367,18 +479,29 @@ puto(struct istat *w)
 void
 inline_prtout(void)
 {
-	struct istat *w;
+	struct istat *w, **pp;
 	int gotone = 0;
 
-	SLIST_FOREACH(w, &ipole, link) {
-		if ((w->flags & (REFD|WRITTEN)) == REFD &&
-		    !DLIST_ISEMPTY(&w->shead, qelem)) {
-			locctr(PROG, w->sp);
-			defloc(w->sp);
-			puto(w);
-			w->flags |= WRITTEN;
-			gotone++;
-		}
+	if (ltomode == LTO_WRITE)
+		return; /* only the summary is wanted */
+	/*
+	 * Functions referenced while writing are queued behind w if
+	 * older, and otherwise written in the next round.
+	 */
+	for (w = refq; w != NULL; w = w->rnext) {
+		if (w->flags & WRITTEN)
+			continue;
+		locctr(PROG, w->sp);
+		defloc(w->sp);
+		puto(w);
+		w->flags |= WRITTEN;
+		gotone++;
+	}
+	for (pp = &refq; (w = *pp) != NULL; ) {
+		if (w->flags & WRITTEN)
+			*pp = w->rnext;
+		else
+			pp = &w->rnext;
 	}
 	if (gotone)
 		inline_prtout();
@@ -430,24 +553,37 @@ printip(struct interpass *pole)
 }
 #endif
 
-static int toff;
+static int toff, timport;
+
+/*
+ * Get the temporary for an argument.  Functions from -flto-read
+ * only know the argument types, the rest is taken from the
+ * argument itself.  Mismatched pointers are left as they are.
+ */
+static P1ND *
+argtemp(struct ntds *nt, P1ND *a)
+{
+	int num = nt->temp + toff;
+
+	if (timport && (a->n_type == nt->type || ISPTR(nt->type)))
+		return tempnode(num, a->n_type, a->n_df, a->n_ap);
+	return tempnode(num, nt->type, nt->df, nt->attr);
+}
 
 static P1ND *
 mnode(struct ntds *nt, P1ND *p)
 {
 	P1ND *q;
-	int num = nt->temp + toff;
 
 	if (p->n_op == CM) {
-		q = p->n_right;
-		q = tempnode(num, nt->type, nt->df, nt->attr);
+		q = argtemp(nt, p->n_right);
 		nt--;
 		p->n_right = buildtree(ASSIGN, q, p->n_right);
 		p->n_left = mnode(nt, p->n_left);
 		p->n_op = COMOP;
 	} else {
 		p = pconvert(p);
-		q = tempnode(num, nt->type, nt->df, nt->attr);
+		q = argtemp(nt, p);
 		p = buildtree(ASSIGN, q, p);
 	}
 	return p;
@@ -460,6 +596,29 @@ rtmps(NODE *p, void *arg)
 		regno(p) += toff;
 }
 
+/*
+ * Decide whether a function not declared inline is worth inlining.
+ */
+static int
+inline_cost(struct istat *is)
+{
+	int m = profheat == PROF_HOT ? 2 : 1;
+
+	if (profheat == PROF_COLD)
+		return 0;
+	if (is->nodes > m * ((is->flags & CALLS) ? INLSMALL : INLLEAF))
+		return 0;
+	if (growsp != cftnsp) {
+		growsp = cftnsp;
+		callgrowth = 0;
+	}
+	if (callgrowth + is->nodes > m * INLCALLER)
+		return 0;
+	if (unitgrowth + is->nodes > INLUNIT + savnodes/4)
+		return 0;
+	return 1;
+}
+
 /*
  * Inline a function. Returns the return value.
  * There are two major things that must be converted when 
@@ -474,13 +633,18 @@ P1ND *
 inlinetree(struct symtab *sp, P1ND *f, P1ND *ap)
 {
 	extern int crslab, tvaloff;
-	struct istat *is = findfun(sp);
+	struct istat *is;
 	struct interpass *ip, *ipf, *ipl;
 	struct interpass_prolog *ipp, *ipe;
-	int lmin, l0, l1, l2, gainl, n;
+	int lmin, l0, l1, l2, gainl, autoinl, n;
 	NODE *pp;
 	P1ND *p, *rp;
 
+	/* functions from -flto-read take precedence */
+	if ((is = lto_find(sp)) == NULL)
+		is = findfun(sp);
+	timport = is != NULL && is->sp == NULL;
+
 	if (is == NULL || nerrors) {
 		inline_ref(sp); /* prototype of not yet declared inline ftn */
 		return NULL;
@@ -499,12 +663,24 @@ inlinetree(struct symtab *sp, P1ND *f, P1ND *ap)
 		werror("cannot inline but always_inline");
 	nerrors = n;
 
-	if ((is->flags & CANINL) == 0 || (xinline == 0 && gainl == 0)) {
-		if (is->sp->sclass == STATIC || is->sp->sclass == USTATIC)
+	autoinl = inlfuncs && timport == 0 && (sp->sflags & SINLINE) == 0;
+	if ((is->flags & CANINL) == 0 ||
+	    (autoinl && gainl == 0 && inline_cost(is) == 0) ||
+	    (autoinl == 0 && xinline == 0 && gainl == 0 && timport == 0)) {
+		if (sp->sclass == STATIC || sp->sclass == USTATIC)
 			inline_ref(sp);
 		return NULL;
 	}
 
+	if (timport) {
+		for (n = ap != NULL, p = ap; p && p->n_op == CM; p = p->n_left)
+			n++;
+		if (cftnsp == sp || n != is->nargs) {
+			inline_ref(sp);
+			return NULL;
+		}
+	}
+
 	if (isinlining && cifun->sp == sp) {
 		/* Do not try to inline ourselves */
 		inline_ref(sp);
@@ -513,11 +689,16 @@ inlinetree(struct symtab *sp, P1ND *f, P1ND *ap)
 
 #ifdef mach_i386
 	if (kflag) {
-		is->flags |= REFD; /* if static inline, emit */
+		setrefd(is); /* if static inline, emit */
 		return NULL; /* XXX cannot handle hidden ebx arg */
 	}
 #endif
 
+	if (autoinl) {
+		callgrowth += is->nodes;
+		unitgrowth += is->nodes;
+	}
+
 	/* emit jumps to surround inline function */
 	branch(l0 = getlab());
 	plabel(l1 = getlab());
@@ -665,3 +846,811 @@ inline_args(struct symtab **sp, int nargs)
 	cf->nargs = nargs;
 	cf->flags |= CANINL;
 }
+
+/*
+ * Link-time inlining.
+ *
+ * With -flto-write all functions are saved as if they were inline
+ * and nothing is written out; instead a summary is written, holding
+ * the functions referenced by each function and the bodies of small
+ * extern functions, followed by the source itself.
+ *
+ * With -flto-read the summaries of all objects in the link are read,
+ * the source is compiled again and calls to functions with a body
+ * in a summary are inlined.  Static functions are saved and only
+ * written out if referenced, and with -fwhole-program so are extern
+ * functions that are not needed anywhere in the program.
+ */
+#define	LF_EXTERN	1	/* external linkage */
+#define	LF_ROOT		2	/* always needed */
+#define	LF_BODY		4	/* body follows, always inlined */
+#define	LF_NEEDED	8	/* must be written out, only when read */
+
+#define	LTOMAXNODES	100	/* max number of nodes in a body */
+
+struct ltofun {
+	struct ltofun *next;	/* hash chain */
+	struct ltofun *lnext;	/* list of all functions */
+	struct ltofun *wnext;	/* work list, when finding needed */
+	char *name;
+	int tu;			/* object it was read from */
+	int flags;
+	struct ltoref *refs;
+	int nrefs;
+	struct istat *is;	/* body, if any */
+};
+
+#define	LTOHASHSZ	1024
+static struct ltofun *ltohash[LTOHASHSZ], *ltoall, *ltowork;
+
+/*
+ * External names referenced from the bodies read in.  A file-local
+ * symbol with one of these names is given a label as its output
+ * name, or the inlined code would bind to it instead.
+ */
+struct ltoname {
+	struct ltoname *next;
+	char *name;
+	char *local;		/* output name of the local symbol */
+};
+static struct ltoname *ltonames[LTOHASHSZ];
+static char **ltofiles;
+static int nltofiles;
+
+static struct ltofun *lto_lookup(int, char *);
+static struct ltoname *lto_extname(char *);
+static int lto_hash(char *);
+
+static unsigned char *lb, *lp, *lpe;
+static int lblen, lbsz;
+
+/*
+ * Functions that are needed even if never referenced.
+ */
+static int
+lto_root(struct symtab *sp)
+{
+	if (strcmp(sp->sname, "main") == 0)
+		return 1;
+#ifdef GCC_COMPAT
+	if (attr_find(sp->sap, GCC_ATYP_CONSTRUCTOR) ||
+	    attr_find(sp->sap, GCC_ATYP_DESTRUCTOR) ||
+	    attr_find(sp->sap, GCC_ATYP_USED) ||
+	    attr_find(sp->sap, GCC_ATYP_WEAK) ||
+	    attr_find(sp->sap, GCC_ATYP_ALIASWEAK))
+		return 1;
+#endif
+	return 0;
+}
+
+static void
+lto_addname(struct istat *is, char *name, int kind)
+{
+	int i;
+
+	for (i = 0; i < is->nrefs; i++) {
+		if (strcmp(is->refs[i].name, name) == 0) {
+			is->refs[i].kind |= kind;
+			return;
+		}
+	}
+	if (is->nrefs == is->szrefs) {
+		is->szrefs = is->szrefs ? is->szrefs * 2 : 8;
+		is->refs = realloc(is->refs, is->szrefs * sizeof(struct ltoref));
+		if (is->refs == NULL)
+			cerror("out of memory!");
+	}
+	is->refs[is->nrefs].name = name;
+	is->refs[is->nrefs++].kind = kind;
+}
+
+/*
+ * Remember that sp is referenced from is, or outside functions.
+ */
+static void
+lto_addref(struct istat *is, struct symtab *sp, int kind)
+{
+	if (sp->sclass == STATIC || sp->sclass == USTATIC)
+		kind |= LR_LOCAL;
+	lto_addname(is ? is : &ltoglob, getexname(sp), kind);
+}
+
+/*
+ * A function is called directly, with a prototype in scope or not.
+ * Returns 1 if there is a body from -flto-read to inline.
+ */
+int
+lto_call(struct symtab *sp, int proto)
+{
+	if (ltomode == LTO_WRITE) {
+		lto_addref(isinlining ? cifun : NULL, sp,
+		    proto ? LR_CALL : LR_ADDR);
+		return 0;
+	}
+	if (proto && lto_find(sp) != NULL)
+		return 1;
+	if ((sp->sflags & SINLINE) == 0)
+		inline_ref(sp); /* may be saved */
+	return 0;
+}
+
+/*
+ * A symbol is aliased to name, which must be kept.
+ */
+void
+lto_alias(char *name)
+{
+	if (ltomode == LTO_WRITE)
+		lto_addname(&ltoglob, name, LR_ADDR);
+}
+
+/*
+ * The function being saved refers to something file-local.
+ */
+void
+inline_local(void)
+{
+	cifun->flags |= LOCREF;
+}
+
+/*
+ * Start of a function that is not inline.  Save it if it may
+ * turn out to be unused or may be inlined by -finline-functions,
+ * or always if writing a summary.
+ */
+void
+inline_save(struct symtab *sp)
+{
+	struct ltofun *lf;
+	int refd = 0;
+
+	if (ltomode != LTO_WRITE) {
+		if (lto_root(sp))
+			return;
+		if (sp->sclass == STATIC) {
+			if (gflag)
+				return; /* debug info must follow */
+		} else if (ltomode == LTO_READ && ltowhole &&
+		    (lf = lto_lookup(-1, getexname(sp))) != NULL &&
+		    (lf->flags & LF_NEEDED) == 0) {
+			; /* only written if referenced */
+		} else if (inlfuncs && gflag == 0) {
+			refd = 1; /* always written */
+		} else
+			return;
+	}
+	inline_start(sp, sp->sclass);
+	cifun->flags |= SAVED;
+	if (refd)
+		cifun->flags |= REFD;
+}
+
+static void
+lto_byte(int c)
+{
+	if (lblen == lbsz) {
+		lbsz = lbsz ? lbsz * 2 : 1024;
+		if ((lb = realloc(lb, lbsz)) == NULL)
+			cerror("out of memory!");
+	}
+	lb[lblen++] = c;
+}
+
+static void
+lto_uint(U_CONSZ u)
+{
+	while (u >= 0x80) {
+		lto_byte((int)(u & 0x7f) | 0x80);
+		u >>= 7;
+	}
+	lto_byte((int)u);
+}
+
+static void
+lto_vint(CONSZ v)
+{
+	lto_uint(((U_CONSZ)v << 1) ^ (U_CONSZ)(v < 0 ? -1 : 0));
+}
+
+static void
+lto_str(char *s)
+{
+	int l = (int)strlen(s);
+
+	lto_uint(l);
+	while (l-- > 0)
+		lto_byte(*s++);
+}
+
+static void
+lto_hdr(FILE *fp, int tag, U_CONSZ u)
+{
+	putc(tag, fp);
+	while (u >= 0x80) {
+		putc((int)(u & 0x7f) | 0x80, fp);
+		u >>= 7;
+	}
+	putc((int)u, fp);
+}
+
+static void
+lto_record(FILE *fp, int tag)
+{
+	lto_hdr(fp, tag, lblen);
+	fwrite(lb, 1, lblen, fp);
+	lblen = 0;
+}
+
+/*
+ * Write a tree, same fields as p2bnode().
+ */
+static int
+lto_wnode(NODE *p)
+{
+	struct attr *ap;
+	int ty, i, n;
+
+	ty = coptype(p->n_op);
+	lto_uint(p->n_op);
+	lto_uint(p->n_type);
+	lto_uint(p->n_qual);
+	if (ty == LTYPE)
+		lto_vint(glval(p));
+	if (p->n_op == NAME || p->n_op == ICON)
+		lto_str(p->n_name);
+	else if (ty != BITYPE)
+		lto_vint(p->n_rval);
+	if (p->n_op == XASM || p->n_op == XARG)
+		lto_str(p->n_name);
+	for (i = 0, ap = p->n_ap; ap; ap = ap->next)
+		i++;
+	lto_uint(i);
+	for (ap = p->n_ap; ap; ap = ap->next) {
+		lto_uint(ap->atype);
+		lto_uint(ap->sz);
+		for (i = 0; i < ap->sz; i++)
+			lto_vint(ap->iarg(i));
+	}
+	n = 1;
+	if (ty != LTYPE)
+		n += lto_wnode(p->n_left);
+	if (ty == BITYPE)
+		n += lto_wnode(p->n_right);
+	return n;
+}
+
+static void
+lto_wrefs(struct istat *is)
+{
+	int i;
+
+	lto_uint(is->nrefs);
+	for (i = 0; i < is->nrefs; i++) {
+		lto_str(is->refs[i].name);
+		lto_uint(is->refs[i].kind);
+	}
+}
+
+/*
+ * Can this function be inlined in any other object?
+ */
+static int
+lto_canimport(struct istat *is)
+{
+	struct symtab *sp = is->sp;
+	TWORD t;
+	int i;
+
+	if ((is->flags & (CANINL|LOCREF)) != CANINL || sp->sclass != EXTDEF)
+		return 0;
+	if (ISSOU(DECREF(sp->stype)))
+		return 0;
+#ifdef GCC_COMPAT
+	if (attr_find(sp->sap, GCC_ATYP_NOINLINE) ||
+	    attr_find(sp->sap, GCC_ATYP_WEAK) ||
+	    attr_find(sp->sap, GCC_ATYP_ALIASWEAK))
+		return 0;
+#endif
+	for (i = 0; i < is->nargs; i++) {
+		t = is->nt[i].type;
+		if (!ISPTR(t) && (t > BTMASK || ISSOU(t)))
+			return 0;
+	}
+	return 1;
+}
+
+static void
+lto_wfun(FILE *fp, struct istat *is)
+{
+	struct interpass_prolog *ipp;
+	struct interpass *ip;
+	int flags, n, i;
+
+	flags = is->sp->sclass == EXTDEF ? LF_EXTERN : 0;
+	if (lto_root(is->sp))
+		flags |= LF_ROOT;
+	if (lto_canimport(is)) {
+		/* write the body first, to know if it is small enough */
+		for (i = 0; i < is->nargs; i++) {
+			lto_uint(is->nt[i].type);
+			lto_vint(is->nt[i].temp);
+		}
+		lto_vint(is->retval);
+		n = 0;
+		DLIST_FOREACH(ip, &is->shead, qelem) {
+			switch (ip->type) {
+			case IP_PROLOG:
+			case IP_EPILOG:
+				ipp = (struct interpass_prolog *)ip;
+				lto_byte(ip->type);
+				lto_vint(ipp->ip_tmpnum);
+				lto_vint(ipp->ip_lblnum);
+				break;
+			case IP_DEFLAB:
+				lto_byte(ip->type);
+				lto_vint(ip->ip_lbl);
+				break;
+			case IP_NODE:
+				lto_byte(ip->type);
+				n += lto_wnode(ip->ip_node);
+				break;
+			case IP_ASM:
+				lto_byte(ip->type);
+				lto_str(ip->ip_asm);
+				break;
+			}
+		}
+		lto_byte(0);
+		if (n <= LTOMAXNODES)
+			flags |= LF_BODY;
+	}
+	n = lblen;
+	lto_str(getexname(is->sp));
+	lto_uint(flags);
+	lto_wrefs(is);
+	if (flags & LF_BODY)
+		lto_uint(is->nargs);
+
+	/* the body was written first, so put it last */
+	lto_hdr(fp, LTO_FUN, (flags & LF_BODY) ? lblen : lblen - n);
+	fwrite(lb + n, 1, lblen - n, fp);
+	if (flags & LF_BODY)
+		fwrite(lb, 1, n, fp);
+	lblen = 0;
+}
+
+/*
+ * Write out the summary, followed by the source.
+ */
+void
+lto_write(void)
+{
+	struct istat *is;
+	FILE *fp;
+	long sz = 0;
+	int c;
+
+	if ((fp = fopen(ltoout, "w")) == NULL) {
+		fprintf(stderr, "open lto file '%s':", ltoout);
+		perror(NULL);
+		exit(1);
+	}
+	fputs(LTOMAGIC, fp);
+	putc(LTOVERSION, fp);
+
+	SLIST_FOREACH(is, &ipole, link) {
+		if (DLIST_ISEMPTY(&is->shead, qelem))
+			continue; /* never defined */
+		if (is->sp->sclass != EXTDEF && is->sp->sclass != STATIC)
+			continue; /* inline only */
+		lto_wfun(fp, is);
+	}
+	lto_wrefs(&ltoglob);
+	lto_record(fp, LTO_REFS);
+
+	if (fseek(stdin, 0L, SEEK_END) != 0 || (sz = ftell(stdin)) < 0 ||
+	    fseek(stdin, 0L, SEEK_SET) != 0)
+		cerror("-flto-write: cannot seek input");
+	lto_hdr(fp, LTO_SRC, sz);
+	while ((c = getchar()) != EOF)
+		putc(c, fp);
+	if (fclose(fp) == EOF) {
+		fprintf(stderr, "write lto file '%s':", ltoout);
+		perror(NULL);
+		exit(1);
+	}
+}
+
+/*
+ * Add an object to be read by lto_read(), in link order.
+ */
+void
+lto_addfile(char *name)
+{
+	ltofiles = realloc(ltofiles, (nltofiles+1) * sizeof(char *));
+	if (ltofiles == NULL)
+		cerror("out of memory!");
+	ltofiles[nltofiles++] = name;
+}
+
+static int
+lto_rbyte(void)
+{
+	if (lp == lpe)
+		cerror("bad -flto-read object");
+	return *lp++;
+}
+
+static U_CONSZ
+lto_ruint(void)
+{
+	U_CONSZ u = 0;
+	int c, sh = 0;
+
+	do {
+		c = lto_rbyte();
+		u |= (U_CONSZ)(c & 0x7f) << sh;
+		sh += 7;
+	} while (c & 0x80);
+	return u;
+}
+
+static CONSZ
+lto_rvint(void)
+{
+	U_CONSZ u = lto_ruint();
+
+	return (CONSZ)(u >> 1) ^ -(CONSZ)(u & 1);
+}
+
+static char *
+lto_rstr(void)
+{
+	int l = (int)lto_ruint();
+	char *s;
+
+	if (l > lpe - lp)
+		cerror("bad -flto-read object");
+	s = permalloc(l+1);
+	memcpy(s, lp, l);
+	s[l] = 0;
+	lp += l;
+	return s;
+}
+
+static NODE *
+lto_rnode(void)
+{
+	struct attr *ap, **app;
+	NODE *p;
+	int ty, i, n, t;
+
+	p = memset(permalloc(sizeof(NODE)), 0, sizeof(NODE));
+	p->n_op = (int)lto_ruint();
+	p->n_type = (TWORD)lto_ruint();
+	p->n_qual = (TWORD)lto_ruint();
+	ty = coptype(p->n_op);
+	p->n_name = "";
+	if (ty == LTYPE)
+		slval(p, lto_rvint());
+	if (p->n_op == NAME || p->n_op == ICON) {
+		p->n_name = lto_rstr();
+		if (*p->n_name)
+			lto_extname(p->n_name);
+	} else if (ty != BITYPE)
+		p->n_rval = (int)lto_rvint();
+	if (p->n_op == XASM || p->n_op == XARG)
+		p->n_name = lto_rstr();
+	n = (int)lto_ruint();
+	for (app = &p->n_ap; n > 0; n--) {
+		t = (int)lto_ruint();
+		ap = attr_new(t, (int)lto_ruint());
+		for (i = 0; i < ap->sz; i++)
+			ap->iarg(i) = (int)lto_rvint();
+		*app = ap;
+		app = &ap->next;
+	}
+	if (ty != LTYPE)
+		p->n_left = lto_rnode();
+	if (ty == BITYPE)
+		p->n_right = lto_rnode();
+	return p;
+}
+
+static struct ltoname *
+lto_extname(char *name)
+{
+	struct ltoname *ln;
+	int h = lto_hash(name);
+
+	for (ln = ltonames[h]; ln; ln = ln->next)
+		if (strcmp(ln->name, name) == 0)
+			return ln;
+	ln = memset(permalloc(sizeof(*ln)), 0, sizeof(*ln));
+	ln->name = name;
+	ln->next = ltonames[h];
+	ltonames[h] = ln;
+	return ln;
+}
+
+/*
+ * A file-local symbol is declared.  Returns the name to output it
+ * with if an external symbol of the same name is used by a body
+ * that may be inlined, otherwise NULL.
+ */
+char *
+lto_local(char *sname)
+{
+	struct ltoname *ln;
+	char *n = exname(sname);
+	char buf[32];
+
+	if (ltomode != LTO_READ)
+		return NULL;
+	for (ln = ltonames[lto_hash(n)]; ln; ln = ln->next)
+		if (strcmp(ln->name, n) == 0)
+			break;
+	if (ln == NULL)
+		return NULL;
+	if (ln->local == NULL) {
+		snprintf(buf, sizeof buf, LABFMT, getlab());
+		ln->local = addname(buf);
+	}
+	return ln->local;
+}
+
+/*
+ * Read a function body.  It is not on ipole, an imported
+ * function is recognized by not having a symtab entry.
+ */
+static struct istat *
+lto_rbody(void)
+{
+	static int nolabels = 0;
+	struct interpass_prolog *ipp;
+	struct interpass *ip;
+	struct istat *is;
+	int i, t;
+
+	is = ialloc();
+	DLIST_INIT(&is->shead, qelem);
+	is->flags = CANINL;
+	if ((is->nargs = (int)lto_ruint()) > 0)
+		is->nt = memset(permalloc(sizeof(struct ntds) * is->nargs),
+		    0, sizeof(struct ntds) * is->nargs);
+	for (i = 0; i < is->nargs; i++) {
+		is->nt[i].type = (TWORD)lto_ruint();
+		is->nt[i].temp = (int)lto_rvint();
+	}
+	is->retval = (int)lto_rvint();
+	while ((t = lto_rbyte()) != 0) {
+		if (t == IP_PROLOG || t == IP_EPILOG) {
+			ipp = memset(permalloc(sizeof(*ipp)), 0, sizeof(*ipp));
+			ipp->ip_tmpnum = (int)lto_rvint();
+			ipp->ip_lblnum = (int)lto_rvint();
+			ipp->ip_labels = &nolabels;
+			ip = (struct interpass *)ipp;
+		} else {
+			ip = permalloc(sizeof(*ip));
+			switch (t) {
+			case IP_DEFLAB:
+				ip->ip_lbl = (int)lto_rvint();
+				break;
+			case IP_NODE:
+				ip->ip_node = lto_rnode();
+				break;
+			case IP_ASM:
+				ip->ip_asm = lto_rstr();
+				break;
+			default:
+				cerror("bad -flto-read object");
+			}
+		}
+		ip->type = t;
+		DLIST_INSERT_BEFORE(&is->shead, ip, qelem);
+	}
+	return is;
+}
+
+static int
+lto_hash(char *s)
+{
+	unsigned int h;
+
+	for (h = 0; *s; s++)
+		h = h * 31 + (unsigned char)*s;
+	return h & (LTOHASHSZ-1);
+}
+
+/*
+ * Find a function read in, extern if tu < 0.
+ */
+static struct ltofun *
+lto_lookup(int tu, char *name)
+{
+	struct ltofun *lf;
+
+	for (lf = ltohash[lto_hash(name)]; lf; lf = lf->next) {
+		if (tu < 0 ? (lf->flags & LF_EXTERN) == 0 :
+		    ((lf->flags & LF_EXTERN) || lf->tu != tu))
+			continue;
+		if (strcmp(lf->name, name) == 0)
+			return lf;
+	}
+	return NULL;
+}
+
+/*
+ * Find a body from -flto-read to inline instead of calling sp.
+ */
+static struct istat *
+lto_find(struct symtab *sp)
+{
+	struct ltofun *lf;
+
+	if (ltomode != LTO_READ || sp->sclass == STATIC ||
+	    sp->sclass == USTATIC)
+		return NULL;
+	if ((lf = lto_lookup(-1, getexname(sp))) == NULL)
+		return NULL;
+	return lf->is;
+}
+
+static struct ltofun *
+lto_rfun(int tu, int refsonly)
+{
+	struct ltofun *lf;
+	int i, h;
+
+	lf = memset(permalloc(sizeof(*lf)), 0, sizeof(*lf));
+	lf->tu = tu;
+	if (refsonly) {
+		lf->name = "";
+		lf->flags = LF_ROOT;
+	} else {
+		lf->name = lto_rstr();
+		lf->flags = (int)lto_ruint();
+	}
+	lf->nrefs = (int)lto_ruint();
+	lf->refs = permalloc(sizeof(struct ltoref) * (lf->nrefs+1));
+	for (i = 0; i < lf->nrefs; i++) {
+		lf->refs[i].name = lto_rstr();
+		lf->refs[i].kind = (int)lto_ruint();
+	}
+#ifdef mach_i386
+	if (kflag)
+		lf->flags &= ~LF_BODY; /* see inlinetree() */
+#endif
+	if (lf->flags & LF_BODY)
+		lf->is = lto_rbody();
+	lf->lnext = ltoall;
+	ltoall = lf;
+	if (refsonly == 0) {
+		h = lto_hash(lf->name);
+		lf->next = ltohash[h];
+		ltohash[h] = lf;
+	}
+	return lf;
+}
+
+/*
+ * Read the summary of object tu, return the offset of its source.
+ */
+static long
+lto_rfile(int tu)
+{
+	char *fn = ltofiles[tu];
+	U_CONSZ len;
+	long off = -1;
+	FILE *fp;
+	int c, sh, tag;
+
+	if ((fp = fopen(fn, "r")) == NULL) {
+		fprintf(stderr, "open lto file '%s':", fn);
+		perror(NULL);
+		exit(1);
+	}
+	for (c = 0; LTOMAGIC[c]; c++)
+		if (getc(fp) != (unsigned char)LTOMAGIC[c])
+			break;
+	if (LTOMAGIC[c] || getc(fp) != LTOVERSION) {
+		fprintf(stderr, "%s: not an lto object\n", fn);
+		exit(1);
+	}
+	while ((tag = getc(fp)) != EOF) {
+		for (len = 0, sh = 0; (c = getc(fp)) & 0x80; sh += 7)
+			len |= (U_CONSZ)(c & 0x7f) << sh;
+		if (c == EOF)
+			cerror("bad -flto-read object");
+		len |= (U_CONSZ)c << sh;
+		if (tag == LTO_SRC) {
+			off = ftell(fp);
+			break;
+		}
+		lp = lb = realloc(lb, len ? len : 1);
+		if (lb == NULL)
+			cerror("out of memory!");
+		lbsz = len;
+		lpe = lp + len;
+		if (fread(lb, 1, len, fp) != len)
+			cerror("bad -flto-read object");
+		if (tag == LTO_FUN || tag == LTO_REFS)
+			lto_rfun(tu, tag == LTO_REFS);
+	}
+	fclose(fp);
+	if (off < 0)
+		cerror("bad -flto-read object");
+	return off;
+}
+
+static void
+lto_need(struct ltofun *lf)
+{
+	if (lf == NULL || (lf->flags & LF_NEEDED))
+		return;
+	lf->flags |= LF_NEEDED;
+	lf->wnext = ltowork;
+	ltowork = lf;
+}
+
+static struct ltofun *
+lto_reffun(struct ltofun *lf, struct ltoref *r)
+{
+	return lto_lookup(r->kind & LR_LOCAL ? lf->tu : -1, r->name);
+}
+
+/*
+ * Find the functions that must be written out.  A direct call to
+ * a function with a body is always inlined, so then only what that
+ * function refers to is needed.
+ */
+static void
+lto_needed(void)
+{
+	struct ltofun *lf, *lr;
+	int i, j;
+
+	for (lf = ltoall; lf; lf = lf->lnext)
+		if (lf->flags & LF_ROOT)
+			lto_need(lf);
+	while ((lf = ltowork) != NULL) {
+		ltowork = lf->wnext;
+		for (i = 0; i < lf->nrefs; i++) {
+			if ((lr = lto_reffun(lf, &lf->refs[i])) == NULL)
+				continue; /* in a library */
+			if ((lf->refs[i].kind & LR_ADDR) || lr == lf ||
+			    (lr->flags & LF_BODY) == 0) {
+				lto_need(lr);
+				continue;
+			}
+			for (j = 0; j < lr->nrefs; j++)
+				lto_need(lto_reffun(lr, &lr->refs[j]));
+		}
+	}
+}
+
+/*
+ * Read all summaries and position the input at the source of
+ * the object being compiled.
+ */
+void
+lto_read(char *input)
+{
+	long off, soff = -1;
+	int i;
+
+	for (i = 0; i < nltofiles; i++) {
+		off = lto_rfile(i);
+		if (strcmp(ltofiles[i], input) == 0)
+			soff = off;
+	}
+	lblen = lbsz = 0;
+	if (soff < 0) {
+		fprintf(stderr, "%s: not given with -flto-read\n", input);
+		exit(1);
+	}
+	if (fseek(stdin, soff, SEEK_SET) != 0)
+		cerror("-flto-read: cannot seek input");
+	if (ltowhole)
+		lto_needed();
+}
@@ -34,6 +34,7 @@
 #include <signal.h>
 #include <string.h>
 #include <stdlib.h>
+#include <time.h>
 
 #include "pass1.h"
 #include "pass2.h"
@@ -45,9 +46,15 @@ int r2debug, s2debug, t2debug, u2debug, x2debug;
 int gflag, kflag;
 int pflag, sflag;
 int sspflag;
-int xscp, xssa, xtailcall, xtemps, xdeljumps, xdce, xinline, xccp, xgnu89, xgnu99;
+int xscp, xssa, xtailcall, xtemps, xdeljumps, xdce, xifconv, xinline, xccp, xgnu89, xgnu99;
+int xdelay, xpeep, xshrinkwrap;
 int xuchar;
+#ifdef PASS1
+int xiptext;		/* write the interpass data as text */
+#endif
 int freestanding;
+int inlfuncs;		/* -finline-functions */
+int funcsects, datasects; /* -ffunction-sections, -fdata-sections */
 char *prgname, *ftitle;
 
 static void prtstats(void);
@@ -84,6 +91,14 @@ xopt(char *str)
 		xdeljumps++;
 	else if (strcmp(str, "dce") == 0)
 		xdce++;
+	else if (strcmp(str, "ifconv") == 0)
+		xifconv++;
+	else if (strcmp(str, "delay") == 0)
+		xdelay++;
+	else if (strcmp(str, "peep") == 0)
+		xpeep++;
+	else if (strcmp(str, "shrinkwrap") == 0)
+		xshrinkwrap++;
 	else if (strcmp(str, "inline") == 0)
 		xinline++;
 	else if (strcmp(str, "ccp") == 0)
@@ -96,6 +111,10 @@ xopt(char *str)
 		xgnu99++;
 	else if (strcmp(str, "uchar") == 0)
 		xuchar++;
+#ifdef PASS1
+	else if (strcmp(str, "iptext") == 0)
+		xiptext++;
+#endif
 	else {
 		fprintf(stderr, "unknown -x option '%s'\n", str);
 		usage();
@@ -121,6 +140,24 @@ fflags(char *str)
 		pragma_allpacked = (strlen(str) > 12 ? atoi(str+12) : 1);
 	else if (strcmp(str, "freestanding") == 0)
 		freestanding = flagval;
+	else if (strncmp(str, "lto-write=", 10) == 0) {
+		ltomode = LTO_WRITE;
+		ltoout = str + 10;
+	} else if (strncmp(str, "lto-read=", 9) == 0) {
+		ltomode = LTO_READ;
+		lto_addfile(str + 9);
+	} else if (strcmp(str, "whole-program") == 0)
+		ltowhole = flagval;
+	else if (strcmp(str, "inline-functions") == 0)
+		inlfuncs = flagval;
+	else if (strcmp(str, "function-sections") == 0)
+		funcsects = flagval;
+	else if (strcmp(str, "data-sections") == 0)
+		datasects = flagval;
+	else if (strcmp(str, "profile-generate") == 0)
+		profgen = flagval;
+	else if (strncmp(str, "profile-use=", 12) == 0)
+		profuse = str + 12;
 	else {
 		fprintf(stderr, "unknown -f option '%s'\n", str);
 		usage();
@@ -297,6 +334,9 @@ main(int argc, char *argv[])
 	/* starts past any of the above */
 	reached = 1;
 
+#ifdef PASS1
+	p2open();
+#endif
 	bjobcode();
 #ifndef TARGET_VALIST
 	{
@@ -337,14 +377,20 @@ main(int argc, char *argv[])
 #endif
 
 #ifndef PASS2
+	if (ltomode == LTO_READ)
+		lto_read(argc > 0 ? argv[0] : "-");
 	(void) yyparse();
 	yyaccpt();
+	if (ltomode == LTO_WRITE && nerrors == 0)
+		lto_write();
 
 	if (!nerrors) {
 		lcommprint();
+		zblkprint();
 #ifndef NO_STRING_SAVE
 		strprint();
 #endif
+		profprint();
 	}
 #endif
 
@@ -389,11 +435,17 @@ prtstats(void)
 	extern int savstringsz, newattrsz, nodesszcnt, symtreecnt;
 #endif
 	extern size_t permallocsize, tmpallocsize, lostmem;
+#ifndef PASS1
+	extern int p2autosz, stkshared;
+	extern clock_t p2emittime;
+#endif
 
 	/* common allocations */
 	fprintf(stderr, "Permanent allocated memory:	%zu B\n", permallocsize);
 	fprintf(stderr, "Temporary allocated memory:	%zu B\n", tmpallocsize);
 	fprintf(stderr, "Lost memory:			%zu B\n", lostmem);
+	fprintf(stderr, "CPU time:			%.2f s\n",
+	    (double)clock() / CLOCKS_PER_SEC);
 
 #ifndef PASS2
 	/* pass1 allocations */
@@ -434,4 +486,15 @@ prtstats(void)
 	    (symtabcnt * (int)sizeof(struct symtab))-(symtreecnt * treestrsz)-
 	    lcommsz-blkalloccnt-newattrsz-nodesszcnt);
 #endif
+#ifndef PASS1
+	fprintf(stderr, "Stack frame size:		%d B\n", p2autosz);
+	fprintf(stderr, "Without shared spill slots:	%d B\n",
+	    p2autosz + stkshared);
+	fprintf(stderr, "Time in emit():			%.2f s\n",
+	    (double)p2emittime / CLOCKS_PER_SEC);
+#endif
+#if defined(PEEPHOLE) && !defined(PASS1)
+	if (xpeep)
+		peepstats();
+#endif
 }
@@ -80,6 +80,231 @@ fortarg(NODE *p)
 	/* mapping relationals when the sides are reversed */
 short revrel[] ={ EQ, NE, GE, GT, LE, LT, UGE, UGT, ULE, ULT };
 
+#ifdef TARGET_MULH
+/*
+ * Division by invariant integers using multiplication (Granlund and
+ * Montgomery, PLDI 1994).  The magic numbers are computed as in
+ * Hacker's Delight, chapter 10, in sz-bit arithmetic.
+ *
+ * Unsigned: returns the multiplier, the shift in *sh and in *add
+ * whether the multiplier did not fit in sz bits.
+ */
+static U_CONSZ
+umagic(U_CONSZ d, int sz, int *sh, int *add)
+{
+	U_CONSZ msk, hi, nc, delta, q1, r1, q2, r2;
+	int p;
+
+	msk = sz < 64 ? ((U_CONSZ)1 << sz) - 1 : ~(U_CONSZ)0;
+	hi = (U_CONSZ)1 << (sz - 1);
+	*add = 0;
+	nc = msk - ((-d) & msk) % d;
+	p = sz - 1;
+	q1 = hi / nc;
+	r1 = hi - q1 * nc;
+	q2 = (hi - 1) / d;
+	r2 = (hi - 1) - q2 * d;
+	do {
+		p++;
+		if (r1 >= nc - r1) {
+			q1 = (2 * q1 + 1) & msk;
+			r1 = (2 * r1 - nc) & msk;
+		} else {
+			q1 = (2 * q1) & msk;
+			r1 = (2 * r1) & msk;
+		}
+		if (r2 + 1 >= d - r2) {
+			if (q2 >= hi - 1)
+				*add = 1;
+			q2 = (2 * q2 + 1) & msk;
+			r2 = (2 * r2 + 1 - d) & msk;
+		} else {
+			if (q2 >= hi)
+				*add = 1;
+			q2 = (2 * q2) & msk;
+			r2 = (2 * r2 + 1) & msk;
+		}
+		delta = d - 1 - r2;
+	} while (p < 2 * sz && (q1 < delta || (q1 == delta && r1 == 0)));
+	*sh = p - sz;
+	return (q2 + 1) & msk;
+}
+
+/*
+ * Signed: returns the (sign-extended) multiplier and the shift in *sh.
+ * 2 <= |d| < 2^(sz-1).
+ */
+static CONSZ
+smagic(CONSZ d, int sz, int *sh)
+{
+	U_CONSZ msk, hi, ad, anc, t, delta, q1, r1, q2, r2, m;
+	int p;
+
+	msk = sz < 64 ? ((U_CONSZ)1 << sz) - 1 : ~(U_CONSZ)0;
+	hi = (U_CONSZ)1 << (sz - 1);
+	ad = d < 0 ? -(U_CONSZ)d : (U_CONSZ)d;
+	t = hi + (d < 0);
+	anc = t - 1 - t % ad;
+	p = sz - 1;
+	q1 = hi / anc;
+	r1 = hi - q1 * anc;
+	q2 = hi / ad;
+	r2 = hi - q2 * ad;
+	do {
+		p++;
+		q1 = (2 * q1) & msk;
+		r1 = 2 * r1;
+		if (r1 >= anc) {
+			q1++;
+			r1 -= anc;
+		}
+		q2 = (2 * q2) & msk;
+		r2 = 2 * r2;
+		if (r2 >= ad) {
+			q2++;
+			r2 -= ad;
+		}
+		delta = ad - r2;
+	} while (q1 < delta || (q1 == delta && r1 == 0));
+	m = (q2 + 1) & msk;
+	if (d < 0)
+		m = -m & msk;
+	if (m & hi)
+		m |= ~msk;
+	*sh = p - sz;
+	return (CONSZ)m;
+}
+
+/*
+ * Rewrite DIV or MOD by a constant into MULH, shifts and fixups.
+ * The dividend is evaluated once, into a temporary if needed.
+ */
+static NODE *
+divcon(NODE *p)
+{
+	TWORD t = p->n_type;
+	NODE *n, *q, *r, *s1;
+	CONSZ d, m;
+	U_CONSZ msk;
+	int sz, sh, add, k;
+
+	if (!nncon(p->n_right) || p->n_left->n_type != t)
+		return p;
+	switch (t) {
+	case INT: case UNSIGNED: case LONG: case ULONG:
+	case LONGLONG: case ULONGLONG:
+		break;
+	default:
+		return p;
+	}
+	/* keep pointer differences, see MUL above */
+	if (LO(p) == MINUS && ISPTR(p->n_left->n_left->n_type))
+		return p;
+	sz = (int)tsize(t, 0, 0);
+	if (((TARGET_MULH) & (sz / SZCHAR)) == 0)
+		return p;
+	msk = sz < 64 ? ((U_CONSZ)1 << sz) - 1 : ~(U_CONSZ)0;
+	d = RV(p);
+	if (ISUNSIGNED(t)) {
+		d &= msk;
+		if (((U_CONSZ)d & ((U_CONSZ)d - 1)) == 0)
+			return p;
+	} else {
+		if ((U_CONSZ)d & ((U_CONSZ)1 << (sz - 1)))
+			d = (CONSZ)((U_CONSZ)d | ~msk);
+		else
+			d = (CONSZ)((U_CONSZ)d & msk);
+		if (d == -1 || d == 0 || d == 1 || (U_CONSZ)d == ~(msk >> 1))
+			return p;
+		if (p->n_op == MOD && d < 0)
+			d = -d;
+	}
+
+	/* dividend, as a reusable leaf */
+	s1 = NULL;
+	if (LO(p) == TEMP) {
+		n = p->n_left;
+	} else {
+		n = tempnode(0, t, 0, 0);
+		s1 = block(ASSIGN, p1tcopy(n), p->n_left, t, 0, 0);
+	}
+
+#define	NB(o, l, r)	block(o, l, r, t, 0, 0)
+	k = ISUNSIGNED(t) ? -1 : ispow2(d < 0 ? -d : d);
+	if (ISUNSIGNED(t)) {
+		m = (CONSZ)umagic((U_CONSZ)d, sz, &sh, &add);
+		q = NB(MULH, p1tcopy(n), xbcon(m, NULL, t));
+		if (add) {
+			r = tempnode(0, t, 0, 0);
+			q = NB(ASSIGN, p1tcopy(r), q);
+			s1 = s1 ? NB(COMOP, s1, q) : q;
+			q = NB(MINUS, p1tcopy(n), p1tcopy(r));
+			q = NB(RS, q, bcon(1));
+			q = NB(PLUS, q, r);
+			sh--;
+		}
+		if (sh)
+			q = NB(RS, q, bcon(sh));
+	} else if (k > 0) {
+		/* round towards zero: add 2^k-1 to negative dividends */
+		q = NB(RS, p1tcopy(n), bcon(sz - 1));
+		q = NB(AND, q, xbcon(((CONSZ)1 << k) - 1, NULL, t));
+		q = NB(PLUS, p1tcopy(n), q);
+		q = NB(RS, q, bcon(k));
+		if (d < 0)
+			q = NB(UMINUS, q, NULL);
+	} else {
+		m = smagic(d, sz, &sh);
+		q = NB(MULH, p1tcopy(n), xbcon(m, NULL, t));
+		if (d > 0 && m < 0)
+			q = NB(PLUS, q, p1tcopy(n));
+		else if (d < 0 && m > 0)
+			q = NB(MINUS, q, p1tcopy(n));
+		if (sh)
+			q = NB(RS, q, bcon(sh));
+		/* add one if negative */
+		r = tempnode(0, t, 0, 0);
+		q = NB(ASSIGN, p1tcopy(r), q);
+		s1 = s1 ? NB(COMOP, s1, q) : q;
+		q = NB(RS, p1tcopy(r), bcon(sz - 1));
+		q = NB(MINUS, r, q);
+	}
+	if (p->n_op == MOD) {
+		if (k > 0)
+			q = NB(LS, q, bcon(k));
+		else
+			q = NB(MUL, q, xbcon(d, NULL, t));
+		q = NB(MINUS, p1tcopy(n), q);
+	}
+#undef NB
+	nfree(n);
+	nfree(p->n_right);
+	nfree(p);
+	return s1 ? block(COMOP, s1, q, t, 0, 0) : q;
+}
+
+/*
+ * Rewrite all DIV and MOD by constants in the tree.  This adds
+ * temporaries and COMOPs, so it is not part of optim(), which is also
+ * called from ecode() after rmcops().  Called from ecomp() instead.
+ */
+NODE *
+divcons(NODE *p)
+{
+	int o = coptype(p->n_op);
+
+	if (odebug)
+		return p;
+	if (o != LTYPE)
+		p->n_left = divcons(p->n_left);
+	if (o == BITYPE)
+		p->n_right = divcons(p->n_right);
+	if (p->n_op == DIV || p->n_op == MOD)
+		p = divcon(p);
+	return p;
+}
+#endif
+
 /*
  * local optimizations, most of which are probably
  * machine independent
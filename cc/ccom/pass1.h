@@ -110,6 +110,7 @@ extern	char *scnames(int);
 
 struct rstack;
 struct symtab;
+struct istat;
 union arglist;
 #ifdef GCC_COMPAT
 struct gcc_attr_pack;
@@ -153,6 +154,7 @@ struct	symtab {
 	TWORD	squal;		/* qualifier word */
 	union	dimfun *sdf;	/* ptr to the dimension/prototype array */
 	struct	attr *sap;	/* the base type attribute list */
+	struct	istat *sinl;	/* inline function data, see inline.c */
 };
 
 #define	ISSOU(ty)   ((ty) == STRTY || (ty) == UNIONTY)
@@ -180,7 +182,16 @@ extern	OFFSZ inoff;
 
 extern	int reached;
 extern	int isinlining;
-extern	int xinline, xgnu89, xgnu99;
+extern	int xinline, xgnu89, xgnu99, inlfuncs;
+extern	int funcsects, datasects;
+extern	int ltomode, ltowhole;
+extern	char *ltoout;
+#define	LTO_WRITE	1	/* -flto-write, save a summary */
+#define	LTO_READ	2	/* -flto-read, compile with summaries */
+extern	int profgen, profheat;
+extern	char *profuse;
+#define	PROF_HOT	1	/* profheat: function runs often */
+#define	PROF_COLD	2	/* profheat: function never ran */
 extern	int bdebug, ddebug, edebug, idebug, ndebug;
 extern	int odebug, pdebug, sdebug, tdebug, xdebug;
 
@@ -224,6 +235,9 @@ extern int pragma_allpacked, pragma_packed, pragma_aligned;
 #define	NMSEG		13		/* other (named) segment */
 
 extern int lastloc;
+#ifdef PASS1
+extern int xiptext;
+#endif
 void locctr(int type, struct symtab *sp);
 void setseg(int type, char *name);
 void defalign(int al);
@@ -270,6 +284,9 @@ typedef struct p1node {
 #define NOOFFSET	(-10201)
 
 /* declarations of various functions */
+extern	P1ND *expnode;
+extern	int expval, explab;
+
 extern	P1ND
 	*buildtree(int, P1ND *, P1ND *r),
 	*mkty(unsigned, union dimfun *, struct attr *),
@@ -298,6 +315,9 @@ extern	P1ND
 	*eve(P1ND *),
 	*doacall(struct symtab *, P1ND *, P1ND *);
 P1ND	*intprom(P1ND *);
+#ifdef TARGET_MULH
+P1ND	*divcons(P1ND *);
+#endif
 OFFSZ	tsize(TWORD, union dimfun *, struct attr *),
 	psize(P1ND *);
 P1ND *	typenode(P1ND *new);
@@ -318,6 +338,19 @@ void inline_ref(struct symtab *);
 void inline_prtout(void);
 void inline_args(struct symtab **, int);
 P1ND *inlinetree(struct symtab *, P1ND *, P1ND *);
+void inline_local(void);
+void inline_save(struct symtab *);
+int lto_call(struct symtab *, int);
+void lto_alias(char *);
+char *lto_local(char *);
+void lto_addfile(char *);
+void lto_read(char *);
+void lto_write(void);
+void proffile(char *);
+void proffunc(void);
+int profbranch(void);
+void profheld(void);
+void profprint(void);
 void argsave(P1ND *p);
 struct rstack *bstruct(char *, int, P1ND *);
 void moedef(char *);
@@ -344,6 +377,7 @@ int ninval(CONSZ, int, P1ND *);
 void infld(CONSZ, int, CONSZ);
 void zbits(CONSZ, int);
 void instring(struct symtab *);
+int strmerge(struct symtab *);
 void inwstring(struct symtab *);
 void plabel(int);
 void bjobcode(void);
@@ -364,7 +398,9 @@ void p1print(char *, ...);
 char *copst(int);
 int cdope(int);
 void myp2tree(P1ND *);
-void lcommprint(void), strprint(void);
+void p2open(void);
+void ipint(int);
+void lcommprint(void), strprint(void), zblkprint(void);
 void lcommdel(struct symtab *);
 P1ND *funcode(P1ND *);
 struct symtab *enumhd(char *);
@@ -535,6 +571,8 @@ enum {	ATTR_FIRST = ATTR_MI_MAX + 1,
 	GCC_ATYP_NOCLONE,
 	GCC_ATYP_REGPARM,
 	GCC_ATYP_FASTCALL,
+	GCC_ATYP_HOT,
+	GCC_ATYP_COLD,
 
 	/* other stuff */
 	GCC_ATYP_BOUNDED,	/* OpenBSD extra boundary checks */
@@ -446,6 +446,7 @@ defid2(NODE *q, int class, char *astr)
 #ifdef GCC_COMPAT
 			if (blevel == 0)
 				werror("no register assignment (yet)");
+#ifndef PASS1	/* register names are only known by pass2 */
 			else if (astr != NULL) {
 				int i;
 
@@ -461,6 +462,7 @@ defid2(NODE *q, int class, char *astr)
 					break;
 				werror("reg '%s' invalid", astr);
 			}
+#endif
 #endif
 		}
 		/* FALLTHROUGH */
@@ -507,6 +509,9 @@ defid2(NODE *q, int class, char *astr)
 
 done:
 	fixdef(p);	/* Leave last word to target */
+	if (p->slevel == 0 && (p->sclass == STATIC || p->sclass == USTATIC) &&
+	    attr_find(p->sap, ATTR_SONAME) == NULL && (astr = lto_local(p->sname)))
+		addsoname(p, astr);	/* clear of inlined -flto-read code */
 #ifndef HAVE_WEAKREF
 	{
 		struct attr *at;
@@ -516,6 +521,15 @@ done:
 			addsoname(p, at->sarg(0));
 	}
 #endif
+#ifdef GCC_COMPAT
+	{
+		struct attr *at;
+
+		/* alias target must be kept */
+		if ((at = attr_find(p->sap, GCC_ATYP_ALIAS)))
+			lto_alias(at->sarg(0));
+	}
+#endif
 #ifdef PCC_DEBUG
 	if (ddebug) {
 		printf( "	sdf, offset: %p, %d\n\t",
@@ -684,16 +698,17 @@ done:	autooff = AUTOINIT;
 	plabel(prolab); /* after prolog, used in optimization */
 	retlab = getlab();
 	bfcode(argptr, nparams);
-	if (fun_inline && (xinline
+	if ((fun_inline && (xinline
 #ifdef GCC_COMPAT
  || attr_find(cftnsp->sap, GCC_ATYP_ALW_INL)
 #endif
-		))
+		)) || (isinlining && (inlfuncs || ltomode == LTO_WRITE)))
 		inline_args(argptr, nparams);
 	plabel(getlab()); /* used when spilling */
 	if (parlink)
 		ecomp(parlink);
 	parlink = NIL;
+	proffunc();
 	nparams = 0;
 	symclear(1);	/* In case of function pointer args */
 }
@@ -1224,6 +1239,27 @@ tsize(TWORD ty, union dimfun *d, struct attr *apl)
 	return((unsigned int)sz * mult);
 }
 
+/*
+ * Check if a string may go to the string segment, which may be
+ * merged by the linker: only char strings without embedded NULs.
+ * Others go to readonly data.
+ */
+int
+strmerge(struct symtab *sp)
+{
+	char *s;
+
+	if (BTYPE(sp->stype) != CHAR && BTYPE(sp->stype) != UCHAR)
+		return 0;
+	for (s = sp->sname; *s; ) {
+		if (*s != '\\')
+			s++;
+		else if (esccon(&s) == 0)
+			return 0;
+	}
+	return 1;
+}
+
 #ifndef MYINSTRING
 /*
  * Print out a string of characters.
@@ -1233,25 +1269,26 @@ tsize(TWORD ty, union dimfun *d, struct attr *apl)
 void
 instring(struct symtab *sp)
 {
-	unsigned short sh[2];
-	char *s, *str;
+	unsigned short sh[64];
+	unsigned int cp[64];
+	char *s, *str, *e;
 	TWORD t;
 	NODE *p;
+	int i, n;
 
-	locctr(STRNG, sp);
+	locctr(strmerge(sp) ? STRNG : RDATA, sp);
 	defloc(sp);
 
 	t = BTYPE(sp->stype);
 	str = s = sp->sname;
+	e = s + strlen(s);
 	if (t == ctype(USHORT)) {
 		/* convert to UTF-16 */
 		p = xbcon(0, NULL, t);
-		while (*s) {
-			cp2u16(u82cp(&s), sh);
-			if ((glval(p) = sh[0]))
-				inval(0, SZSHORT, p);
-			if ((glval(p) = sh[1]))
-				inval(0, SZSHORT, p);
+		while ((n = u82u16(&s, e, sh, 64)) > 0) {
+			for (i = 0; i < n; i++)
+				if ((glval(p) = sh[i]))
+					inval(0, SZSHORT, p);
 		}
 		slval(p, 0);
 		inval(0, SZSHORT, p);
@@ -1260,9 +1297,11 @@ instring(struct symtab *sp)
 	    t == ctype(SZINT < 32 ? LONG : INT)) {
 		/* convert to UTF-32 */
 		p = xbcon(0, NULL, t);
-		while (*s) {
-			slval(p, u82cp(&s));
-			inval(0, SZINT < 32 ? SZLONG : SZINT, p);
+		while ((n = u82u32(&s, e, cp, 64)) > 0) {
+			for (i = 0; i < n; i++) {
+				slval(p, cp[i]);
+				inval(0, SZINT < 32 ? SZLONG : SZINT, p);
+			}
 		}
 		slval(p, 0);
 		inval(0, SZINT < 32 ? SZLONG : SZINT, p);
@@ -2481,7 +2520,13 @@ out:		al++;
 
 build:	if (apary)
 		FUNFREE(apary);
-	if (sp != NULL && (sp->sflags & SINLINE) && (w = inlinetree(sp, f, a)))
+	if (sp != NULL && !ISFTN(sp->stype))
+		sp = NULL; /* call through a pointer */
+	i = sp != NULL && ltomode &&
+	    lto_call(sp, f->n_df != NULL && f->n_df[0].dfun != NULL);
+	if (sp != NULL && ((sp->sflags & SINLINE) || i ||
+	    (inlfuncs && ltomode != LTO_WRITE)) &&
+	    (w = inlinetree(sp, f, a)))
 		return w;
 	return buildtree(a == NIL ? UCALL : CALL, f, a);
 }
@@ -2759,6 +2804,7 @@ getsymtab(char *name, int flags)
 	s->slevel = (char)blevel;
 	s->sdf = NULL;
 	s->sap = NULL;
+	s->sinl = NULL;
 	return s;
 }
 
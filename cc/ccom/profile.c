@@ -0,0 +1,222 @@
+/*	$Id$	*/
+
+/*
+ * Profile-guided compilation, -fprofile-generate and -fprofile-use.
+ *
+ * Every function entry and every conditional branch gets 64-bit
+ * counters, numbered in the order they are parsed.  A branch has
+ * two: the times it is evaluated and the times its condition holds.
+ * The counters of a file are written as one record to section
+ * pcc_prof, after the hash of the source file name and the number
+ * of counters.  The runtime linked in by cc writes the section to
+ * the profile file at exit, adding the counts of earlier runs.
+ *
+ * With -fprofile-use the record of the file is looked up in the
+ * profile.  Branches that mostly go one way are laid out as if
+ * __builtin_expect() was used, functions that never ran are cold
+ * and functions that run often are hot, which also affects inlining.
+ */
+
+#include "pass1.h"
+
+extern char *asspace;
+
+#define	PROFMIN	16	/* evaluations before a branch is trusted */
+#define	PROFHOT	100	/* hot if entered 1/PROFHOT as often as most */
+
+int profgen;		/* -fprofile-generate */
+char *profuse;		/* -fprofile-use file */
+int profheat;		/* PROF_HOT or PROF_COLD for this function */
+
+static struct symtab *profsp;	/* the counters */
+static int nprof, heldcnt;
+static U_CONSZ profkey;		/* hash of the source name */
+static U_CONSZ *profcnt;	/* counts read from the profile */
+static int profn;
+static U_CONSZ profmax;		/* largest of them */
+
+/*
+ * Find the record for the source file name in the profile.
+ */
+void
+proffile(char *name)
+{
+	U_CONSZ h, *buf, *p, *e;
+	FILE *fp;
+	long sz;
+
+	if (profkey != 0)
+		return;
+	for (h = 0xcbf29ce484222325ULL; *name; name++)
+		h = (h ^ (unsigned char)*name) * 0x100000001b3ULL;
+	profkey = h;
+	if (profuse == NULL)
+		return;
+
+	if ((fp = fopen(profuse, "rb")) == NULL) {
+		werror("cannot open profile %s", profuse);
+		return;
+	}
+	buf = NULL;
+	if (fseek(fp, 0, SEEK_END) == 0 && (sz = ftell(fp)) > 0 &&
+	    fseek(fp, 0, SEEK_SET) == 0) {
+		buf = permalloc(sz);
+		if (fread(buf, sizeof(U_CONSZ), sz / sizeof(U_CONSZ), fp) !=
+		    sz / sizeof(U_CONSZ))
+			buf = NULL;
+	}
+	fclose(fp);
+	if (buf == NULL) {
+		werror("cannot read profile %s", profuse);
+		return;
+	}
+
+	e = buf + sz / sizeof(U_CONSZ);
+	for (p = buf; e - p >= 2 && p[1] <= (U_CONSZ)(e - p - 2);
+	    p += p[1] + 2) {
+		if (p[0] != profkey)
+			continue;
+		profcnt = p + 2;
+		profn = (int)p[1];
+		for (p = profcnt; p < profcnt + profn; p++)
+			if (*p > profmax)
+				profmax = *p;
+		return;
+	}
+	werror("no profile for %s in %s", ftitle, profuse);
+}
+
+/*
+ * With -fprofile-generate, count counter n here.
+ */
+static void
+profinc(int n)
+{
+	P1ND *p;
+
+	if (profgen == 0 || reached == 0)
+		return;
+	if (profsp == NULL) {
+		profsp = getsymtab("prof", SNORMAL);
+		profsp->stype = ctype(ULONGLONG);
+		profsp->sclass = STATIC;
+		profsp->slevel = 1;
+		profsp->soffset = getlab();
+#ifdef GCC_COMPAT
+		profsp->sap = attr_new(GCC_ATYP_SECTION, 1);
+		profsp->sap->sarg(0) = "pcc_prof";
+#endif
+	}
+	p = buildtree(ADDROF, nametree(profsp), NULL);
+	p = buildtree(PLUS, p, bcon(n));
+	ecomp(buildtree(PLUSEQ, buildtree(UMUL, p, NULL), bcon(1)));
+}
+
+/*
+ * Take the next counter.
+ */
+static int
+profsite(void)
+{
+	if (profkey == 0)
+		proffile(ftitle);
+	return nprof++;
+}
+
+/*
+ * Count in the profile, or -1 if unknown.
+ */
+static CONSZ
+profcount(int n)
+{
+	if (profcnt == NULL || n >= profn)
+		return -1;
+	return (CONSZ)profcnt[n];
+}
+
+/*
+ * Function entry.  Mark the function hot or cold from the profile.
+ */
+void
+proffunc(void)
+{
+	CONSZ c;
+	int n;
+
+	profheat = 0;
+	if (profgen == 0 && profuse == NULL)
+		return;
+	profinc(n = profsite());
+	if ((c = profcount(n)) < 0)
+		return;
+	if (c == 0)
+		profheat = PROF_COLD;
+	else if ((U_CONSZ)c >= profmax / PROFHOT)
+		profheat = PROF_HOT;
+#ifdef GCC_COMPAT
+	if (profheat && attr_find(cftnsp->sap, GCC_ATYP_HOT) == NULL &&
+	    attr_find(cftnsp->sap, GCC_ATYP_COLD) == NULL)
+		cftnsp->sap = attr_add(cftnsp->sap, attr_new(profheat ==
+		    PROF_COLD ? GCC_ATYP_COLD : GCC_ATYP_HOT, 1));
+#endif
+}
+
+/*
+ * Before a conditional branch.  Returns the value the condition
+ * usually has according to the profile, or -1.
+ */
+int
+profbranch(void)
+{
+	CONSZ e, h;
+	int n;
+
+	if (profgen == 0 && profuse == NULL)
+		return -1;
+	profinc(n = profsite());
+	heldcnt = profsite();
+	e = profcount(n);
+	h = profcount(heldcnt);
+	if (e < PROFMIN || h < 0)
+		return -1;
+	if (h <= e / 10)
+		return 0;
+	if (h >= e - e / 10)
+		return 1;
+	return -1;
+}
+
+/*
+ * After a conditional branch, where its condition held.
+ */
+void
+profheld(void)
+{
+	if (profgen)
+		profinc(heldcnt);
+}
+
+/*
+ * Write out the counters at end of file.
+ */
+void
+profprint(void)
+{
+	P1ND *p;
+	TWORD t;
+
+	if (profuse && profcnt && profn != nprof)
+		werror("profile for %s does not match the source", ftitle);
+	if (profsp == NULL)
+		return;
+
+	/* the record header goes before the counters */
+	t = ctype(ULONGLONG);
+	locctr(DATA, profsp);
+	inval(0, SZLONGLONG, p = xbcon((CONSZ)profkey, NULL, t));
+	p1nfree(p);
+	inval(0, SZLONGLONG, p = xbcon(nprof, NULL, t));
+	p1nfree(p);
+	defloc(profsp);
+	printf(PRTPREF "%s %d\n", asspace, nprof * (SZLONGLONG/SZCHAR));
+}
@@ -366,10 +366,61 @@ hide(struct symtab *sym)
 	return new;
 }
 
+#ifdef ELFABI
+/*
+ * Section name prefixes for each segment, when symbols are put in
+ * sections of their own.
+ */
+static char *sectnames[] = {
+	".text", ".data", ".rodata", ".data", ".bss", NULL,
+	".data.rel", ".data.rel.ro", ".data.rel.local", ".tdata", ".tbss",
+};
+
+/*
+ * Return the name of the section of its own that sp in seg should
+ * go to with -ffunction-sections or -fdata-sections, or NULL.
+ * Functions declared hot or cold go to .text.hot or .text.unlikely.
+ */
+static char *
+ownsect(int seg, struct symtab *sp)
+{
+	char *n, *s;
+	int own;
+
+	if (seg < PROG || seg > TLSUDATA || (n = sectnames[seg]) == NULL)
+		return NULL;
+	own = ISFTN(sp->stype) ? funcsects : datasects;
+#ifdef GCC_COMPAT
+	if (seg == PROG && attr_find(sp->sap, GCC_ATYP_COLD))
+		n = ".text.unlikely";
+	else if (seg == PROG && attr_find(sp->sap, GCC_ATYP_HOT))
+		n = ".text.hot";
+	else
+#endif
+	if (own == 0)
+		return NULL;
+	if (own == 0)
+		return n;
+	if (sp->slevel == 0) {
+		s = getexname(sp);
+		n = strcat(strcat(strcpy(tmpalloc(strlen(n) + strlen(s) + 2),
+		    n), "."), s);
+	} else {
+		/* local statics and strings are named by their label */
+		s = tmpalloc(strlen(n) + 16);
+		sprintf(s, "%s.%d", n, sp->soffset);
+		n = s;
+	}
+	return n;
+}
+#endif
+
 /*
  * Extract correct segment for the specified symbol and call
  * target routines to print it out.
  * If symtab entry is specified, output alignment as well.
+ * With -ffunction-sections or -fdata-sections the symbol gets a
+ * section of its own, and the target gets its name.
  */
 void
 locctr(int seg, struct symtab *sp)
@@ -377,6 +428,9 @@ locctr(int seg, struct symtab *sp)
 #ifdef GCC_COMPAT
 	struct attr *ga;
 #endif
+#ifdef ELFABI
+	char *n;
+#endif
 
 	if (seg == NOSEG) {
 		;
@@ -404,6 +458,12 @@ locctr(int seg, struct symtab *sp)
 			if (seg == RDATA) seg = PICRDATA;
 			if (seg == LDATA) seg = PICLDATA;
 		}
+#ifdef ELFABI
+		if ((n = ownsect(seg, sp)) != NULL) {
+			setseg(seg, n);
+			seg = NOSEG;
+		} else
+#endif
 		if (lastloc != seg)
 			setseg(seg, NULL);
 	}
@@ -573,7 +633,8 @@ styp(void)
 static void
 strst(struct symtab *sp, TWORD t)
 {
-	char *wr;
+	unsigned int cp[64];
+	char *wr, *e;
 	int i;
 
 	sp->sclass = STATIC;
@@ -588,13 +649,19 @@ strst(struct symtab *sp, TWORD t)
 	dimfuncnt++;
 	sp->stype = t;
 
-	for (wr = sp->sname, i = 1; *wr; i++) {
-		if (strtype == 'L' || strtype == 'U' || strtype == 'u')
-			(void)u82cp(&wr);
-		else if (*wr == '\\')
-			(void)esccon(&wr);
-		else
-			wr++;
+	wr = sp->sname;
+	i = 1;
+	if (strtype == 'L' || strtype == 'U' || strtype == 'u') {
+		e = wr + strlen(wr);
+		while (wr < e)
+			i += u82u32(&wr, e, cp, 64);
+	} else {
+		for (; *wr; i++) {
+			if (*wr == '\\')
+				(void)esccon(&wr);
+			else
+				wr++;
+		}
 	}
 	sp->sdf->ddim = i;
 #ifndef NO_STRING_SAVE
@@ -643,18 +710,109 @@ strend(char *s, TWORD t)
 }
 
 #ifndef NO_STRING_SAVE
+#ifdef ELFABI
+/*
+ * A referenced string that may share its bytes with another.
+ */
+struct strent {
+	struct symtab *sp;
+	struct strent *own;	/* string this is the tail of */
+	char *s;		/* contents, escapes resolved */
+	int len;
+};
+
+/*
+ * Compare two strings backwards, so that a string sorts
+ * right before the strings it is the tail of.
+ */
+static int
+strrcmp(const void *a, const void *b)
+{
+	const struct strent *x = *(struct strent * const *)a;
+	const struct strent *y = *(struct strent * const *)b;
+	int i = x->len, j = y->len, c;
+
+	while (i > 0 && j > 0)
+		if ((c = (unsigned char)x->s[--i] - (unsigned char)y->s[--j]))
+			return c;
+	return i - j;
+}
+
+/*
+ * Find out which of the n strings in v are the tail of another one.
+ */
+static void
+strtails(struct strent *v, int n)
+{
+	struct strent **w, *x, *y;
+	char *s, *d;
+	int i;
+
+	w = tmpalloc(n * sizeof(struct strent *));
+	for (i = 0; i < n; i++) {
+		x = w[i] = &v[i];
+		x->own = NULL;
+		x->s = d = tmpalloc(strlen(x->sp->sname) + 1);
+		for (s = x->sp->sname; *s; d++) {
+			if (*s == '\\')
+				*d = (char)esccon(&s);
+			else
+				*d = *s++;
+		}
+		x->len = (int)(d - x->s);
+	}
+	qsort(w, n, sizeof(struct strent *), strrcmp);
+	for (i = n-2; i >= 0; i--) {
+		x = w[i], y = w[i+1];
+		if (x->len <= y->len &&
+		    memcmp(x->s, y->s + y->len - x->len, x->len) == 0)
+			x->own = y->own ? y->own : y;
+	}
+}
+#endif
+
 /*
  * Print out strings that have been referenced.
+ * On ELF, a string that is the tail of another one ("bar" of
+ * "foobar") is not printed but set to point into it.
  */
 void
 strprint(void)
 {
 	struct symtab *sp;
+#ifdef ELFABI
+	struct strent *v;
+	int i, n;
+
+	for (n = 0, sp = strpole; sp; sp = sp->snext)
+		if ((sp->sflags & SASG) && strmerge(sp))
+			n++;
+	v = n ? tmpalloc(n * sizeof(struct strent)) : NULL;
+	for (i = 0, sp = strpole; sp; sp = sp->snext)
+		if ((sp->sflags & SASG) && strmerge(sp))
+			v[i++].sp = sp;
+	if (n)
+		strtails(v, n);
+	i = 0;
+#endif
 
 	for (sp = strpole; sp; sp = sp->snext) {
 		if ((sp->sflags & SASG) == 0)
 			continue; /* not referenced */
+#ifdef ELFABI
+		if (i < n && v[i].sp == sp && v[i++].own != NULL)
+			continue; /* tail of another string */
+#endif
 		instring(sp);
 	}
+#ifdef ELFABI
+	for (i = 0; i < n; i++) {
+		if (v[i].own == NULL)
+			continue;
+		printf(PRTPREF "\t.set " LABFMT "," LABFMT "+%d\n",
+		    v[i].sp->soffset, v[i].own->sp->soffset,
+		    v[i].own->len - v[i].len);
+	}
+#endif
 }
 #endif
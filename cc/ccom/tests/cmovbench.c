@@ -0,0 +1,95 @@
+/*	$Id$	*/
+
+/*
+ * Branchy min/max/clamp loop for timing -xifconv (see ifconvert() in
+ * optim2.c).  Without MAIN this is the code to compile with ccom, with
+ * and without -xifconv; with MAIN it is the driver, compiled by the
+ * host compiler and linked with the ccom output.
+ *
+ *	cmovb [iterations]
+ */
+
+#ifdef MAIN
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+long bench(long);
+
+int
+main(int argc, char *argv[])
+{
+	long it = argc > 1 ? atol(argv[1]) : 30000, s;
+	clock_t t;
+
+	t = clock();
+	s = bench(it);
+	t = clock() - t;
+	printf("%.2fs (sum %ld)\n", (double)t / CLOCKS_PER_SEC, s);
+	return 0;
+}
+
+#else
+
+#define	N	4096
+
+static unsigned int rs = 12345;
+int a[N], b[N];
+
+static unsigned int
+rnd(void)
+{
+	rs = rs * 1103515245 + 12345;
+	return rs >> 8;
+}
+
+int
+imin(int x, int y)
+{
+	return x < y ? x : y;
+}
+
+unsigned int
+umax(unsigned int x, unsigned int y)
+{
+	unsigned int r;
+
+	if (x > y)
+		r = x;
+	else
+		r = y;
+	return r;
+}
+
+int
+clamp(int v, int lo, int hi)
+{
+	if (v < lo)
+		v = lo;
+	if (v > hi)
+		v = hi;
+	return v;
+}
+
+long
+bench(long it)
+{
+	long i, k, s = 0;
+	int mn, mx;
+
+	for (i = 0; i < N; i++) {
+		a[i] = rnd() % 1000;
+		b[i] = rnd() % 1000;
+	}
+	for (k = 0; k < it; k++) {
+		for (i = 0; i < N; i++) {
+			mn = imin(a[i], b[i]);
+			mx = a[i] > b[i] ? a[i] : b[i];
+			s += mn + clamp(mx, 200, 800) + (long)umax(a[i], b[i]);
+		}
+	}
+	return s;
+}
+
+#endif
@@ -0,0 +1,130 @@
+/*	$Id$	*/
+
+/*
+ * Generate a program that checks division and modulo by constants
+ * (see divcon() in optim.c) against the same operations with the
+ * divisor read from a volatile.  Compile the output with ccom and run
+ * it; it prints the mismatches and exits 1 if there were any.
+ *
+ *	divgen [-x] [n]
+ *
+ * 32-bit dividends are stepped through with a large odd stride, or all
+ * 2^32 of them with -x.  64-bit dividends are n random numbers (default
+ * 1000000) plus values near the edges.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static const char *sdiv32[] = {
+	"2", "3", "5", "6", "7", "9", "10", "11", "12", "13", "25", "100",
+	"125", "641", "1000", "1021", "6700417", "0x40000001",
+	"0x7ffffffe", "0x7fffffff", "0x40000000", "-2", "-3", "-7", "-8",
+	"-10", "-641", "-0x7fffffff", "(-0x7fffffff-1)",
+};
+static const char *udiv32[] = {
+	"3u", "5u", "6u", "7u", "10u", "11u", "641u", "1000u", "1021u",
+	"1000003u", "0x7fffffffu", "0x80000001u", "0xfffffffeu",
+	"0xffffffffu", "0x55555555u",
+};
+static const char *sdiv64[] = {
+	"3ll", "7ll", "10ll", "641ll", "1000ll", "1000003ll",
+	"6700417ll", "0x100000001ll", "0x7fffffffffffffffll",
+	"0x4000000000000001ll", "0x100000000ll", "-3ll", "-7ll",
+	"-1000ll", "-0x7fffffffffffffffll", "(-0x7fffffffffffffffll-1)",
+};
+static const char *udiv64[] = {
+	"3ull", "7ull", "10ull", "641ull", "1000003ull",
+	"0x100000001ull", "0x7fffffffffffffffull", "0x8000000000000001ull",
+	"0xfffffffffffffffeull", "0xffffffffffffffffull",
+	"0x5555555555555555ull", "274177ull",
+};
+
+#define	NELEM(x)	(sizeof(x)/sizeof(x[0]))
+
+/*
+ * One check function per divisor.  The dividend is in u, as unsigned.
+ */
+static void
+gen(const char *pfx, const char *ty, const char *uty, const char *fmt,
+    const char **dv, int n)
+{
+	int i;
+
+	printf("static volatile %s v%s;\n", ty, pfx);
+	for (i = 0; i < n; i++) {
+		printf("static int\n%s%d(%s u)\n{\n", pfx, i, uty);
+		printf("\t%s x = (%s)u;\n\n", ty, ty);
+		printf("\tif (x / %s == x / v%s && x %% %s == x %% v%s)\n",
+		    dv[i], pfx, dv[i], pfx);
+		printf("\t\treturn 0;\n");
+		printf("\tif (nerr++ < 20)\n");
+		printf("\t\tprintf(\"%s: " "%%%s / %%s\\n\", x, \"%s\");\n",
+		    ty, fmt, dv[i]);
+		printf("\treturn 1;\n}\n\n");
+	}
+}
+
+static void
+loop(const char *pfx, int bits, const char **dv, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		printf("\tv%s = %s;\n\tall%d(%s%d);\n", pfx, dv[i], bits, pfx, i);
+}
+
+int
+main(int argc, char *argv[])
+{
+	unsigned long step = 0x10001;
+	long nrand = 1000000;
+	int i;
+
+	for (i = 1; i < argc; i++) {
+		if (argv[i][0] == '-' && argv[i][1] == 'x')
+			step = 1;
+		else
+			nrand = atol(argv[i]);
+	}
+
+	printf("int printf(const char *, ...);\n");
+	printf("static int nerr;\n\n");
+	gen("s32_", "int", "unsigned int", "d", sdiv32, NELEM(sdiv32));
+	gen("u32_", "unsigned int", "unsigned int", "u", udiv32, NELEM(udiv32));
+	gen("s64_", "long long", "unsigned long long", "lld",
+	    sdiv64, NELEM(sdiv64));
+	gen("u64_", "unsigned long long", "unsigned long long", "llu",
+	    udiv64, NELEM(udiv64));
+
+	/* 32-bit: stepped or exhaustive, plus the edges */
+	printf("static void\nall32(int (*f)(unsigned int))\n{\n");
+	printf("\tunsigned int u, d;\n\n");
+	printf("\tu = 0;\n\tdo {\n\t\tf(u);\n");
+	printf("\t} while ((u += %luu) >= %luu);\n", step, step);
+	printf("\tfor (d = 0; d < 70000; d++) {\n");
+	printf("\t\tf(d); f(-d); f(0x7fffffffu - d); f(0x80000000u + d);\n");
+	printf("\t}\n}\n\n");
+
+	/* 64-bit: random, plus the edges */
+	printf("static void\nall64(int (*f)(unsigned long long))\n{\n");
+	printf("\tunsigned long long r = 0x9e3779b97f4a7c15ull, d;\n");
+	printf("\tlong i;\n\n");
+	printf("\tfor (i = 0; i < %ldl; i++) {\n", nrand);
+	printf("\t\tr ^= r << 13; r ^= r >> 7; r ^= r << 17;\n");
+	printf("\t\tf(r); f(r >> (r & 63));\n\t}\n");
+	printf("\tfor (d = 0; d < 70000; d++) {\n");
+	printf("\t\tf(d); f(-d); f(0x7fffffffffffffffull - d);\n");
+	printf("\t\tf(0x8000000000000000ull + d);\n");
+	printf("\t\tf(0xffffffffull - d); f(0x100000000ull + d);\n");
+	printf("\t}\n}\n\n");
+
+	printf("int\nmain(void)\n{\n");
+	loop("s32_", 32, sdiv32, NELEM(sdiv32));
+	loop("u32_", 32, udiv32, NELEM(udiv32));
+	loop("s64_", 64, sdiv64, NELEM(sdiv64));
+	loop("u64_", 64, udiv64, NELEM(udiv64));
+	printf("\tprintf(\"%%d mismatches\\n\", nerr);\n");
+	printf("\treturn nerr != 0;\n}\n");
+	return 0;
+}
@@ -0,0 +1,40 @@
+/*	$Id$	*/
+
+/*
+ * Generate a big translation unit for timing the assembler output:
+ * n functions (default 6000) of about 12 lines each, with loops,
+ * compares, calls and a switch, so that most kinds of instructions
+ * are emitted.  Compile the output with ccom -s, which prints the
+ * time spent in emit().
+ *
+ *	emitgen [n]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+int
+main(int argc, char *argv[])
+{
+	int n = argc > 1 ? atoi(argv[1]) : 6000;
+	int i;
+
+	printf("struct s { int a, b, c; long d; };\n");
+	printf("extern int g[100];\n");
+	printf("long ext(long, int, struct s *);\n");
+	for (i = 0; i < n; i++) {
+		printf("long f%d(struct s *p, int n, long x)\n{\n", i);
+		printf("\tint i; long r = %d;\n", i);
+		printf("\tfor (i = 0; i < n; i++) {\n");
+		printf("\t\tif (p[i].a > %d) r += p[i].b * %d + x;\n",
+		    i % 7, i % 9 + 2);
+		printf("\t\telse if (p[i].c < g[i & 63]) r ^= p[i].d >> 3;\n");
+		printf("\t\telse r = ext(r, i, p + i);\n");
+		printf("\t\tswitch (p[i].b & 7) { case 0: r++; break; "
+		    "case 1: r -= %d; break; case 3: r |= 0x%x; break; "
+		    "default: r = r * 3 + 1; }\n", i, (i * 0x9e37) & 0xffffff);
+		printf("\t}\n\tg[n & 63] = r;\n");
+		printf("\treturn r + x * %d;\n}\n", i % 5 + 1);
+	}
+	return 0;
+}
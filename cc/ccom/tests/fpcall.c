@@ -0,0 +1,45 @@
+/*
+ * Calls with floating point arguments.  On aarch64 these are passed
+ * in v0-v7 and take no stack space (see lastcall()); sp must still be
+ * aligned after the calls.
+ */
+int snprintf(char *, unsigned long, const char *, ...);
+int strcmp(const char *, const char *);
+
+static char buf[64];
+
+double
+f3(double a, double b, double c)
+{
+	return a * 100 + b * 10 + c;
+}
+
+double
+c3(double x)
+{
+	return f3(x, x + 1, x * 2);
+}
+
+int
+p2(double x, double y)
+{
+	snprintf(buf, sizeof(buf), "%.2f %.2f", x, y);
+	return strcmp(buf, "1.50 -2.25");
+}
+
+int
+main(void)
+{
+	volatile double one = 1;
+	int i, n = 0;
+
+	for (i = 0; i < 3; i++)
+		n += c3(one) != 100 + 20 + 2;
+	if (n)
+		return 1;
+	for (i = 0; i < 3; i++)
+		n += p2(one * 1.5, one * -2.25) != 0;
+	if (n)
+		return 2;
+	return 0;
+}
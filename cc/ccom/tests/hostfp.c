@@ -0,0 +1,210 @@
+/*	$Id$	*/
+
+/*
+ * Check floating-point folding with host doubles (HOSTFP in
+ * softfloat.c) on a target whose long double is binary64.  Each
+ * result is compared with the same operation done on host doubles
+ * here, and since softfloat.c is built with SFCHECK, also with what
+ * the MINT code gives.  Multiplication, negation and conversions must
+ * agree with MINT; additions and divisions where MINT differs are
+ * only counted, as it is known to be off by an ulp or two there.
+ * The cases are mostly rounding-sensitive: ties, values just beside
+ * ties, subnormal results and conversions to float, followed by
+ * random operands.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "manifest.h"
+#include "softfloat.h"
+
+extern int sfcheckerr;
+static int nbad, nmint;
+int lineno, nerrors;		/* used with DEBUGFP */
+
+void
+cerror(const char *s, ...)
+{
+	fprintf(stderr, "cerror: %s\n", s);
+	exit(1);
+}
+
+void *
+stmtalloc(size_t sz)
+{
+	return malloc(sz);
+}
+
+static void
+d2sf(SFP sfp, double d)
+{
+	memset(sfp, 0, sizeof(SF));
+	memcpy(sfp->fp, &d, sizeof(double));
+}
+
+static double
+sf2d(SFP sfp)
+{
+	double d;
+
+	memcpy(&d, sfp->fp, sizeof(double));
+	return d;
+}
+
+/*
+ * Results that are Inf or zero are not done on the host, skip them.
+ */
+static void
+chk(const char *what, double a, double b, double want, SFP got, int strict)
+{
+	double d = sf2d(got);
+	int e = sfcheckerr;
+
+	sfcheckerr = 0;
+	if (!isfinite(want) || want == 0)
+		return;
+	if (!strict)
+		nmint += e, e = 0;
+	if (memcmp(&d, &want, sizeof(double)) == 0 && e == 0)
+		return;
+	if (nbad++ < 20)
+		printf("%s %a %a: want %a got %a%s\n", what, a, b, want, d,
+		    e ? " (differs from MINT)" : "");
+}
+
+static void
+op(int o, double a, double b)
+{
+	volatile double va = a, vb = b;
+	SF x, y;
+
+	d2sf(&x, a);
+	d2sf(&y, b);
+	switch (o) {
+	case PLUS:
+		soft_plus(&x, &y, DOUBLE);
+		chk("+", a, b, va + vb, &x, 0);
+		break;
+	case MUL:
+		soft_mul(&x, &y, DOUBLE);
+		chk("*", a, b, va * vb, &x, 1);
+		break;
+	case DIV:
+		if (b == 0)
+			break;
+		soft_div(&x, &y, DOUBLE);
+		chk("/", a, b, va / vb, &x, 0);
+		break;
+	case SCONV:
+		soft_fp2fp(&x, FLOAT);
+		chk("(float)", a, 0, (float)va, &x, 1);
+		break;
+	case UMINUS:
+		soft_neg(&x);
+		chk("-", a, 0, -va, &x, 1);
+		break;
+	}
+}
+
+static void
+all(double a, double b)
+{
+	op(PLUS, a, b);
+	op(PLUS, a, -b);
+	op(MUL, a, b);
+	op(DIV, a, b);
+	op(SCONV, a, 0);
+	op(UMINUS, a, 0);
+}
+
+static void
+i2f(long long l, int uns)
+{
+	SF x;
+
+	soft_int2fp(&x, l, uns ? ULONGLONG : LONGLONG, DOUBLE);
+	chk("(double)", (double)l, 0,
+	    uns ? (double)(unsigned long long)l : (double)l, &x, 1);
+	soft_int2fp(&x, l, uns ? ULONGLONG : LONGLONG, FLOAT);
+	chk("(float)", (double)l, 0,
+	    uns ? (float)(unsigned long long)l : (float)l, &x, 1);
+}
+
+#define	E52	0x1p-52
+#define	E53	0x1p-53
+
+static double pairs[][2] = {
+	/* ties and their neighbours in addition */
+	{ 1, E53 }, { 1 + E52, E53 }, { 1, E53 + 0x1p-105 },
+	{ 1, E53 - 0x1p-106 }, { 1, 0x1p-54 }, { 1 + E52, 1 + 2*E52 },
+	{ 1 + E52, 1 }, { 0x1.fffffffffffffp0, E52 }, { 3, E52 },
+	{ 0x1.fffffffffffffp1023, 0x1p970 }, { 0x1p-1022, 0x1p-1074 },
+	{ 0x1.0000000000001p0, 0x1.0000000000002p0 },
+	{ 0x1.8000000000001p0, 0x1.8000000000003p0 },
+	{ 1e16, 1 }, { 1e16, 3 }, { 0.1, 0.2 },
+	/* multiplication and division */
+	{ 1 + E52, 1 + E52 }, { 1 + E52, 1 - E53 }, { 1 + 2*E52, 1 - E53 },
+	{ 3, 1.0/3 }, { 1, 3 }, { 2, 3 }, { 1, 10 }, { 1, 49 },
+	{ 0x1.fffffffffffffp0, 0x1.ffffffffffffep0 },
+	/* subnormal results */
+	{ 0x1p-1022, 0.5 }, { 0x1p-1022, 3 }, { 0x1.8p-1073, 0.5 },
+	{ 0x1.4p-1072, 0.25 }, { 0x1.fffffffffffffp-1022, 1 - E53 },
+	{ 0x1p-1074, 0x1p-1074 },
+	/* conversions to float, from the first operand */
+	{ 1 + 0x1p-24, 1 }, { 1 + 0x1p-24 + E52, 1 },
+	{ 1 + 0x1p-23 + 0x1p-24, 1 }, { 0x1.fffffefffffffp127, 1 },
+	{ 0x1.ffffffp127, 1 }, { 0x1.8p-149, 1 }, { 0x1p-150, 1 },
+	{ 0x1.0000000000001p-150, 1 }, { 0x1.fffffcp-127, 1 },
+};
+
+static long long ints[] = {
+	0, 1, -1, 16777217, 16777219, -16777217, 9007199254740993LL,
+	9007199254740995LL, -9007199254740993LL, 0x7fffffffffffffffLL,
+	-0x7fffffffffffffffLL-1, 0x7ffffffffffffdffLL, 0x4000000000000401LL,
+	-1LL << 53, (1LL << 53) + 2,
+};
+
+int
+main(void)
+{
+	unsigned long long r = 0x9e3779b97f4a7c15ULL, s;
+	unsigned int i;
+	double a, b;
+
+	if (fpis[2] != &fpi_binary64) {
+		printf("long double is not binary64 here, nothing to check\n");
+		return 0;
+	}
+	for (i = 0; i < sizeof(pairs)/sizeof(pairs[0]); i++) {
+		all(pairs[i][0], pairs[i][1]);
+		all(pairs[i][1], pairs[i][0]);
+		all(-pairs[i][0], pairs[i][1]);
+	}
+	for (i = 0; i < sizeof(ints)/sizeof(ints[0]); i++) {
+		i2f(ints[i], 0);
+		i2f(ints[i], 1);
+	}
+
+	/* random operands, with exponents not far apart */
+	for (i = 0; i < 200000; i++) {
+		r ^= r << 13, r ^= r >> 7, r ^= r << 17;
+		s = r;
+		r ^= r << 13, r ^= r >> 7, r ^= r << 17;
+		s &= ~(0x7ffULL << 52);
+		s |= (unsigned long long)(1023 + (int)(r % 64) - 32) << 52;
+		memcpy(&a, &s, sizeof(a));
+		s = r & ~(0x7ffULL << 52);
+		s |= (unsigned long long)(1023 + (int)((r >> 52) % 64) - 32)
+		    << 52;
+		memcpy(&b, &s, sizeof(b));
+		all(a, b);
+	}
+	if (nmint)
+		printf("%d additions or divisions differ from MINT\n", nmint);
+	if (nbad)
+		printf("%d failed\n", nbad);
+	return nbad != 0;
+}
@@ -0,0 +1,33 @@
+/*	$Id$	*/
+
+/*
+ * Generate a stress test for the inline function lookup (see findfun()
+ * in inline.c): n static inline functions (default 20000), each called
+ * from one of n/100 extern functions, which also take the address of
+ * one of them.  Compile the output with ccom -s, with and without
+ * -xinline; the time should grow about linearly with n.
+ *
+ *	inlgen [n]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+int
+main(int argc, char *argv[])
+{
+	int n = argc > 1 ? atoi(argv[1]) : 20000;
+	int i, j;
+
+	for (i = 0; i < n; i++)
+		printf("static inline int f%d(int x) { return x + %d; }\n",
+		    i, i);
+	printf("typedef int (*fn)(int);\n");
+	for (j = 0; j < n/100; j++) {
+		printf("int\ng%d(int x)\n{\n\tint s = 0;\n\tfn p;\n\n", j);
+		for (i = j*100; i < j*100 + 100; i++)
+			printf("\ts += f%d(x);\n", i);
+		printf("\tp = f%d;\n\treturn s + p(x);\n}\n", (j*37) % n);
+	}
+	return 0;
+}
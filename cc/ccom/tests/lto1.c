@@ -0,0 +1,9 @@
+/*
+ * With lto2.c: functions inlined from another object must refer
+ * to the external symbols, not to statics of the same name.
+ */
+int g = 42;
+int callx(int a) { return a + 6; }
+
+int getg(void) { return g; }
+int wrap(int a) { return callx(a); }
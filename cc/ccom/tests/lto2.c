@@ -0,0 +1,25 @@
+/*
+ * See lto1.c.  The statics are also declared before they are defined.
+ */
+struct s { int a, b; };
+static struct s g;
+static int callx(int);
+int getg(void);
+int wrap(int);
+
+static int
+use(void)
+{
+	return g.b + callx(0);
+}
+
+int
+main(void)
+{
+	if (getg() != 42 || wrap(1) != 7 || use() != 302)
+		return 1;
+	return 0;
+}
+
+static struct s g = { 1, 2 };
+static int callx(int a) { return a + 300; }
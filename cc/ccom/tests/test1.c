@@ -0,0 +1,49 @@
+/*
+ * Division by constants (see divcon() in optim.c) in places that
+ * are compiled after rmcops(): signed bitfield stores and bitfield
+ * initializers.  These once left a COMOP for pass2.
+ */
+struct bf { unsigned a:3; unsigned short e:7; };
+struct ctr { int type:4; int x; } ctr, *ctrloc = &ctr;
+struct sbf { long long l:40; int i:7; } sb;
+
+int
+f(int k)
+{
+	struct bf y = { k, 12 };
+
+	return y.a + y.e;
+}
+
+int
+g(int v)
+{
+	int t;
+
+	ctrloc->type = 1;
+	sb.i = v;
+	sb.l = v;
+	t = ctrloc->type;
+	ctrloc->type = v;
+	return t + ctrloc->type + sb.i;
+}
+
+int
+h(int a, int b)
+{
+	return (a ? b / 7 : b % 10) + (a && b / 3 == 2) + (a / 13 > b % 11);
+}
+
+int
+main(void)
+{
+	if (f(13) != 5 + 12)
+		return 1;
+	if (g(-3) != 1 - 3 - 3 || sb.l != -3)
+		return 2;
+	if (h(1, 20) != 2 + 0 + 0 || h(0, 20) != 0 || h(100, 6) != 0 + 1 + 1)
+		return 3;
+	if (h(-27, -15) != -2 + 0 + 1)
+		return 4;
+	return 0;
+}
@@ -0,0 +1,58 @@
+/*
+ * Partly initialized aggregates, where the rest is cleared with the
+ * widest aligned stores (see clearbf() in init.c).
+ */
+union u { char c[12]; int i; double d; };
+struct s1 { long a; char b[8]; };
+struct s2 { char a; long b; long c; };
+struct s3 { char a; short b:5; long long c; int d[5]; };
+
+struct s1 gx = { 1 };
+struct s2 gy = { 1, 2 };
+union u guu = { .d = 3.0 };
+
+static int
+chk(void *v, int n, int from)
+{
+	unsigned char *p = v;
+	int i;
+
+	for (i = from; i < n; i++)
+		if (p[i] != 0)
+			return 1;
+	return 0;
+}
+
+static int
+f(int k)
+{
+	long a[4] = { 1 };
+	struct s1 x = { 1 };
+	struct s2 y = { 1, 2 };
+	union u uu = { .d = 3.0 };
+	struct s3 z = { 1, k, 3, { 4 } };
+	long big[40] = { [1] = 5, [33] = k };
+
+	if (a[0] != 1 || chk(a, sizeof(a), sizeof(long)))
+		return 1;
+	if (x.a != 1 || chk(x.b, sizeof(x.b), 0))
+		return 2;
+	if (y.a != 1 || y.b != 2 || y.c != 0)
+		return 3;
+	if (uu.d != 3.0)
+		return 4;
+	if (z.a != 1 || z.b != k || z.c != 3 || z.d[0] != 4 ||
+	    chk(z.d, sizeof(z.d), sizeof(int)))
+		return 5;
+	if (big[1] != 5 || big[33] != k || big[0] != 0 || big[39] != 0)
+		return 6;
+	return 0;
+}
+
+int
+main(void)
+{
+	if (gx.a != 1 || gy.b != 2 || guu.d != 3.0)
+		return 10;
+	return f(-9);
+}
@@ -0,0 +1,130 @@
+/*	$Id$	*/
+
+/*
+ * Throughput of u82cp(), u82u32() and u82u16() on text that is plain
+ * ASCII, mostly ASCII with some Latin-1 letters, and CJK.  Linked with
+ * unicode.o from the build directory.
+ *
+ *	u8bench [passes]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "unicode.h"
+
+unsigned int esccon(char **);
+void werror(const char *, ...);
+
+#define	TEXTSZ	(1 << 20)
+
+unsigned int
+esccon(char **s)
+{
+	(*s)++;
+	return (unsigned char)*(*s)++;
+}
+
+void
+u8error(const char *fmt, ...)
+{
+}
+
+void
+werror(const char *fmt, ...)
+{
+}
+
+static double
+now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/*
+ * Fill buf with about TEXTSZ bytes of words taken from w.
+ */
+static int
+fill(char *buf, const char **w, int nw)
+{
+	unsigned int r = 1;
+	int len = 0, l;
+
+	for (;;) {
+		r = r * 1103515245 + 12345;
+		l = strlen(w[(r >> 16) % nw]);
+		if (len + l + 1 >= TEXTSZ)
+			break;
+		memcpy(buf + len, w[(r >> 16) % nw], l);
+		len += l;
+		buf[len++] = ' ';
+	}
+	buf[len] = 0;
+	return len;
+}
+
+static const char *ascii[] = {
+	"the", "quick", "brown", "fox", "jumps", "over", "lazy", "dog",
+	"printf(\"%d\", x);", "0123456789", "identifier_name",
+};
+static const char *latin[] = {
+	"der", "schnelle", "braune", "Fuchs", "springt", "\303\274ber",
+	"den", "faulen", "Hund", "Stra\303\237e", "M\303\244dchen",
+	"gr\303\266\303\237er", "caf\303\251",
+};
+static const char *cjk[] = {
+	"\344\270\255\346\226\207", "\345\255\227\347\254\246",
+	"\346\227\245\346\234\254\350\252\236", "\346\274\242\345\255\227",
+	"\355\225\234\352\270\200",
+};
+
+#define	NW(x)	(int)(sizeof(x)/sizeof(x[0]))
+
+static void
+bench(const char *name, const char **w, int nw, int passes)
+{
+	static char buf[TEXTSZ];
+	unsigned int cp[64];
+	unsigned short sh[64];
+	double t0, t1, t2, t3;
+	long sum = 0;
+	char *s, *e;
+	int len, i, n;
+
+	len = fill(buf, w, nw);
+	e = buf + len;
+	t0 = now();
+	for (i = 0; i < passes; i++)
+		for (s = buf; *s; )
+			sum += u82cp(&s);
+	t1 = now();
+	for (i = 0; i < passes; i++)
+		for (s = buf; (n = u82u32(&s, e, cp, 64)) > 0; )
+			sum += cp[n-1];
+	t2 = now();
+	for (i = 0; i < passes; i++)
+		for (s = buf; (n = u82u16(&s, e, sh, 64)) > 0; )
+			sum += sh[n-1];
+	t3 = now();
+	printf("%-8s %8.0f %8.0f %8.0f%s\n", name,
+	    (double)passes * len / (t1 - t0) / 1e6,
+	    (double)passes * len / (t2 - t1) / 1e6,
+	    (double)passes * len / (t3 - t2) / 1e6, sum ? "" : " ");
+}
+
+int
+main(int argc, char *argv[])
+{
+	int passes = argc > 1 ? atoi(argv[1]) : 100;
+
+	printf("MB/s        u82cp   u82u32   u82u16\n");
+	bench("ASCII", ascii, NW(ascii), passes);
+	bench("Latin-1", latin, NW(latin), passes);
+	bench("CJK", cjk, NW(cjk), passes);
+	return 0;
+}
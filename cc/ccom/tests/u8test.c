@@ -0,0 +1,207 @@
+/*	$Id$	*/
+
+/*
+ * Check u82u32() and u82u16() against u82cp() and cp2u16(), one code
+ * point at a time, on broken, overlong and surrogate UTF-8 as well as
+ * on good input.  Each sequence is put at every offset around the
+ * 16-byte blocks that are done with SSE2, and decoded with different
+ * buffer sizes.  Linked with unicode.o from the build directory.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "unicode.h"
+
+unsigned int esccon(char **);
+void werror(const char *, ...);
+
+static int nu8err, nwerr;
+
+/* enough for the tests, \c is c */
+unsigned int
+esccon(char **s)
+{
+	(*s)++;
+	return (unsigned char)*(*s)++;
+}
+
+void
+u8error(const char *fmt, ...)
+{
+	nu8err++;
+}
+
+void
+werror(const char *fmt, ...)
+{
+	nwerr++;
+}
+
+#define	MAXV	8
+
+static struct seq {
+	char *s;
+	unsigned int v[MAXV];	/* code points, ended by ~0 */
+	int err;		/* calls to u8error() */
+} seqs[] = {
+	{ "A", { 0x41, ~0 } },
+	{ "\303\244", { 0xe4, ~0 } },
+	{ "\342\202\254", { 0x20ac, ~0 } },
+	{ "\360\237\230\200", { 0x1f600, ~0 } },
+	{ "\\n", { 'n', ~0 } },
+	{ "\\\303\244", { 0xe4, ~0 } },
+	/* overlong forms are not rejected, as in u82cp() */
+	{ "\300\200", { 0, ~0 } },
+	{ "\301\277", { 0x7f, ~0 } },
+	{ "\340\200\200", { 0, ~0 } },
+	{ "\360\200\200\200", { 0, ~0 } },
+	/* surrogates decode, but have no UTF-16 form */
+	{ "\355\240\200", { 0xd800, ~0 } },
+	{ "\355\277\277", { 0xdfff, ~0 } },
+	{ "\364\217\277\277", { 0x10ffff, ~0 } },
+	{ "\364\220\200\200", { 0x110000, ~0 } },
+	{ "\370\210\200\200\200", { 0x200000, ~0 } },
+	{ "\374\204\200\200\200\200", { 0x4000000, ~0 } },
+	/* broken: each byte that does not fit is 0xffff */
+	{ "\200", { 0xffff, ~0 }, 1 },
+	{ "\277A", { 0xffff, 0x41, ~0 }, 1 },
+	{ "\376", { 0xffff, ~0 }, 1 },
+	{ "\377\200", { 0xffff, 0xffff, ~0 }, 2 },
+	{ "\303A", { 0xffff, 0x41, ~0 }, 1 },
+	{ "\342\202A", { 0xffff, 0xffff, 0x41, ~0 }, 2 },
+	{ "\360\237\230A", { 0xffff, 0xffff, 0xffff, 0x41, ~0 }, 3 },
+	{ "\303\303\244", { 0xffff, 0xe4, ~0 }, 1 },
+	{ "\303", { 0xffff, ~0 }, 1 },			/* cut at the end */
+	{ "\342\202", { 0xffff, 0xffff, ~0 }, 2 },
+	{ "\360\237\230", { 0xffff, 0xffff, 0xffff, ~0 }, 3 },
+};
+
+#define	NSEQ	(sizeof(seqs)/sizeof(seqs[0]))
+#define	MAXOFF	40
+#define	BUFSZ	(2*MAXOFF + 16)
+
+static int nbad;
+
+static void
+bad(const char *what, struct seq *sq, int off, int n)
+{
+	int i;
+
+	if (nbad++ >= 20)
+		return;
+	printf("%s:", what);
+	for (i = 0; sq->s[i]; i++)
+		printf(" %02x", (unsigned char)sq->s[i]);
+	printf(" at %d, n %d\n", off, n);
+}
+
+/*
+ * The sequence alone gives the listed code points.
+ */
+static void
+alone(struct seq *sq)
+{
+	unsigned int d[MAXV];
+	char *s = sq->s;
+	int i, k;
+
+	nu8err = 0;
+	k = u82u32(&s, sq->s + strlen(sq->s), d, MAXV);
+	for (i = 0; i < k; i++)
+		if (sq->v[i] != d[i])
+			break;
+	if (i != k || sq->v[k] != ~0U || nu8err != sq->err ||
+	    *s != 0)
+		bad("value", sq, 0, MAXV);
+}
+
+/*
+ * The sequence at off with ASCII around it, decoded by n at a time,
+ * gives the same as u82cp()/cp2u16().  If cut, the string ends
+ * right after it.
+ */
+static void
+around(struct seq *sq, int off, int cut, int n)
+{
+	char buf[BUFSZ], *s, *e;
+	unsigned int r32[BUFSZ], d32[BUFSZ], c32[BUFSZ+1];
+	unsigned short r16[2*BUFSZ], d16[2*BUFSZ], c16[BUFSZ+1], sh[2];
+	int i, k, nr, nd, re, rw, over;
+
+	for (i = 0; i < off; i++)
+		buf[i] = 'a' + i % 26;
+	strcpy(buf + off, sq->s);
+	i = off + strlen(sq->s);
+	if (!cut) {
+		for (; i < BUFSZ - 1; i++)
+			buf[i] = 'A' + i % 26;
+	}
+	buf[i] = 0;
+	e = buf + i;
+
+	/* reference */
+	nu8err = nwerr = 0;
+	for (s = buf, nr = 0; *s; )
+		r32[nr++] = (unsigned int)u82cp(&s);
+	re = nu8err;
+
+	/* decoded in chunks, nothing may be written past n */
+	nu8err = over = 0;
+	s = buf;
+	nd = 0;
+	while (c32[n] = ~0U, (k = u82u32(&s, e, c32, n)) > 0) {
+		over |= k > n || c32[n] != ~0U;
+		for (i = 0; i < k && nd < BUFSZ; i++)
+			d32[nd++] = c32[i];
+	}
+	if (s != e || nd != nr || memcmp(r32, d32, nr * sizeof(int)) ||
+	    nu8err != re || over)
+		bad("u82u32", sq, off, n);
+
+	/* a pair needs two entries */
+	if (n < 2)
+		return;
+	nu8err = nwerr = 0;
+	for (i = k = 0; i < nr; i++) {
+		cp2u16((long)r32[i], sh);
+		if (sh[0])
+			r16[k++] = sh[0];
+		if (sh[1])
+			r16[k++] = sh[1];
+	}
+	nr = k;
+	rw = nwerr;
+
+	nu8err = nwerr = over = 0;
+	s = buf;
+	nd = 0;
+	while (c16[n] = 0xffff, (k = u82u16(&s, e, c16, n)) > 0) {
+		over |= k > n || c16[n] != 0xffff;
+		for (i = 0; i < k && nd < 2*BUFSZ; i++)
+			if (c16[i] != 0)	/* left out by instring() */
+				d16[nd++] = c16[i];
+	}
+	if (s != e || nd != nr || memcmp(r16, d16, nr * sizeof(short)) ||
+	    nu8err != re || nwerr != rw || over)
+		bad("u82u16", sq, off, n);
+}
+
+int
+main(void)
+{
+	static int ns[] = { 1, 2, 3, 4, 15, 16, 17, 31, 32, 33, 64, BUFSZ };
+	unsigned int i;
+	int off, j, cut, nn = sizeof(ns)/sizeof(ns[0]);
+
+	for (i = 0; i < NSEQ; i++) {
+		alone(&seqs[i]);
+		for (off = 0; off <= MAXOFF; off++)
+			for (cut = 0; cut < 2; cut++)
+				for (j = 0; j < nn; j++)
+					around(&seqs[i], off, cut, ns[j]);
+	}
+	if (nbad)
+		printf("%d failed\n", nbad);
+	return nbad != 0;
+}
@@ -83,6 +83,13 @@ static P1ND *rewincop(P1ND *p1, P1ND *p2, int op);
 static int has_se(P1ND *p);
 static struct symtab *findmember(struct symtab *, char *);
 int inftn; /* currently between epilog/prolog */
+
+/*
+ * The expression last returned by __builtin_expect() and whether it is
+ * expected to be true; branches to explab get ATTR_EXPECT, see xcbranch().
+ */
+P1ND *expnode;
+int expval, explab = NOLAB;
 P1ND *cstknode(TWORD t, union dimfun *df, struct attr *ap);
 
 static char *tnames[] = {
@@ -2679,9 +2686,13 @@ ecomp(P1ND *p)
 		warner(Wunreachable_code);
 		reached = 1;
 	}
+	expnode = NULL;
 	p = optim(p);
 #ifndef FIELDOPS
 	p = rmfldops(p);
+#endif
+#ifdef TARGET_MULH
+	p = divcons(p);
 #endif
 	comops(p);
 	rmcops(p);
@@ -2693,6 +2704,227 @@ ecomp(P1ND *p)
 
 
 #ifdef PASS1
+/*
+ * Binary interpass output, see IPMAGIC in manifest.h.
+ * Each record is built in ipb and then written out in one go.
+ */
+static unsigned char *ipb;
+static int ipblen, ipbsz;
+
+struct ipstr {
+	struct ipstr *next;
+	char *str;
+	int idx;
+};
+#define	IPHASHSZ	4096
+static struct ipstr *ipstrhash[IPHASHSZ];
+static int ipnstr;
+
+static void
+ipbyte(int c)
+{
+	if (ipblen == ipbsz) {
+		ipbsz = ipbsz ? ipbsz * 2 : 1024;
+		if ((ipb = realloc(ipb, ipbsz)) == NULL)
+			cerror("out of memory!");
+	}
+	ipb[ipblen++] = c;
+}
+
+static void
+ipuint(U_CONSZ u)
+{
+	while (u >= 0x80) {
+		ipbyte((int)(u & 0x7f) | 0x80);
+		u >>= 7;
+	}
+	ipbyte((int)u);
+}
+
+static void
+ipvint(CONSZ v)
+{
+	ipuint(((U_CONSZ)v << 1) ^ (U_CONSZ)(v < 0 ? -1 : 0));
+}
+
+/*
+ * Write an integer in the current interpass format.
+ * Used for the target-specific prolog/epilog members.
+ */
+void
+ipint(int v)
+{
+	if (xiptext)
+		printf("%d ", v);
+	else
+		ipvint(v);
+}
+
+static void
+ipinline(char *s)
+{
+	int l = (int)strlen(s);
+
+	ipuint(l);
+	while (l-- > 0)
+		ipbyte(*s++);
+}
+
+/*
+ * Write a string table reference, entering the string if needed.
+ */
+static void
+ipstrref(char *s)
+{
+	struct ipstr *is;
+	unsigned int h;
+	char *c;
+
+	for (h = 0, c = s; *c; c++)
+		h = h * 31 + (unsigned char)*c;
+	h &= IPHASHSZ-1;
+	for (is = ipstrhash[h]; is; is = is->next)
+		if (strcmp(is->str, s) == 0) {
+			ipuint(is->idx);
+			return;
+		}
+	is = permalloc(sizeof(struct ipstr));
+	is->str = newstring(s, strlen(s));
+	is->idx = ipnstr++;
+	is->next = ipstrhash[h];
+	ipstrhash[h] = is;
+	ipuint(is->idx);
+	ipinline(s);
+}
+
+/*
+ * Write out the record built so far.
+ */
+static void
+iprecord(int tag)
+{
+	U_CONSZ u = ipblen;
+
+	putchar(tag);
+	while (u >= 0x80) {
+		putchar((int)(u & 0x7f) | 0x80);
+		u >>= 7;
+	}
+	putchar((int)u);
+	fwrite(ipb, 1, ipblen, stdout);
+	ipblen = 0;
+}
+
+/*
+ * Start the interpass output.
+ */
+void
+p2open(void)
+{
+	if (xiptext)
+		return;
+	fputs(IPMAGIC, stdout);
+	putchar(IPVERSION);
+}
+
+/*
+ * Write out a tree in preorder, same fields as p2print().
+ */
+static void
+p2bnode(NODE *p)
+{
+	struct attr *ap;
+	int ty, i;
+
+	ty = optype(p->n_op);
+	ipuint(p->n_op);
+	ipuint(p->n_type);
+	ipuint(p->n_qual);
+	if (ty == LTYPE)
+		ipvint(glval(p));
+	if (p->n_op == NAME || p->n_op == ICON)
+		ipstrref(p->n_name);
+	else if (ty != BITYPE)
+		ipvint(p->n_rval);
+	if (p->n_op == XASM || p->n_op == XARG)
+		ipinline(p->n_name);
+	for (i = 0, ap = p->n_ap; ap; ap = ap->next)
+		i++;
+	ipuint(i);
+	for (ap = p->n_ap; ap; ap = ap->next) {
+		ipuint(ap->atype);
+		ipuint(ap->sz);
+		for (i = 0; i < ap->sz; i++)
+			ipvint(ap->iarg(i));
+	}
+	if (ty != LTYPE)
+		p2bnode(p->n_left);
+	if (ty == BITYPE)
+		p2bnode(p->n_right);
+}
+
+static void
+p2bin(struct interpass *ip)
+{
+	struct interpass_prolog *ipp;
+	static int oldlineno;
+	int i;
+
+	if (oldlineno != ip->lineno) {
+		ipvint(oldlineno = ip->lineno);
+		iprecord(IPT_LINE);
+	}
+
+	switch (ip->type) {
+	case IP_PROLOG:
+		ipp = (struct interpass_prolog *)ip;
+		ipuint(ipp->ipp_type);
+		ipvint(ipp->ipp_vis);
+		ipvint(ip->ip_lbl);
+		ipvint(ipp->ip_tmpnum);
+		ipvint(ipp->ip_lblnum);
+		ipstrref(ipp->ipp_name);
+#ifdef TARGET_IPP_MEMBERS
+		target_members_print_prolog(ipp);
+#endif
+		iprecord(IPT_PROLOG);
+		break;
+	case IP_NODE:
+		p2bnode(ip->ip_node);
+		tfree(ip->ip_node);
+		iprecord(IPT_NODE);
+		break;
+	case IP_DEFLAB:
+		ipvint(ip->ip_lbl);
+		iprecord(IPT_DEFLAB);
+		break;
+	case IP_ASM:
+		ipinline(ip->ip_asm);
+		iprecord(IPT_ASM);
+		break;
+	case IP_EPILOG:
+		ipp = (struct interpass_prolog *)ip;
+		ipvint(ipp->ipp_autos);
+		ipvint(ip->ip_lbl);
+		ipvint(ipp->ip_tmpnum);
+		ipvint(ipp->ip_lblnum);
+		ipstrref(ipp->ipp_name);
+		for (i = 0; ipp->ip_labels[i]; i++)
+			;
+		ipuint(i);
+		for (i = 0; ipp->ip_labels[i]; i++)
+			ipvint(ipp->ip_labels[i]);
+#ifdef TARGET_IPP_MEMBERS
+		target_members_print_epilog(ipp);
+#endif
+		iprecord(IPT_EPILOG);
+		break;
+	default:
+		cerror("Missing %d", ip->type);
+	}
+	free(ip);
+}
+
 /* 
  * Print out full tree.
  * Nodes are already converted to pass2 style.
@@ -2747,6 +2979,7 @@ p2print(NODE *p)
  *	# - Line number
  *	& - File name
  *	* - Passthrough line.
+ * Unless -xiptext is given the binary format in p2bin() is used.
  */
 void
 pass2_compile(struct interpass *ip)
@@ -2755,6 +2988,10 @@ pass2_compile(struct interpass *ip)
 	static int oldlineno;
 	int i;
 
+	if (!xiptext) {
+		p2bin(ip);
+		return;
+	}
 	if (oldlineno != ip->lineno)
 		printf("# %d\n", oldlineno = ip->lineno);
 
@@ -2854,6 +3091,9 @@ p2tree(P1ND *p)
 	case NAME:
 	case ICON:
 		if ((q = p->n_sp) != NULL) {
+			if (isinlining && q->sclass != EXTERN &&
+			    q->sclass != EXTDEF)
+				inline_local();
 			if ((q->sclass == STATIC && q->slevel > 0)
 #ifdef GCC_COMPAT
 			    || q->sflags == SLBLNAME
@@ -3151,6 +3391,12 @@ ecode(P1ND *p)
 	}
 	r = p2tree(p);
 	p1tfree(p);
+	if (r->n_op == CBRANCH && explab != NOLAB &&
+	    getlval(r->n_right) == explab) {
+		/* taken if the condition is not expected to hold */
+		r->n_ap = attr_add(r->n_ap, attr_new(ATTR_EXPECT, 1));
+		r->n_ap->iarg(0) = !expval;
+	}
 	send_passt(IP_NODE, r);
 }
 
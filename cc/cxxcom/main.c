@@ -44,9 +44,11 @@ int b2debug, c2debug, e2debug, f2debug, g2debug, o2debug;
 int r2debug, s2debug, t2debug, u2debug, x2debug;
 int gflag, kflag, pflag, sflag;
 int sspflag;
-int xscp, xssa, xtailcall, xtemps, xdeljumps, xdce, xinline, xccp, xgnu89, xgnu99;
+int xscp, xssa, xtailcall, xtemps, xdeljumps, xdce, xifconv, xinline, xccp, xgnu89, xgnu99;
+int xdelay, xpeep, xshrinkwrap;
 int xuchar;
 int freestanding;
+int funcsects, datasects; /* always 0, used by the target code */
 char *prgname;
 
 static void prtstats(void);
@@ -83,6 +85,14 @@ xopt(char *str)
 		xdeljumps++;
 	else if (strcmp(str, "dce") == 0)
 		xdce++;
+	else if (strcmp(str, "ifconv") == 0)
+		xifconv++;
+	else if (strcmp(str, "delay") == 0)
+		xdelay++;
+	else if (strcmp(str, "peep") == 0)
+		xpeep++;
+	else if (strcmp(str, "shrinkwrap") == 0)
+		xshrinkwrap++;
 	else if (strcmp(str, "inline") == 0)
 		xinline++;
 	else if (strcmp(str, "ccp") == 0)
@@ -341,7 +351,7 @@ prtstats(void)
 {
 	extern int nametabs, namestrlen, tmpallocsize, permallocsize;
 	extern int lostmem, arglistcnt, dimfuncnt, inlnodecnt, inlstatcnt;
-	extern int symtabcnt, suedefcnt;
+	extern int symtabcnt, suedefcnt, p2autosz, stkshared;
 
 	fprintf(stderr, "Name table entries:		%d pcs\n", nametabs);
 	fprintf(stderr, "Name string size:		%d B\n", namestrlen);
@@ -354,4 +364,11 @@ prtstats(void)
 	fprintf(stderr, "Inline node count:		%d pcs\n", inlnodecnt);
 	fprintf(stderr, "Inline control blocks:		%d pcs\n", inlstatcnt);
 	fprintf(stderr, "Permanent symtab entries:	%d pcs\n", symtabcnt);
+	fprintf(stderr, "Stack frame size:		%d B\n", p2autosz);
+	fprintf(stderr, "Without shared spill slots:	%d B\n",
+	    p2autosz + stkshared);
+#ifdef PEEPHOLE
+	if (xpeep)
+		peepstats();
+#endif
 }
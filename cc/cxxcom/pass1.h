@@ -187,6 +187,7 @@ extern	OFFSZ inoff;
 extern	int reached;
 extern	int isinlining;
 extern	int xinline, xgnu89, xgnu99;
+extern	int funcsects, datasects;
 extern	int bdebug, ddebug, edebug, idebug, ndebug;
 extern	int odebug, pdebug, sdebug, tdebug, xdebug;
 
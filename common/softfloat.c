@@ -32,6 +32,7 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#include <float.h>
 
 #ifndef PCC_DEBUG
 #define assert(e) ((void)0)
@@ -710,6 +711,138 @@ mcopy(MINT *b, MINT *a)
 		a->val[i] = b->val[i];
 }
 
+#if defined(USE_IEEEFP_32) && defined(USE_IEEEFP_64) && FLT_RADIX == 2 && \
+    FLT_MANT_DIG == 24 && FLT_MAX_EXP == 128 && \
+    DBL_MANT_DIG == 53 && DBL_MAX_EXP == 1024 && \
+    defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+/*
+ * If long double is binary64 on the target, and the host evaluates
+ * float and double as binary32 and binary64 without excess precision,
+ * arithmetic may be done with host doubles instead.  Both round
+ * correctly to nearest-even, so the result is the same, only much
+ * faster.  Anything involving Inf or NaN, or giving zero, is still
+ * left to the MINT code since the bit patterns it uses for those may
+ * differ from the host.
+ *
+ * If SFCHECK is defined, everything is done both ways and compared.
+ */
+#define	HOSTFP
+
+#define	HFEXP(u)	(((u) >> 52) & 0x7ff)
+#define	HFOK(u)		(HFEXP(u) != 0x7ff)	/* finite */
+
+static int hostfp = -1;		/* set on first use */
+
+static uint64_t
+sf2u(SFP sfp)
+{
+	return ((uint64_t)sfp->fp[1] << 32) | sfp->fp[0];
+}
+
+static void
+u2sf(SFP sfp, uint64_t u)
+{
+	sfp->fp[0] = (uint32_t)u;
+	sfp->fp[1] = (uint32_t)(u >> 32);
+}
+
+static double
+u2d(uint64_t u)
+{
+	double d;
+
+	memcpy(&d, &u, sizeof(d));
+	return d;
+}
+
+static uint64_t
+d2u(double d)
+{
+	uint64_t u;
+
+	memcpy(&u, &d, sizeof(u));
+	return u;
+}
+
+static int
+hostfpok(void)
+{
+	/* also check that the host stores doubles as a 64-bit word */
+	if (hostfp < 0)
+		hostfp = LDBLPTR == &fpi_binary64 &&
+		    d2u(-1.5) == 0xbff8000000000000ULL;
+	return hostfp;
+}
+
+#ifdef SFCHECK
+int sfcheckerr;			/* differences found, for tests/hostfp.c */
+
+/*
+ * Compare the host result with what the MINT code gives.
+ */
+static void
+hfcheck(char *s, SFP x1p, SFP x2p, int op, TWORD t, uint64_t u)
+{
+	SF a, b;
+
+	a = *x1p;
+	if (x2p)
+		b = *x2p;
+	hostfp = 0;
+	switch (op) {
+	case PLUS: soft_plus(&a, &b, t); break;
+	case MUL: soft_mul(&a, &b, t); break;
+	case DIV: soft_div(&a, &b, t); break;
+	case UMINUS: soft_neg(&a); break;
+	case SCONV: soft_fp2fp(&a, t); break;
+	}
+	hostfp = 1;
+	if (sf2u(&a) != u && ++sfcheckerr)
+		fprintf(stderr, "%s: %016llx %016llx: host %016llx mint %016llx\n",
+		    s, (unsigned long long)sf2u(x1p),
+		    x2p ? (unsigned long long)sf2u(x2p) : 0ULL,
+		    (unsigned long long)u, (unsigned long long)sf2u(&a));
+}
+#define	HFCHECK(s,x1p,x2p,op,t,u)	hfcheck(s,x1p,x2p,op,t,u)
+#else
+#define	HFCHECK(s,x1p,x2p,op,t,u)
+#endif
+
+/*
+ * Do op on x1p and x2p with host doubles.  Return 0 if not done.
+ */
+static int
+hostfp_op(SFP x1p, SFP x2p, int op, TWORD t)
+{
+	uint64_t u1, u2, u;
+	double d1, d2, r;
+
+	if (!hostfpok())
+		return 0;
+	u1 = sf2u(x1p), u2 = sf2u(x2p);
+	if (!HFOK(u1) || !HFOK(u2))
+		return 0;
+	d1 = u2d(u1), d2 = u2d(u2);
+	switch (op) {
+	case PLUS: r = d1 + d2; break;
+	case MUL: r = d1 * d2; break;
+	case DIV:
+		if (d2 == 0)
+			return 0;
+		r = d1 / d2;
+		break;
+	default:
+		return 0;
+	}
+	u = d2u(r);
+	if (!HFOK(u) || r == 0)
+		return 0;
+	HFCHECK("hostfp_op", x1p, x2p, op, t, u);
+	u2sf(x1p, u);
+	return 1;
+}
+#endif
+
 /*
  * Conversions.
  */
@@ -729,6 +862,26 @@ soft_int2fp(SFP rv, CONSZ l, TWORD f, TWORD t)
 
 	MINTDECL(m);
 
+#ifdef HOSTFP
+	if (hostfpok()) {
+		uint64_t u = d2u(ISUNSIGNED(f) ?
+		    (double)(U_CONSZ)l : (double)(CONSZ)l);
+#ifdef SFCHECK
+		hostfp = 0;
+		soft_int2fp(rv, l, f, LDOUBLE);
+		hostfp = 1;
+		if (sf2u(rv) != u && ++sfcheckerr)
+			fprintf(stderr, "soft_int2fp: %llx: host %016llx "
+			    "mint %016llx\n", (unsigned long long)l,
+			    (unsigned long long)u, (unsigned long long)sf2u(rv));
+#endif
+		u2sf(rv, u);
+		if (t == FLOAT || t == DOUBLE)
+			soft_fp2fp(rv, t);
+		return;
+	}
+#endif
+
 	e = s = 0;
 	c = SOFT_NORMAL;
 	if (!ISUNSIGNED(f) && l < 0) {
@@ -770,9 +923,25 @@ soft_fp2fp(SFP sfp, TWORD t)
 	SF rv, rv2;
 	MINT m;
 	int e, s, c;
+#ifdef HOSTFP
+	uint64_t u;
+#endif
 
 	MINTDECL(m);
 
+#ifdef HOSTFP
+	if (hostfpok() && HFOK(u = sf2u(sfp)) && u2d(u) != 0 &&
+	    (fpis[MKSF(t)] == &fpi_binary32 ||
+	    fpis[MKSF(t)] == &fpi_binary64)) {
+		if (fpis[MKSF(t)] == &fpi_binary32)
+			u = d2u((double)(float)u2d(u));
+		if (HFOK(u) && u2d(u) != 0) {
+			HFCHECK("soft_fp2fp", sfp, NULL, SCONV, t, u);
+			u2sf(sfp, u);
+			return;
+		}
+	}
+#endif
 	c = LDBLPTR->unmake(sfp, &s, &e, &m);
 	fpis[MKSF(t)]->make(&rv2, c, s, e, &m);
 	c = fpis[MKSF(t)]->unmake(&rv2, &s, &e, &m);
@@ -883,6 +1052,14 @@ soft_neg(SFP sfp)
 	int c, s, e;
 
 	MINTDECL(m);
+#ifdef HOSTFP
+	if (hostfpok() && HFOK(sf2u(sfp)) && u2d(sf2u(sfp)) != 0) {
+		HFCHECK("soft_neg", sfp, NULL, UMINUS, 0,
+		    sf2u(sfp) ^ (1ULL << 63));
+		sfp->fp[1] ^= 0x80000000;
+		return;
+	}
+#endif
 	c = LDBLPTR->unmake(sfp, &s, &e, &m);
 	s = !s;
 	LDBLPTR->make(sfp, c, s, e, &m);
@@ -899,6 +1076,10 @@ soft_plus(SFP x1p, SFP x2p, TWORD t)
 	MINTDECL(m1);
 	MINTDECL(m2);
 
+#ifdef HOSTFP
+	if (hostfp_op(x1p, x2p, PLUS, t))
+		return;
+#endif
 	c1 = LDBLPTR->unmake(x1p, &s1, &e1, &m1);
 	c2 = LDBLPTR->unmake(x2p, &s2, &e2, &m2);
 	SD(("soft_plus: c1 %s c2 %s s1 %d s2 %d e1 %d e2 %d\n", 
@@ -974,6 +1155,10 @@ soft_mul(SFP x1p, SFP x2p, TWORD t)
 	MINTDECL(m1);
 	MINTDECL(m2);
 
+#ifdef HOSTFP
+	if (hostfp_op(x1p, x2p, MUL, t))
+		return;
+#endif
 	c1 = LDBLPTR->unmake(x1p, &s1, &e1, &m1);
 	c2 = LDBLPTR->unmake(x2p, &s2, &e2, &m2);
 	SD(("soft_mul: s1 %d s2 %d e1 %d e2 %d\n", s1, s2, e1, e2));
@@ -1028,6 +1213,10 @@ soft_div(SFP x1p, SFP x2p, TWORD t)
 	MINTDECL(e);
 	MINTDECL(f);
 
+#ifdef HOSTFP
+	if (hostfp_op(x1p, x2p, DIV, t))
+		return;
+#endif
 	c1 = LDBLPTR->unmake(x1p, &s1, &e1, &m1);
 	c2 = LDBLPTR->unmake(x2p, &s2, &e2, &m2);
 
@@ -1369,6 +1558,231 @@ hexbig(char *str, MINT *mmant, MINT *mexp)
 	return SOFT_NORMAL;
 }
 
+/*
+ * Fast conversion of decimal strings, after Eisel and Lemire.
+ * The first 19 significant digits are taken as a 64-bit integer w,
+ * and w * 10^q is computed as w * 5^q * 2^q using a 128-bit
+ * approximation of 5^q, rounded down.  The product is never more than
+ * two units of its last bit too low, so the rounding to nbits is
+ * known unless the bits below the rounding bit are all zeros or all
+ * ones.  If more digits were given, w+1 must round the same way.
+ * Otherwise, or if the result may not be normal, return 0 and let
+ * the exact code do it.
+ */
+#define	ELQMAX	350		/* largest 10^q in the table */
+
+static uint64_t elpowt[2*ELQMAX+1][2];	/* 5^q, high and low word */
+static short elpowe[2*ELQMAX+1];	/* 5^q = elpowt * 2^elpowe */
+static char elpowok[2*ELQMAX+1];
+
+static void
+mul128(uint64_t a, uint64_t b, uint64_t *hi, uint64_t *lo)
+{
+	uint64_t al = (uint32_t)a, ah = a >> 32;
+	uint64_t bl = (uint32_t)b, bh = b >> 32;
+	uint64_t ll = al * bl, lh = al * bh, hl = ah * bl;
+	uint64_t mid = (ll >> 32) + (uint32_t)lh + (uint32_t)hl;
+
+	*lo = (mid << 32) | (uint32_t)ll;
+	*hi = ah * bh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+}
+
+static uint64_t
+mint64(MINT *m, int i)
+{
+	uint64_t r = 0;
+	int j;
+
+	for (j = 3; j >= 0; j--)
+		r = (r << 16) | (i*4+j < m->len ? m->val[i*4+j] : 0);
+	return r;
+}
+
+/*
+ * Get 5^q normalized to 128 bits in t, return the power of two.
+ * Computed with the MINT routines the first time it is needed.
+ */
+static int
+elpow(int q, uint64_t *t)
+{
+	MINT p, a, r, five;
+	int i, b, n = q + ELQMAX;
+
+	if (elpowok[n] == 0) {
+		MINTDECL(p);
+		MINTDECL(a);
+		MINTDECL(r);
+		MINTDECL(five);
+		minit(&five, 5);
+		minit(&p, 1);
+		for (i = 0; i < (q < 0 ? -q : q); i++) {
+			mult(&p, &five, &a);
+			mcopy(&a, &p);
+		}
+		b = topbit(&p);
+		if (q >= 0) {
+			if (b > 127)
+				mshr(&p, b - 127, 0);
+			else
+				mshl(&p, 127 - b);
+			elpowe[n] = b - 127;
+		} else {
+			/* 2^(128+b) / 5^-q, truncated */
+			minit(&r, 1);
+			mshl(&r, 128 + b);
+			mdiv(&r, &p, &a, &five);
+			mcopy(&a, &p);
+			elpowe[n] = -(128 + b);
+		}
+		elpowt[n][0] = mint64(&p, 1);
+		elpowt[n][1] = mint64(&p, 0);
+		elpowok[n] = 1;
+	}
+	t[0] = elpowt[n][0];
+	t[1] = elpowt[n][1];
+	return elpowe[n];
+}
+
+/*
+ * Round w * 10^q to nbits of fpi into *mp.  Return the exponent as
+ * expected by make(), or 0 if not sure.
+ */
+static int
+elround(uint64_t w, int q, FPI *fpi, uint64_t *mp)
+{
+	uint64_t t[2], a1, a0, b1, b0, zh, zl, mant, rlo, rhi, mlo, mhi;
+	int lz, tb, s, e, x, half, exact, nb = fpi->nbits;
+
+	for (lz = 0; (w & (1ULL << 63)) == 0; lz++)
+		w <<= 1;
+	x = elpow(q, t);
+	exact = q >= 0 && x <= 0;	/* 5^q fits in 128 bits */
+
+	/* top 128 bits of the 192-bit product, the rest in b0 */
+	mul128(w, t[0], &a1, &a0);
+	mul128(w, t[1], &b1, &b0);
+	zl = a0 + b1;
+	zh = a1 + (zl < a0);
+	x += 64 - lz + q;
+	tb = 126 + (int)(zh >> 63);
+
+	/* s bits below the mantissa; the top one is the rounding bit */
+	s = tb - nb + 1;
+	if (s >= 64) {
+		mant = zh >> (s - 64);
+		half = (s == 64 ? zl >> 63 : zh >> (s - 65)) & 1;
+	} else {
+		mant = (zh << (64 - s)) | (zl >> s);
+		half = (zl >> (s - 1)) & 1;
+	}
+	if (s - 1 >= 64) {
+		mlo = ~0ULL;
+		mhi = (1ULL << (s - 65)) - 1;
+	} else {
+		mlo = (1ULL << (s - 1)) - 1;
+		mhi = 0;
+	}
+	rlo = zl & mlo;
+	rhi = zh & mhi;
+	if (exact) {
+		if (b0)
+			rlo |= 1;
+	} else if ((rlo | rhi) == 0 || (rlo == mlo && rhi == mhi))
+		return 0;
+	if (half && ((rlo | rhi) || (mant & 1)))
+		mant++;
+	e = x + tb + 1 - fpi->expadj;
+	if (nb < 64 && mant == (1ULL << nb)) {
+		mant >>= 1;
+		e++;
+	} else if (nb == 64 && mant == 0) {
+		mant = 1ULL << 63;
+		e++;
+	}
+	if (e <= fpi->minexp + 1 || e >= fpi->maxexp - 1)
+		return 0;
+	*mp = mant;
+	return e;
+}
+
+static int
+eldec(char *str, int *exp, MINT *m, FPI *fpi)
+{
+	uint64_t w, mant, m2;
+	int nd, q, qe, trunc, gotdot, sign, ch, e, e2, i;
+
+	if (fpi->nbits > 64)
+		return 0;
+	w = 0;
+	nd = q = trunc = gotdot = 0;
+	while ((ch = *str++)) {
+		if (ch == '.') {
+			gotdot = 1;
+		} else if (ch >= '0' && ch <= '9') {
+			if (nd < 19) {
+				w = w * 10 + (ch - '0');
+				if (w)
+					nd++;
+				if (gotdot)
+					q--;
+			} else {
+				if (ch != '0')
+					trunc = 1;
+				if (!gotdot)
+					q++;
+			}
+		} else
+			break;
+	}
+	if (ch == 'e' || ch == 'E') {
+		sign = 1;
+		if (*str == '+' || *str == '-')
+			sign = *str++ == '-' ? -1 : 1;
+		for (qe = 0; *str >= '0' && *str <= '9'; str++)
+			if ((qe = qe * 10 + (*str - '0')) > 10000)
+				return 0;
+		q += sign * qe;
+	} else if (ch && strchr("iIlLfF", ch) == NULL)
+		return 0;
+	if (w == 0 || q < -ELQMAX || q > ELQMAX)
+		return 0;
+
+	/* exactly w/5^-q * 2^q if it is an integer */
+	if (!trunc && q < 0 && q >= -27) {
+		uint64_t p5 = 1;
+
+		for (i = 0; i < -q; i++)
+			p5 *= 5;
+		if (w % p5 == 0) {
+			m2 = w / p5;
+			for (i = 0; (m2 & (1ULL << 63)) == 0; i++)
+				m2 <<= 1;
+			mant = m2 >> (64 - fpi->nbits);
+			if (fpi->nbits < 64 && (m2 << fpi->nbits) != 0)
+				goto approx;	/* needs rounding */
+			e = q + 64 - i - fpi->expadj;
+			if (e <= fpi->minexp + 1 || e >= fpi->maxexp - 1)
+				return 0;
+			goto done;
+		}
+	}
+approx:
+	if ((e = elround(w, q, fpi, &mant)) == 0)
+		return 0;
+	if (trunc) {
+		if ((e2 = elround(w + 1, q, fpi, &m2)) != e || m2 != mant)
+			return 0;
+	}
+done:
+	minit(m, 0);
+	for (i = 0; i < 4; i++)
+		m->val[i] = mant >> (16 * i);
+	m->len = 4;
+	chomp(m);
+	*exp = e;
+	return SOFT_NORMAL;
+}
+
 static int
 str2num(char *str, int *exp, MINT *m, struct FPI *fpi)
 {
@@ -1385,6 +1799,8 @@ str2num(char *str, int *exp, MINT *m, struct FPI *fpi)
 	if (*str == '0' && (str[1] == 'x' || str[1] == 'X')) {
 		rv = hexbig(str+2, &mm, &me);
 	} else {
+		if ((rv = eldec(str, exp, m, fpi)) != 0)
+			return rv;
 		rv = decbig(str, &mm, &me);
 	}
 	if (rv != SOFT_NORMAL)
@@ -34,14 +34,18 @@
 #include "manifest.h"
 #include "unicode.h"
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 /*
  * decode 32-bit code point from UTF-8
- * move pointer
+ * move pointer, do not read past e unless it is NULL
  */
-long 
-u82cp(char **q)
+static unsigned long
+u8next(unsigned char **q, unsigned char *e)
 {
-	unsigned char *t = (unsigned char *)*q;
+	unsigned char *t = *q;
 	unsigned long c, r;
 	int i, sz;
 
@@ -51,7 +55,7 @@ u82cp(char **q)
 		c = *t++;
 
 	/* always eat the first value */
-	*q = (char *)t;
+	*q = t;
 
 	if (c > 0x7F) {
 		if ((c & 0xE0) == 0xC0) {
@@ -75,7 +79,9 @@ u82cp(char **q)
 		}
 
 		for (i = 1; i < sz; i++) {
-			if (*t == '\\')
+			if (e != NULL && t >= e)
+				c = 0;
+			else if (*t == '\\')
 				c = esccon((char **)&t);
 			else
 				c = *t++;
@@ -88,7 +94,7 @@ u82cp(char **q)
 			}
 		}
 
-		*q = (char *)t;
+		*q = t;
 	} else {
 		r = c;
 	}
@@ -96,6 +102,160 @@ u82cp(char **q)
 	return r;
 }
 
+/*
+ * decode 32-bit code point from UTF-8
+ * move pointer
+ */
+long
+u82cp(char **q)
+{
+	return (long)u8next((unsigned char **)q, NULL);
+}
+
+#ifdef __SSE2__
+/*
+ * Mask of the bytes in v that cannot be copied as they are:
+ * those with the high bit set and backslashes.
+ */
+#define	U8SPECIAL(v, bs)	\
+	_mm_movemask_epi8(_mm_or_si128(v, _mm_cmpeq_epi8(v, bs)))
+#endif
+
+/*
+ * Decode the code point at *q that is not plain ASCII.  Well-formed
+ * sequences of up to four bytes are done here, anything else (also
+ * escapes) by u8next().
+ */
+static unsigned long
+u8seq(unsigned char **q, unsigned char *e)
+{
+	unsigned char *t = *q;
+	unsigned long c = t[0];
+
+	if ((c & 0xE0) == 0xC0 && e - t >= 2 && (t[1] & 0xC0) == 0x80) {
+		*q = t + 2;
+		return ((c & 0x1F) << 6) | (t[1] & 0x3F);
+	}
+	if ((c & 0xF0) == 0xE0 && e - t >= 3 &&
+	    (t[1] & 0xC0) == 0x80 && (t[2] & 0xC0) == 0x80) {
+		*q = t + 3;
+		return ((c & 0x0F) << 12) | ((t[1] & 0x3F) << 6) |
+		    (t[2] & 0x3F);
+	}
+	if ((c & 0xF8) == 0xF0 && e - t >= 4 && (t[1] & 0xC0) == 0x80 &&
+	    (t[2] & 0xC0) == 0x80 && (t[3] & 0xC0) == 0x80) {
+		*q = t + 4;
+		return ((c & 0x07) << 18) | ((t[1] & 0x3F) << 12) |
+		    ((t[2] & 0x3F) << 6) | (t[3] & 0x3F);
+	}
+	return u8next(q, e);
+}
+
+/*
+ * Decode the UTF-8 string from *q up to e into at most n code points
+ * in d.  Escapes are handled as in u82cp().  Move *q past what was
+ * decoded and return the number of code points.
+ * Runs of plain ASCII are copied 16 bytes at a time if SSE2 is there.
+ */
+int
+u82u32(char **q, char *e, unsigned int *d, int n)
+{
+	unsigned char *t = (unsigned char *)*q, *te = (unsigned char *)e;
+	int k = 0;
+#ifdef __SSE2__
+	int m;
+	__m128i v, lo, hi, z = _mm_setzero_si128(), bs = _mm_set1_epi8('\\');
+#endif
+
+	while (k < n && t < te) {
+#ifdef __SSE2__
+		if (k + 16 <= n && te - t >= 16 && *t < 0x80) {
+			v = _mm_loadu_si128((__m128i *)t);
+			if ((m = U8SPECIAL(v, bs)) == 0) {
+				lo = _mm_unpacklo_epi8(v, z);
+				hi = _mm_unpackhi_epi8(v, z);
+				_mm_storeu_si128((__m128i *)&d[k],
+				    _mm_unpacklo_epi16(lo, z));
+				_mm_storeu_si128((__m128i *)&d[k+4],
+				    _mm_unpackhi_epi16(lo, z));
+				_mm_storeu_si128((__m128i *)&d[k+8],
+				    _mm_unpacklo_epi16(hi, z));
+				_mm_storeu_si128((__m128i *)&d[k+12],
+				    _mm_unpackhi_epi16(hi, z));
+				t += 16;
+				k += 16;
+				continue;
+			}
+			/* copy what is in front of the first special byte */
+			for (; (m & 1) == 0; m >>= 1)
+				d[k++] = *t++;
+		}
+#endif
+		if (*t < 0x80 && *t != '\\')
+			d[k++] = *t++;
+		else
+			d[k++] = (unsigned int)u8seq(&t, te);
+	}
+	*q = (char *)t;
+	return k;
+}
+
+/*
+ * As u82u32(), but convert to UTF-16 as cp2u16() does.  A code point
+ * outside the BMP takes two of the n entries, one that cannot be
+ * represented none.
+ */
+int
+u82u16(char **q, char *e, unsigned short *d, int n)
+{
+	unsigned char *t = (unsigned char *)*q, *te = (unsigned char *)e;
+	unsigned short sh[2];
+	unsigned long c;
+	int k = 0;
+#ifdef __SSE2__
+	int m;
+	__m128i v, z = _mm_setzero_si128(), bs = _mm_set1_epi8('\\');
+#endif
+
+	while (k < n - 1 && t < te) {
+#ifdef __SSE2__
+		if (k + 16 <= n && te - t >= 16 && *t < 0x80) {
+			v = _mm_loadu_si128((__m128i *)t);
+			if ((m = U8SPECIAL(v, bs)) == 0) {
+				_mm_storeu_si128((__m128i *)&d[k],
+				    _mm_unpacklo_epi8(v, z));
+				_mm_storeu_si128((__m128i *)&d[k+8],
+				    _mm_unpackhi_epi8(v, z));
+				t += 16;
+				k += 16;
+				continue;
+			}
+			for (; (m & 1) == 0; m >>= 1)
+				d[k++] = *t++;
+			if (k >= n - 1)
+				break;
+		}
+#endif
+		if (*t < 0x80 && *t != '\\') {
+			d[k++] = *t++;
+			continue;
+		}
+		c = u8seq(&t, te);
+		if (c <= 0xFFFF) {
+			if (c < 0xD800 || c > 0xDFFF)
+				d[k++] = (unsigned short)c;
+		} else {
+			cp2u16((long)c, sh);
+			if (sh[0]) {
+				d[k++] = sh[0];
+				d[k++] = sh[1];
+			}
+		}
+	}
+	*q = (char *)t;
+	return k;
+}
+
 /*
  * Create UTF-16 from unicode number.
  * Expects s to point to two words.
@@ -4,6 +4,8 @@
 #define _UNICODE_H
 
 extern long u82cp(char **q);
+extern int u82u32(char **q, char *e, unsigned int *d, int n);
+extern int u82u16(char **q, char *e, unsigned short *d, int n);
 extern void u8error(const char *fmt, ...);
 extern void cp2u16(long num, unsigned short *s);
 
@@ -327,6 +327,80 @@ warner(int type, ...)
 }
 #endif /* MKEXT */
 
+#ifndef MKEXT
+/*
+ * Assembler output.  These append directly to the stdio buffer, so
+ * they may be freely mixed with printf(), but avoid both the format
+ * parsing and the per-call stream locking of the stdio functions.
+ */
+#ifdef _WIN32
+#define	putc_unlocked(c, fp)	putc(c, fp)
+#endif
+
+void
+fputstr(const char *s, FILE *fp)
+{
+	while (*s)
+		putc_unlocked(*s++, fp);
+}
+
+void
+fputchr(int c, FILE *fp)
+{
+	putc_unlocked(c, fp);
+}
+
+/*
+ * Print a signed decimal number.
+ */
+void
+fputnum(CONSZ v, FILE *fp)
+{
+	char buf[24], *s = &buf[sizeof(buf)];
+	U_CONSZ u = v < 0 ? -(U_CONSZ)v : (U_CONSZ)v;
+
+	do {
+		*--s = '0' + (int)(u % 10);
+	} while ((u /= 10) != 0);
+	if (v < 0)
+		*--s = '-';
+	while (s < &buf[sizeof(buf)])
+		putc_unlocked(*s++, fp);
+}
+
+void
+outstr(const char *s)
+{
+	fputstr(s, stdout);
+}
+
+void
+outchr(int c)
+{
+	putc_unlocked(c, stdout);
+}
+
+void
+outnum(CONSZ v)
+{
+	fputnum(v, stdout);
+}
+
+/*
+ * Print a label.  LABFMT is always a prefix followed by "%d".
+ */
+void
+outlab(int l)
+{
+	static const char labfmt[] = LABFMT;
+	const char *s;
+
+	for (s = labfmt; s < &labfmt[sizeof(labfmt) - 3]; s++)
+		putc_unlocked(*s, stdout);
+	fputnum(l, stdout);
+}
+#endif /* MKEXT */
+
 #ifndef MKEXT
 static NODE *freelink;
 int usednodes;
@@ -567,6 +641,12 @@ struct dopest {
 	{ STCALL, "STCALL", BITYPE|CALLFLG, },
 	{ USTCALL, "USTCALL", UTYPE|CALLFLG, },
 	{ ADDROF, "U&", UTYPE, },
+	{ FENCE, "FENCE", UTYPE, },
+	{ XADD, "XADD", BITYPE, },
+	{ XCHG, "XCHG", BITYPE, },
+	{ CMPXCHG, "CMPXCHG", BITYPE, },
+	{ CMOV, "CMOV", BITYPE, },
+	{ MULH, "MULH", BITYPE, },
 
 	{ -1,	"",	0 },
 };
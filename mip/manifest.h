@@ -174,7 +174,8 @@
  */
 extern int gflag, kflag, pflag;
 extern int sspflag;
-extern int xscp, xssa, xtailcall, xtemps, xdeljumps, xdce;
+extern int xscp, xssa, xtailcall, xtemps, xdeljumps, xdce, xifconv, xdelay;
+extern int xpeep, xshrinkwrap;
 extern int xuchar;
 
 int yyparse(void);
@@ -275,6 +276,40 @@ struct interpass { int dummy; };
 struct interpass_prolog;
 #endif /* !MKEXT */
 
+/*
+ * Binary interpass format, used between the passes of a two-pass
+ * compiler unless the text format is asked for.  The file starts
+ * with IPMAGIC and the version number, then follows a sequence of
+ * records, each a tag byte, the payload length and the payload.
+ * Lines starting with anything else than a tag are passed through.
+ *
+ * Numbers are varints, zigzag-encoded if they may be negative
+ * (constants, labels and such).  Strings are either given
+ * inline as length and bytes, or as an index into a string table
+ * where the index of the next new entry is followed by the string.
+ */
+#define	IPMAGIC		"\177pir"
+#define	IPVERSION	1
+
+#define	IPT_PROLOG	1	/* type vis lbl tmpnum lblnum name */
+#define	IPT_NODE	2	/* a tree in preorder */
+#define	IPT_DEFLAB	3	/* label */
+#define	IPT_ASM		4	/* inline string */
+#define	IPT_EPILOG	5	/* autos lbl tmpnum lblnum name #labels labels */
+#define	IPT_LINE	6	/* line number */
+
+/*
+ * Objects written by ccom -flto-write start with LTOMAGIC and the
+ * version number, then follows records framed as above, with all
+ * strings inline.  The source record is always the last one.
+ */
+#define	LTOMAGIC	"\177lto"
+#define	LTOVERSION	1
+
+#define	LTO_FUN		1	/* name flags #refs refs [body] */
+#define	LTO_REFS	2	/* #refs refs, from outside functions */
+#define	LTO_SRC		3	/* the preprocessed source */
+
 /*
  * Epilog/prolog takes following arguments (in order):
  * - type
@@ -310,6 +345,8 @@ void send_passt(int type, ...);
 enum {
 	ATTR_NONE,
 	ATTR_FP_SWAPPED,
+	ATTR_EXPECT,	/* CBRANCH likely taken (1) or not (0) */
+	ATTR_TAILCALL,	/* CALL in tail position, jump to it */
 #ifdef GCC_COMPAT
 	GCC_ATYP_STDCALL,
 	GCC_ATYP_CDECL,
@@ -352,6 +389,15 @@ void *xstrdup(char *s);
 
 int getlab(void);
 
+/* assembler output */
+void outstr(const char *);
+void outchr(int);
+void outnum(CONSZ);
+void outlab(int);
+void fputstr(const char *, FILE *);
+void fputchr(int, FILE *);
+void fputnum(CONSZ, FILE *);
+
 /* command-line processing */
 void mflags(char *);
 
@@ -275,7 +275,7 @@ expand(NODE *p, int cookie, char *cp)
 		switch( *cp ){
 
 		default:
-			putchar(*cp);
+			outchr(*cp);
 			continue;  /* this is the usual case... */
 
 		case 'Z':  /* special machine dependent operations */
@@ -294,13 +294,13 @@ expand(NODE *p, int cookie, char *cp)
 		case 'S':  /* field size */
 			if (fldexpand(p, cookie, &cp))
 				continue;
-			printf("%d", FLDSZ(p->n_rval));
+			outnum(FLDSZ(p->n_rval));
 			continue;
 
 		case 'H':  /* field shift */
 			if (fldexpand(p, cookie, &cp))
 				continue;
-			printf("%d", FLDSHF(p->n_rval));
+			outnum(FLDSHF(p->n_rval));
 			continue;
 
 		case 'M':  /* field mask */
@@ -316,9 +316,9 @@ expand(NODE *p, int cookie, char *cp)
 
 		case 'L':  /* output special label field */
 			if (*++cp == 'C')
-				printf(LABFMT, p->n_label);
+				outlab(p->n_label);
 			else
-				printf(LABFMT, (int)getlval(getlr(p,*cp)));
+				outlab((int)getlval(getlr(p,*cp)));
 			continue;
 
 		case 'O':  /* opcode string */
@@ -358,6 +358,15 @@ expand(NODE *p, int cookie, char *cp)
 
 	}
 
+/*
+ * Print a register name.
+ */
+void
+outreg(int r)
+{
+	outstr(rnames[r]);
+}
+
 NODE resc[NRESC];
 
 NODE *
@@ -431,7 +440,7 @@ swmatch(NODE *p, int shape, int w)
 		} else
 			offstar(p->n_left, shape);
 		p->n_su = 0;
-		rv = ffs(shape)-1;
+		rv = COOKCLASS(shape);
 		break;
 
 	case 0:
@@ -639,7 +648,7 @@ findops(NODE *p, int cookie)
 		if (cookie == FOREFF || cookie == FORCC)
 			sh = 0;
 		else
-			sh = ffs(cookie & qq->visit & INREGS)-1;
+			sh = COOKCLASS(cookie & qq->visit & INREGS);
 	}
 	F2DEBUG(("findops: node %p sh %d (%s)\n", p, sh, prcook(1 << sh)));
 	p->n_su = MKIDX(idx, 0);
@@ -734,9 +743,9 @@ relops(NODE *p)
 
 	sh = 0;
 	if (q->rewrite & RLEFT)
-		sh = ffs(q->lshape & INREGS)-1;
+		sh = COOKCLASS(q->lshape & INREGS);
 	else if (q->rewrite & RRIGHT)
-		sh = ffs(q->rshape & INREGS)-1;
+		sh = COOKCLASS(q->rshape & INREGS);
 
 	F2DEBUG(("relops: node %p\n", p));
 	p->n_su = MKIDX(idx, 0);
@@ -855,7 +864,7 @@ findasg(NODE *p, int cookie)
 	else if (cookie == FORCC)
 		lvl = RVCC, sh = 0;
 	else if (sh == -1) {
-		sh = ffs(cookie & qq->visit & INREGS)-1;
+		sh = COOKCLASS(cookie & qq->visit & INREGS);
 #ifdef PCC_DEBUG
 		if (sh == -1)
 			comperr("findasg bad shape");
@@ -869,7 +878,7 @@ findasg(NODE *p, int cookie)
 		if (cookie == FOREFF)
 			sh = 0;
 		else
-			sh = ffs(cookie & qq->visit & INREGS)-1;
+			sh = COOKCLASS(cookie & qq->visit & INREGS);
 	}
 	F2DEBUG(("findasg: node %p class %d\n", p, sh));
 
@@ -945,7 +954,7 @@ findumul(NODE *p, int cookie)
 
 	sh = shswitch(-1, p, q->rshape, cookie, q->rewrite & RLEFT, shl);
 	if (sh == -1)
-		sh = ffs(cookie & q->visit & INREGS)-1;
+		sh = COOKCLASS(cookie & q->visit & INREGS);
 
 	F2DEBUG(("findumul: node %p (%s)\n", p, prcook(1 << sh)));
 	p->n_su = MKIDX(ixp[i], 0);
@@ -1005,7 +1014,7 @@ findleaf(NODE *p, int cookie)
 	}
 	F2DEBUG(("findleaf entry %d\n", ixp[i]));
 
-	sh = ffs(cookie & q->visit & INREGS)-1;
+	sh = COOKCLASS(cookie & q->visit & INREGS);
 	F2DEBUG(("findleaf: node %p (%s)\n", p, prcook(1 << sh)));
 	p->n_su = MKIDX(ixp[i], 0);
 	SCLASS(p->n_su, sh);
@@ -1098,7 +1107,7 @@ finduni(NODE *p, int cookie)
 	sh = shswitch(-1, p->n_left, q->lshape, cookie,
 	    q->rewrite & RLEFT, num);
 	if (sh == -1)
-		sh = ffs(cookie & q->visit & INREGS)-1;
+		sh = COOKCLASS(cookie & q->visit & INREGS);
 	if (sh == -1)
 		sh = 0;
 
@@ -1243,7 +1252,7 @@ findmops(NODE *p, int cookie)
 		if (cookie & (FOREFF|FORCC))
 			sh = 0;
 		else
-			sh = ffs(cookie & qq->visit & INREGS)-1;
+			sh = COOKCLASS(cookie & qq->visit & INREGS);
 	}
 	F2DEBUG(("findmops done: node %p class %d\n", p, sh));
 
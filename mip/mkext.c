@@ -134,7 +134,7 @@ getrcl(struct optab *q)
 	while ((w = hasneed(w, cNREG))) {
 		if ((i += w[2]) >= r)
 			return c[(int)w[1]];
-		w += 2;
+		w += NEEDADD(*w);
 	}
 	return 0;
 }
@@ -140,6 +140,7 @@ typedef struct node {
  * Value nodes.
  */
 #define NAME	2
+#define	FENCE	3	/* memory barrier, kind in left ICON */
 #define ICON	4
 #define FCON	5
 #define REG	6
@@ -166,6 +167,12 @@ typedef struct node {
 #define RS	19
 #define COMPL	20
 
+/*
+ * Atomic operations.  Left is the pointer to the object.
+ */
+#define	XADD	21	/* fetch-and-add, returns old value */
+#define	XCHG	22	/* exchange, returns old value */
+
 #define UMUL	23
 #define UMINUS	24
 
@@ -219,9 +226,19 @@ typedef struct node {
 #define XASM	53
 #define	GOTO	54
 #define	RETURN	55
+#define	CMPXCHG	56	/* compare-and-swap, right is CM(old, new) */
 #define	FUNARG	57
 #define	ADDROF	58
+#define	CMOV	59	/* conditional move, see ifconvert() */
+#define	MULH	60	/* high half of a full-width multiply */
 
-#define	MAXOP	58
+#define	MAXOP	60
+
+/*
+ * Kinds of FENCE.
+ */
+#define	FENCE_FULL	0	/* full barrier */
+#define	FENCE_ACQ	1	/* after an acquire load */
+#define	FENCE_REL	2	/* before a release store */
 
 #endif
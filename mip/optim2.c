@@ -671,6 +671,694 @@ deljumps(struct p2env *p2e)
 	markfree(&mark);
 }
 
+/*
+ * Move code that __builtin_expect() says is unlikely to run to the end
+ * of the function, so that the likely path falls through.  Hinted
+ * CBRANCH nodes carry ATTR_EXPECT, 1 if the branch is likely taken and
+ * 0 if not.  If taken, the code between the branch and its label is
+ * moved out and the branch reversed.  If not taken and the label starts
+ * the else part of an if-else, the else part is moved out instead:
+ *
+ *	CBRANCH(rel, L1)		CBRANCH(rel, L1)
+ *	a				a
+ *	GOTO L2				L2:
+ *	L1:				...
+ *	b				GOTO R
+ *	L2:				L1:
+ *	...				b
+ *	R:				GOTO L2
+ *					R:
+ *
+ * The moved code is put just before the return label R, with GOTOs
+ * added where it used to fall through.
+ */
+void
+coldmove(struct p2env *p2e)
+{
+	extern int negrel[];
+	struct interpass *ipole = &p2e->ipole;
+	struct interpass *ip, *ipn, *ipb, *ipe, *ipl, *ipr, *end;
+	struct attr *ap;
+	NODE *p;
+	int lbl, o;
+
+	for (ipr = DLIST_PREV(ipole, qelem); ipr != ipole;
+	    ipr = DLIST_PREV(ipr, qelem))
+		if (ipr->type == IP_DEFLAB && ipr->ip_lbl == p2e->epp->ipp_ip.ip_lbl)
+			break;
+	if (ipr == ipole)
+		return;
+
+	end = ipr; /* start of the moved code */
+	for (ip = DLIST_NEXT(ipole, qelem); ip != end; ip = ipn) {
+		ipn = DLIST_NEXT(ip, qelem);
+		if (ip->type != IP_NODE || (p = ip->ip_node)->n_op != CBRANCH ||
+		    (ap = attr_find(p->n_ap, ATTR_EXPECT)) == NULL)
+			continue;
+		lbl = (int)getlval(p->n_right);
+		for (ipl = ipn; ipl != end; ipl = DLIST_NEXT(ipl, qelem))
+			if (ipl->type == IP_DEFLAB && ipl->ip_lbl == lbl)
+				break;
+		if (ipl == end)
+			continue;
+		if (ap->iarg(0)) {
+			o = p->n_left->n_op;
+			if (ipl == ipn || o < EQ || o > UGT ||
+			    (p->n_left->n_left->n_type >= FLOAT &&
+			    p->n_left->n_left->n_type <= LDOUBLE))
+				continue; /* keep NaN behaviour */
+			p->n_left->n_op = negrel[o - EQ];
+			ipb = tmpalloc(sizeof(struct interpass));
+			ipb->type = IP_DEFLAB;
+			ipb->lineno = ipn->lineno;
+			ipb->ip_lbl = getlab2();
+			setlval(p->n_right, ipb->ip_lbl);
+			DLIST_INSERT_BEFORE(ipn, ipb, qelem);
+			ipe = DLIST_PREV(ipl, qelem);
+			ipn = ipl;
+		} else {
+			ipe = DLIST_PREV(ipl, qelem);
+			if (ipe->type != IP_NODE || ipe->ip_node->n_op != GOTO ||
+			    ipe->ip_node->n_left->n_op != ICON)
+				continue;
+			lbl = (int)getlval(ipe->ip_node->n_left);
+			for (ipb = ipl; ipb != end; ipb = DLIST_NEXT(ipb, qelem))
+				if (ipb->type == IP_DEFLAB && ipb->ip_lbl == lbl)
+					break;
+			if (ipb == end || ipb == DLIST_NEXT(ipl, qelem))
+				continue; /* e.g. a loop exit */
+			tfree(ipe->ip_node);
+			DLIST_REMOVE(ipe, qelem);
+			ipn = ipb;
+			ipb = ipl;
+			ipe = DLIST_PREV(ipn, qelem);
+		}
+		if (ipe->type != IP_NODE || ipe->ip_node->n_op != GOTO) {
+			ip = ipnode(mkunode(GOTO,
+			    mklnode(ICON, lbl, 0, INT), 0, INT));
+			DLIST_INSERT_AFTER(ipe, ip, qelem);
+			ipe = ip;
+		}
+		if (end == ipr) {
+			/* first moved; hot code must not fall into it */
+			ip = DLIST_PREV(ipr, qelem);
+			if (ip->type != IP_NODE || ip->ip_node->n_op != GOTO) {
+				ip = ipnode(mkunode(GOTO,
+				    mklnode(ICON, ipr->ip_lbl, 0, INT), 0, INT));
+				DLIST_INSERT_BEFORE(ipr, ip, qelem);
+			}
+			end = ipb;
+		}
+		/* unlink ipb..ipe and put it before the return label */
+		ipe = DLIST_NEXT(ipe, qelem);
+		while (ipb != ipe) {
+			ip = DLIST_NEXT(ipb, qelem);
+			DLIST_REMOVE(ipb, qelem);
+			DLIST_INSERT_BEFORE(ipr, ipb, qelem);
+			ipb = ip;
+		}
+	}
+}
+
+#ifdef CONDMOVE
+/*
+ * If-conversion of short branches around register moves, done after
+ * register allocation.  Two shapes are recognized:
+ *
+ *	CBRANCH(rel, L)			CBRANCH(rel, L1)
+ *	x = a				x = a
+ *	L:				GOTO L2
+ *					L1:
+ *					x = b
+ *					L2:
+ *
+ * The first becomes CMOV(!rel, x = a), the second CMOV(rel, (x = a, x = b)),
+ * where the leftmost move of a CM is done unconditionally.  Whether a move
+ * can be made conditional is asked to the target via cmovok(), and the
+ * instructions are printed by cmovgen() from emit().
+ */
+static struct interpass *
+ipnext(struct interpass *ip, int type, int op)
+{
+	ip = DLIST_NEXT(ip, qelem);
+	if (ip->type != type)
+		return NULL;
+	if (type == IP_NODE && ip->ip_node->n_op != op)
+		return NULL;
+	return ip;
+}
+
+void
+ifconvert(struct p2env *p2e)
+{
+	extern int negrel[];
+	struct interpass *ipole = &p2e->ipole;
+	struct interpass *ip, *ipa, *ipg, *ipl1, *ipb, *ipl2;
+	NODE *p, *rel, *a, *b;
+	int *refs, *l, low, high, lbl, o;
+
+	/* count label references; labels used elsewhere are never moved */
+	low = high = 0;
+	DLIST_FOREACH(ip, ipole, qelem) {
+		if (ip->type != IP_DEFLAB)
+			continue;
+		if (low == 0 || ip->ip_lbl < low)
+			low = ip->ip_lbl;
+		if (ip->ip_lbl >= high)
+			high = ip->ip_lbl + 1;
+	}
+	if (low == 0)
+		return;
+	refs = tmpcalloc(sizeof(int) * (high - low));
+	DLIST_FOREACH(ip, ipole, qelem) {
+		if (ip->type != IP_NODE)
+			continue;
+		p = ip->ip_node;
+		if (p->n_op == CBRANCH)
+			p = p->n_right;
+		else if (p->n_op == GOTO && p->n_left->n_op == ICON)
+			p = p->n_left;
+		else
+			continue;
+		lbl = (int)getlval(p);
+		if (lbl >= low && lbl < high)
+			refs[lbl - low]++;
+	}
+	for (l = p2e->epp->ip_labels; *l; l++)
+		if (*l >= low && *l < high)
+			refs[*l - low] += 2;
+
+	DLIST_FOREACH(ip, ipole, qelem) {
+		if (ip->type != IP_NODE || ip->ip_node->n_op != CBRANCH)
+			continue;
+		p = ip->ip_node;
+		rel = p->n_left;
+		o = rel->n_op;
+		if (o < EQ || o > UGT || TBLIDX(rel->n_su) == 0 ||
+		    (table[TBLIDX(rel->n_su)].rewrite & RESCC) == 0)
+			continue;
+		lbl = (int)getlval(p->n_right);
+		if (lbl < low || lbl >= high)
+			continue;
+		if ((ipa = ipnext(ip, IP_NODE, ASSIGN)) == NULL ||
+		    !cmovok(rel, a = ipa->ip_node))
+			continue;
+
+		if ((ipl1 = ipnext(ipa, IP_DEFLAB, 0)) != NULL) {
+			if (ipl1->ip_lbl != lbl)
+				continue;
+			rel->n_op = negrel[o - EQ];
+			nfree(p->n_right);
+			p->n_right = a;
+			DLIST_REMOVE(ipa, qelem);
+			if (refs[lbl - low] == 1)
+				DLIST_REMOVE(ipl1, qelem);
+		} else {
+			if ((ipg = ipnext(ipa, IP_NODE, GOTO)) == NULL ||
+			    ipg->ip_node->n_left->n_op != ICON ||
+			    (ipl1 = ipnext(ipg, IP_DEFLAB, 0)) == NULL ||
+			    ipl1->ip_lbl != lbl || refs[lbl - low] != 1 ||
+			    (ipb = ipnext(ipl1, IP_NODE, ASSIGN)) == NULL ||
+			    (ipl2 = ipnext(ipb, IP_DEFLAB, 0)) == NULL ||
+			    ipl2->ip_lbl != getlval(ipg->ip_node->n_left))
+				continue;
+			b = ipb->ip_node;
+			if (!cmovok(rel, b) || a->n_type != b->n_type ||
+			    a->n_left->n_rval != b->n_left->n_rval ||
+			    (b->n_right->n_op == REG &&
+			    b->n_right->n_rval == a->n_left->n_rval))
+				continue;
+			nfree(p->n_right);
+			p->n_right = mkbinode(CM, a, b, a->n_type);
+			tfree(ipg->ip_node);
+			refs[ipl2->ip_lbl - low]--;
+			DLIST_REMOVE(ipa, qelem);
+			DLIST_REMOVE(ipg, qelem);
+			DLIST_REMOVE(ipl1, qelem);
+			DLIST_REMOVE(ipb, qelem);
+			if (refs[ipl2->ip_lbl - low] == 0)
+				DLIST_REMOVE(ipl2, qelem);
+		}
+		p->n_op = CMOV;
+		p->n_type = a->n_type;
+	}
+}
+#endif
+
+#ifdef TAILCALL
+/*
+ * Tail-call optimization, done after register allocation.  A call
+ * that is only followed by labels and jumps on the way to the epilog,
+ * and whose value (if any) is already left in the return register,
+ * gets ATTR_TAILCALL and the jump after it is removed.  The target then
+ * tears down the frame and jumps to the called function instead of
+ * calling it.  Whether the arguments of a call fit in the frame of the
+ * caller is asked to the target via tailcallok().
+ *
+ * Nothing is done if the frame may be referenced by the called
+ * function; that is, if the address of anything on the stack is taken.
+ */
+static int
+frameaddr(NODE *p)
+{
+	int o = p->n_op;
+
+	if (o == ADDROF)
+		return 1;
+	if (o == REG && (regno(p) == FPREG || regno(p) == STKREG))
+		return 1;
+	if (optype(o) == BITYPE && frameaddr(p->n_right))
+		return 1;
+	if (optype(o) != LTYPE)
+		return frameaddr(p->n_left);
+	return 0;
+}
+
+/*
+ * Return 1 if lbl may be jumped to.
+ */
+static int
+labref(struct p2env *p2e, int lbl)
+{
+	struct interpass *ip;
+	NODE *p;
+
+	if (inuse(p2e, lbl))
+		return 1;
+	DLIST_FOREACH(ip, &p2e->ipole, qelem) {
+		if (ip->type != IP_NODE)
+			continue;
+		p = ip->ip_node;
+		if (p->n_op == GOTO && (p->n_left->n_op != ICON ||
+		    getlval(p->n_left) == lbl))
+			return 1;
+		if (p->n_op == CBRANCH && getlval(p->n_right) == lbl)
+			return 1;
+	}
+	return 0;
+}
+
+/*
+ * Return 1 if nothing but labels and jumps follow ip until the epilog.
+ */
+static int
+istail(struct interpass *ipole, struct interpass *ip)
+{
+	struct interpass *ipl;
+	NODE *p;
+	int n;
+
+	for (n = 0; n < 10; ) {
+		ip = DLIST_NEXT(ip, qelem);
+		if (ip->type == IP_EPILOG)
+			return 1;
+		if (ip->type == IP_DEFLAB)
+			continue;
+		if (ip->type != IP_NODE)
+			return 0;
+		p = ip->ip_node;
+		if (p->n_op != GOTO || p->n_left->n_op != ICON)
+			return 0;
+		DLIST_FOREACH(ipl, ipole, qelem)
+			if (ipl->type == IP_DEFLAB &&
+			    ipl->ip_lbl == getlval(p->n_left))
+				break;
+		if (ipl == ipole)
+			return 0;
+		ip = ipl;
+		n++;
+	}
+	return 0; /* probably a loop */
+}
+
+void
+tailcall(struct p2env *p2e)
+{
+	struct interpass *ipole = &p2e->ipole;
+	struct interpass *ip, *ipn;
+	NODE *p, *l;
+	int t = p2e->ipp->ipp_type;
+
+	if (t == STRTY || t == UNIONTY)
+		return;
+	DLIST_FOREACH(ip, ipole, qelem)
+		if (ip->type == IP_NODE && frameaddr(ip->ip_node))
+			return;
+
+	DLIST_FOREACH(ip, ipole, qelem) {
+		if (ip->type != IP_NODE)
+			continue;
+		p = ip->ip_node;
+		if (p->n_op == ASSIGN) {
+			l = p->n_left;
+			p = p->n_right;
+			if (l->n_op != REG || l->n_type != p->n_type ||
+			    regno(l) != RETREG(p->n_type) ||
+			    regno(l) != RETREG(t))
+				continue;
+		} else if (p->n_type >= FLOAT && p->n_type <= LDOUBLE)
+			continue; /* value may have to be popped */
+		if ((p->n_op != CALL && p->n_op != UCALL) ||
+		    !istail(ipole, ip) || !tailcallok(p2e->epp, p))
+			continue;
+		p->n_ap = attr_add(p->n_ap, attr_new(ATTR_TAILCALL, 1));
+		ipn = DLIST_NEXT(ip, qelem);
+		if (ipn->type == IP_NODE && ipn->ip_node->n_op == GOTO) {
+			tfree(ipn->ip_node);
+			DLIST_REMOVE(ipn, qelem);
+		}
+	}
+
+	/*
+	 * If the last statement is a tail call and the labels after it
+	 * are not jumped to, the epilog is never reached.
+	 */
+	for (ip = DLIST_PREV(&p2e->epp->ipp_ip, qelem); ip->type == IP_DEFLAB;
+	    ip = DLIST_PREV(ip, qelem))
+		if (labref(p2e, ip->ip_lbl))
+			return;
+	if (ip->type != IP_NODE)
+		return;
+	p = ip->ip_node;
+	if (p->n_op == ASSIGN)
+		p = p->n_right;
+	if (callop(p->n_op) && attr_find(p->n_ap, ATTR_TAILCALL))
+		p2e->p_tailend = 1;
+}
+#endif
+
+#ifdef SHRINKWRAP
+/*
+ * Shrink-wrapping, done by the target from its prologue when the
+ * registers to save are known.  Functions often start with an early
+ * return that uses none of the callee-saved registers, but still pay
+ * for saving and restoring them.
+ *
+ * The function is split into a head that does not use the saved
+ * registers (as told by the target via regsuse()) and the rest.
+ * The head may only be left by falling into the rest or by jumping to
+ * the return label, and the rest may never jump back into the head.
+ * The registers are then saved first in the rest, and the jumps from
+ * the head to the return label are pointed to a new label, which the
+ * target puts after the restores.
+ *
+ * Arguments passed in registers are usually copied to saved registers
+ * first thing in the function.  Such copies are moved down after the
+ * saves, and the head uses the argument registers instead, as long as
+ * it neither calls anything nor writes to them.
+ *
+ * The basic blocks of optimize() are not used; they are not kept up
+ * to date across register allocation, and the two conditions on the
+ * jumps are all that is needed of the flow graph here.
+ *
+ * Returns the new label, or 0 if nothing was done.  save is the code
+ * that saves the registers.
+ */
+#define	SWCOPY	8	/* max argument copies moved */
+
+static struct interpass *swcip[SWCOPY];
+static int swfrom[SWCOPY], swto[SWCOPY], swn;
+static bittype swargs[BIT2BYTE(MAXREGS)];
+
+static int
+swlabel(NODE *p)
+{
+	if (p->n_op == GOTO)
+		return p->n_left->n_op == ICON ? (int)getlval(p->n_left) : -2;
+	if (p->n_op == CBRANCH)
+		return (int)getlval(p->n_right);
+	return -1;
+}
+
+/*
+ * Other things that must stay after the saves.
+ */
+static int
+swuse(NODE *p)
+{
+	int o = p->n_op;
+
+	if (o == XASM || (callop(o) &&
+	    (swn || attr_find(p->n_ap, ATTR_TAILCALL))))
+		return 1;
+	if (optype(o) == BITYPE && swuse(p->n_right))
+		return 1;
+	if (optype(o) != LTYPE)
+		return swuse(p->n_left);
+	return 0;
+}
+
+/*
+ * Is p a copy of an argument register to a saved register?
+ */
+static int
+swcopy(NODE *p)
+{
+	int i, l, r;
+
+	if (p->n_op != ASSIGN || p->n_left->n_op != REG ||
+	    p->n_right->n_op != REG || swn == SWCOPY)
+		return 0;
+	l = regno(p->n_left);
+	r = regno(p->n_right);
+	if (!TESTBIT(p2env.p_regs, l) || TESTBIT(p2env.p_regs, r) ||
+	    r == FPREG || r == STKREG)
+		return 0;
+	for (i = 0; i < swn; i++)
+		if (swfrom[i] == l || swto[i] == r)
+			return 0;
+	return 1;
+}
+
+static void
+swrepl(NODE *p, int f, int t)
+{
+	if ((p->n_op == REG || p->n_op == OREG) && regno(p) == f)
+		regno(p) = t;
+	if (optype(p->n_op) == BITYPE)
+		swrepl(p->n_right, f, t);
+	if (optype(p->n_op) != LTYPE)
+		swrepl(p->n_left, f, t);
+}
+
+/*
+ * Does p assign to a saved or argument register?
+ */
+static int
+swwrite(NODE *p)
+{
+	int o = p->n_op;
+
+	if (o == ASSIGN && p->n_left->n_op == REG &&
+	    (TESTBIT(p2env.p_regs, regno(p->n_left)) ||
+	    TESTBIT(swargs, regno(p->n_left))))
+		return 1;
+	if (optype(o) == BITYPE && swwrite(p->n_right))
+		return 1;
+	if (optype(o) != LTYPE)
+		return swwrite(p->n_left);
+	return 0;
+}
+
+/*
+ * May p be in the head?  If so, it is rewritten to use the
+ * argument registers instead of their copies.
+ */
+static int
+swhead(NODE *p)
+{
+	int i;
+
+	if (swuse(p) || swwrite(p) || regsuse(p, swargs, 1))
+		return 0;
+	for (i = 0; i < swn; i++)
+		swrepl(p, swfrom[i], swto[i]);
+	if (regsuse(p, p2env.p_regs, 1) || regsuse(p, swargs, 0)) {
+		for (i = 0; i < swn; i++)
+			swrepl(p, swto[i], swfrom[i]);
+		return 0;
+	}
+	return 1;
+}
+
+/*
+ * Undo the rewrite of the first h nodes.
+ */
+static void
+swundo(struct interpass *ipole, int h)
+{
+	struct interpass *ip;
+	int i, n;
+
+	n = 0;
+	DLIST_FOREACH(ip, ipole, qelem) {
+		if (ip->type == IP_PROLOG)
+			continue;
+		if (n++ == h)
+			break;
+		if (ip->type != IP_NODE)
+			continue;
+		for (i = 0; i < swn; i++)
+			if (ip == swcip[i])
+				break;
+		if (i < swn)
+			continue;
+		for (i = 0; i < swn; i++)
+			swrepl(ip->ip_node, swto[i], swfrom[i]);
+	}
+}
+
+int
+shrinkwrap(struct p2env *p2e, char *save)
+{
+	struct interpass *ipole = &p2e->ipole;
+	struct interpass *ip, **ips;
+	int retlab = p2e->epp->ipp_ip.ip_lbl;
+	int *pos, *tgt;
+	int low, high, n, s, h, cp, bad, i, j, l, ch;
+	NODE *p;
+
+	if (*save == 0)
+		return 0;
+
+	/* find the first use, and the range of labels */
+	memset(swargs, 0, sizeof(swargs));
+	swn = 0;
+	n = 0;
+	s = -1;
+	cp = 1;
+	bad = 0;
+	low = high = retlab;
+	DLIST_FOREACH(ip, ipole, qelem) {
+		if (ip->type == IP_EPILOG ||
+		    (ip->type == IP_DEFLAB && ip->ip_lbl == retlab))
+			break;
+		switch (ip->type) {
+		case IP_PROLOG:
+			continue;
+		case IP_DEFLAB:
+			if (ip->ip_lbl < low)
+				low = ip->ip_lbl;
+			if (ip->ip_lbl > high)
+				high = ip->ip_lbl;
+			break;
+		case IP_NODE:
+			p = ip->ip_node;
+			if (swlabel(p) == -2)
+				bad = 1; /* computed goto */
+			if (s >= 0)
+				break;
+			if (cp && swcopy(p)) {
+				swcip[swn] = ip;
+				swfrom[swn] = regno(p->n_left);
+				swto[swn] = regno(p->n_right);
+				BITSET(swargs, swto[swn]);
+				swn++;
+			} else {
+				cp = 0;
+				if (!swhead(p))
+					s = n;
+			}
+			break;
+		case IP_ASM:
+			break; /* basic asm may not change registers */
+		default:
+			if (s < 0)
+				s = n;
+			break;
+		}
+		n++;
+	}
+	if ((h = s) < 0)
+		h = n;
+	if (bad || s <= 0 || (ip->type != IP_EPILOG &&
+	    DLIST_NEXT(ip, qelem)->type != IP_EPILOG))
+		goto undo;
+
+	ips = tmpalloc(n * sizeof(struct interpass *));
+	tgt = tmpalloc(n * sizeof(int));
+	pos = tmpalloc((high - low + 1) * sizeof(int));
+	for (i = 0; i < high - low + 1; i++)
+		pos[i] = -1;
+	i = 0;
+	DLIST_FOREACH(ip, ipole, qelem) {
+		if (ip->type == IP_PROLOG)
+			continue;
+		if (i == n)
+			break;
+		if (ip->type == IP_DEFLAB)
+			pos[ip->ip_lbl - low] = i;
+		ips[i++] = ip;
+	}
+	for (i = 0; i < n; i++) {
+		tgt[i] = -1;
+		if (ips[i]->type != IP_NODE ||
+		    (l = swlabel(ips[i]->ip_node)) < 0)
+			continue;
+		if (l == retlab)
+			tgt[i] = n;
+		else if (l < low || l > high || (tgt[i] = pos[l - low]) < 0)
+			goto undo;
+	}
+
+	/* move the split up until no jumps cross it */
+	do {
+		ch = 0;
+		for (i = 0; i < n; i++) {
+			if (tgt[i] < 0 || tgt[i] == n)
+				continue;
+			if (i < s && tgt[i] >= s) {
+				s = i;
+				ch = 1;
+			} else if (i >= s && tgt[i] < s) {
+				s = tgt[i];
+				ch = 1;
+			}
+		}
+	} while (ch && s > 0);
+
+	/* the copies must all stay in the head */
+	for (i = 0; i < s; i++)
+		if (swn && ips[i] == swcip[swn-1])
+			break;
+	if (swn && i == s)
+		goto undo;
+	for (i = 0; i < s; i++)
+		if (tgt[i] == n)
+			break;
+	if (i == s)
+		goto undo; /* no early return */
+
+	/* the head is only rewritten up to the split */
+	for (i = s; i < h; i++)
+		if (ips[i]->type == IP_NODE)
+			for (j = 0; j < swn; j++)
+				swrepl(ips[i]->ip_node, swto[j], swfrom[j]);
+
+	l = getlab2();
+	for (i = 0; i < s; i++) {
+		if (tgt[i] != n)
+			continue;
+		p = ips[i]->ip_node;
+		setlval(p->n_op == GOTO ? p->n_left : p->n_right, l);
+	}
+	ip = tmpalloc(sizeof(struct interpass));
+	ip->type = IP_ASM;
+	ip->lineno = ips[s]->lineno;
+	ip->ip_asm = save;
+	DLIST_INSERT_BEFORE(ips[s], ip, qelem);
+	for (i = 0; i < swn; i++) {
+		DLIST_REMOVE(swcip[i], qelem);
+		DLIST_INSERT_BEFORE(ips[s], swcip[i], qelem);
+	}
+	return l;
+
+undo:
+	swundo(ipole, h);
+	return 0;
+}
+#endif
+
 void
 optdump(struct interpass *ip)
 {
@@ -48,7 +48,6 @@ typedef unsigned int bittype; /* XXX - for basicblock */
 #define INBREG	04		/* compute into a register */
 #define INCREG	010		/* compute into a register */
 #define INDREG	020		/* compute into a register */
-#define	INREGS	(INAREG|INBREG|INCREG|INDREG)
 #define FORCC	040		/* compute for condition codes only */
 #define QUIET	0100		/* tell geninsn() to not complain if fail */
 #define INTEMP	010000		/* compute into a temporary location */
@@ -56,6 +55,13 @@ typedef unsigned int bittype; /* XXX - for basicblock */
 #define INEREG	0x10000		/* compute into a register, > 16 bits */
 #define INFREG	0x20000		/* compute into a register, > 16 bits */
 #define INGREG	0x40000		/* compute into a register, > 16 bits */
+#if NUMCLASS > 4
+#define	INREGS	(INAREG|INBREG|INCREG|INDREG|INEREG)
+#else
+#define	INREGS	(INAREG|INBREG|INCREG|INDREG)
+#endif
+/* register class for a cookie, INEREG and up are above bit 16 */
+#define	COOKCLASS(x)	(ffs(x) > 16 ? ffs(x) - 12 : ffs(x) - 1)
 
 /*
  * OP descriptors,
@@ -297,6 +303,37 @@ int relops(NODE *p);
 int findmops(NODE *p, int);
 int treecmp(NODE *p1, NODE *p2);
 #endif
+#ifdef CONDMOVE
+int cmovok(NODE *rel, NODE *p);
+void cmovgen(int op, NODE *p);
+#endif
+#ifdef TAILCALL
+int tailcallok(struct interpass_prolog *, NODE *p);
+#endif
+#ifdef SHRINKWRAP
+int regsuse(NODE *p, bittype *regs, int leaves);
+#endif
+#ifdef ASMOPT
+void myasmopt(char **lines, int nlines);
+#endif
+#ifdef PEEPHOLE
+#define	PEEPMAX	4	/* max lines in a peephole pattern */
+struct peep {
+	char *name;			/* shown with -s */
+	char *pat[PEEPMAX+1];		/* lines to match */
+	char *rep[PEEPMAX+1];		/* what they are replaced with */
+	int (*cond)(char **v);		/* extra check of @0-@9, or NULL */
+	int cnt;			/* times done */
+};
+extern struct peep peeptab[];
+void peephole(char **lines, int nlines);
+void peepstats(void);
+#endif
+#if defined(ASMOPT) || defined(PEEPHOLE)
+#define	ASMCAPT			/* collect function output, see asmrelease() */
+#define	ASMBEG	"\001"	/* inline assembler starts */
+#define	ASMEND	"\002"	/* inline assembler ends */
+#endif
 void offstar(NODE *p, int shape);
 int gclass(TWORD);
 void lastcall(NODE *);
@@ -323,6 +360,7 @@ void conput(FILE *, NODE *);
 int shtemp(NODE *p);
 int ttype(TWORD t, int tword);
 void expand(NODE *, int, char *);
+void outreg(int);
 void hopcode(int, int);
 void adrcon(CONSZ);
 void zzzcode(NODE *, int);
@@ -474,6 +512,16 @@ callop(int o)
 
 void emit(struct interpass *);
 void optimize(struct p2env *);
+void coldmove(struct p2env *);
+#ifdef CONDMOVE
+void ifconvert(struct p2env *);
+#endif
+#ifdef TAILCALL
+void tailcall(struct p2env *);
+#endif
+#ifdef SHRINKWRAP
+int shrinkwrap(struct p2env *, char *);
+#endif
 
 struct basicblock {
 	DLIST_ENTRY(basicblock) bbelem;
@@ -559,6 +607,9 @@ struct p2env {
 	int nbblocks;
 #define NIPPREGS        BIT2BYTE(MAXREGS)/sizeof(bittype)
 	bittype p_regs[NIPPREGS];	/* Bitmask of registers to save */
+#ifdef TAILCALL
+	int p_tailend;			/* ends in a tail jump, no epilog */
+#endif
 };
 
 extern struct p2env p2env;
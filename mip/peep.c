@@ -0,0 +1,202 @@
+/*	$Id$	*/
+
+/*
+ * Table-driven peephole optimizer, run on the assembler output of a
+ * function before it is printed (see asmrelease()) if -xpeep is given.
+ *
+ * Each target lists its patterns in peeptab[].  A pattern is up to
+ * PEEPMAX consecutive lines; instructions are written with a leading
+ * tab, labels without.  In a pattern a blank matches any amount of
+ * white space, and @0-@9 match an operand, which may contain commas
+ * only inside brackets.  An operand ends where the character following
+ * it in the pattern is found.  A variable seen again must match the same
+ * text.  If the lines match and cond() accepts the operands, the lines
+ * are replaced with the rep lines, with @0-@9 substituted.  There may
+ * be no more of those than lines matched, and a line equal to its
+ * pattern is left as it is.  A trailing comment on a line does not
+ * prevent a match, but it is lost if the line is replaced.  Matching
+ * restarts a few lines back after each change, so patterns may build
+ * on each other.
+ */
+
+#include "pass2.h"
+
+#include <string.h>
+#include <ctype.h>
+
+#ifdef PEEPHOLE
+
+#define	PEEPVARS	10
+#define	PEEPLEN		64	/* longest operand matched */
+
+static char peepvar[PEEPVARS][PEEPLEN];
+static char *peepv[PEEPVARS];
+static char peepcom[8];		/* starts a comment */
+
+/*
+ * Match line s against pattern p.
+ */
+static int
+peepmatch(char *p, char *s)
+{
+	char *b;
+	int n, d, c;
+
+	if (*p == '\t') {
+		if (!isspace((unsigned char)*s))
+			return 0;
+		p++;
+	} else if (isspace((unsigned char)*s))
+		return 0;
+	while (isspace((unsigned char)*s))
+		s++;
+
+	for (; *p; p++) {
+		if (*p == ' ') {
+			if (!isspace((unsigned char)*s))
+				return 0;
+			while (isspace((unsigned char)*s))
+				s++;
+		} else if (*p == '@' && isdigit((unsigned char)p[1])) {
+			n = *++p - '0';
+			if (peepv[n] != NULL) {
+				c = strlen(peepv[n]);
+				if (strncmp(s, peepv[n], c) != 0)
+					return 0;
+				s += c;
+				continue;
+			}
+			for (b = s, d = 0; *s; s++) {
+				if (d == 0 && (*s == p[1] || isspace((unsigned char)*s)))
+					break;
+				if (*s == '(' || *s == '[' || *s == '{')
+					d++;
+				else if (d > 0 && (*s == ')' || *s == ']' || *s == '}'))
+					d--;
+			}
+			if (s - b >= PEEPLEN)
+				return 0;
+			strncpy(peepvar[n], b, s - b);
+			peepvar[n][s - b] = 0;
+			peepv[n] = peepvar[n];
+		} else if (*p != *s)
+			return 0;
+		else
+			s++;
+	}
+	for (b = s; isspace((unsigned char)*s); s++)
+		;
+	if (*s == 0)
+		return 1;
+	return s > b && strncmp(s, peepcom, strlen(peepcom)) == 0;
+}
+
+/*
+ * Substitute the operands into replacement line r.
+ */
+static char *
+peepsubst(char *r)
+{
+	char *s, *d;
+	int n;
+
+	for (n = 0, s = r; *s; s++)
+		n += (*s == '@' && isdigit((unsigned char)s[1])) ? PEEPLEN : 1;
+	d = s = tmpalloc(n + 1);
+	for (; *r; r++) {
+		if (*r == '@' && isdigit((unsigned char)r[1])) {
+			n = *++r - '0';
+			if (peepv[n] == NULL)
+				comperr("peephole: @%d not set", n);
+			strcpy(d, peepv[n]);
+			d += strlen(d);
+		} else
+			*d++ = *r;
+	}
+	*d = 0;
+	return s;
+}
+
+/*
+ * Try pattern pp at line i.  Return the number of lines replaced.
+ */
+static int
+peeptry(struct peep *pp, char **lines, int i, int n)
+{
+	int m[PEEPMAX];
+	int j, k;
+
+	for (j = 0; j < PEEPVARS; j++)
+		peepv[j] = NULL;
+	for (k = 0; pp->pat[k]; k++) {
+		for (; i < n && lines[i] == NULL; i++)
+			;
+		if (i == n || *lines[i] == *ASMBEG || *lines[i] == *ASMEND)
+			return 0;
+		if (!peepmatch(pp->pat[k], lines[i]))
+			return 0;
+		m[k] = i++;
+	}
+	if (pp->cond && !pp->cond(peepv))
+		return 0;
+	for (j = 0; j < k; j++) {
+		if (pp->rep[j] == NULL)
+			lines[m[j]] = NULL;
+		else if (strcmp(pp->rep[j], pp->pat[j]) != 0)
+			lines[m[j]] = peepsubst(pp->rep[j]);
+	}
+	pp->cnt++;
+	return k;
+}
+
+void
+peephole(char **lines, int n)
+{
+	struct peep *pp;
+	char *s;
+	int i, j;
+
+	if (peepcom[0] == 0) {
+#ifdef COM
+		for (s = COM; isspace((unsigned char)*s); s++)
+			;
+#else
+		s = "#";
+#endif
+		for (j = 0; j < 7 && s[j] && !isspace((unsigned char)s[j]); j++)
+			peepcom[j] = s[j];
+	}
+
+	for (i = 0; i < n; i++) {
+		if (lines[i] == NULL)
+			continue;
+		if (*lines[i] == *ASMBEG) {
+			while (i < n && (lines[i] == NULL || *lines[i] != *ASMEND))
+				i++;
+			continue;
+		}
+		for (pp = peeptab; pp->name; pp++)
+			if (peeptry(pp, lines, i, n))
+				break;
+		if (pp->name == NULL)
+			continue;
+		/* back up, so that earlier patterns may match again */
+		for (j = 0; i > 0 && j < PEEPMAX; j++)
+			while (--i > 0 && lines[i] == NULL)
+				;
+		i--;
+	}
+}
+
+/*
+ * Print the times each pattern was used, for -s.
+ */
+void
+peepstats(void)
+{
+	struct peep *pp;
+
+	for (pp = peeptab; pp->name; pp++)
+		fprintf(stderr, "Peephole %s:\t%d\n", pp->name, pp->cnt);
+}
+#endif
@@ -68,12 +68,18 @@
 #include <string.h>
 #include <stdarg.h>
 #include <stdlib.h>
+#include <time.h>
+#if defined(ASMCAPT) && defined(HAVE_UNISTD_H)
+#include <unistd.h>
+#endif
 
 /*	some storage declarations */
 int nrecur;
 int thisline;
 int fregs;
 int p2autooff, p2maxautooff;
+int p2autosz;		/* sum of all frames, for -s */
+clock_t p2emittime;	/* time spent in emit(), for -s */
 
 NODE *nodepole;
 struct interpass prepole;
@@ -86,6 +92,11 @@ static void fixxasm(struct p2env *);
 static void gencode(NODE *p, int cookie);
 static void genxasm(NODE *p);
 static void afree(void);
+#ifdef ASMCAPT
+static void asmcapture(void);
+static void asmrelease(void);
+static int asmcapt;
+#endif
 
 struct p2env p2env;
 
@@ -277,6 +288,10 @@ isuseless(NODE *n)
 	case USTCALL:
 	case STASG:
 	case STARG:
+	case FENCE:
+	case XADD:
+	case XCHG:
+	case CMPXCHG:
 		return 0;
 	default:
 		return 1;
@@ -326,6 +341,7 @@ deluseless(NODE *p)
 #define	SZIBUF 	256
 static int inpline;
 static char inpbuf[SZIBUF];
+static int ipbinary;	/* reading the binary interpass format */
 static char *
 rdline(void)
 {
@@ -341,6 +357,35 @@ rdline(void)
 	return inpbuf;
 }
 
+/*
+ * Read an unsigned varint from the binary interpass format.
+ */
+static U_CONSZ
+rduint(char **s)
+{
+	unsigned char *p = (unsigned char *)*s;
+	U_CONSZ u = 0;
+	int sh = 0;
+
+	do {
+		u |= (U_CONSZ)(*p & 0x7f) << sh;
+		sh += 7;
+	} while (*p++ & 0x80);
+	*s = (char *)p;
+	return u;
+}
+
+/*
+ * Read a zigzag-encoded signed varint.
+ */
+static CONSZ
+rdvint(char **s)
+{
+	U_CONSZ u = rduint(s);
+
+	return (CONSZ)(u >> 1) ^ -(CONSZ)(u & 1);
+}
+
 /*
  * Read an int and traverse over it. count up s.
  */
@@ -350,6 +395,8 @@ rdint(char **s)
 	char *p = *s;
 	int rv;
 
+	if (ipbinary)
+		return (int)rdvint(s);
 	SKIPWS(p);
 	rv = atoi(p);
 	if (*p == '-' || *p == '+') p++;
@@ -460,6 +507,222 @@ rdnode(char *s)
 	return p;
 }
 
+/*
+ * The binary string table.  Strings are entered the first time they
+ * are referenced and kept for the rest of the file.
+ */
+static char **ipstrs;
+static int ipnstrs, ipstrsz;
+
+static char *
+rdsref(char **s)
+{
+	int i, l;
+
+	if ((i = (int)rduint(s)) < ipnstrs)
+		return ipstrs[i];
+	if (i != ipnstrs)
+		comperr("bad string table index %d", i);
+	if (ipnstrs == ipstrsz) {
+		ipstrsz = ipstrsz ? ipstrsz * 2 : 256;
+		if ((ipstrs = realloc(ipstrs, ipstrsz * sizeof(char *))) == NULL)
+			comperr("out of memory");
+	}
+	l = (int)rduint(s);
+	ipstrs[ipnstrs] = newstring(*s, l);
+	ipstrs[ipnstrs][l] = 0;
+	*s += l;
+	return ipstrs[ipnstrs++];
+}
+
+/*
+ * Read an inline string.  Must be copied since the record buffer
+ * is reused before the function is compiled.
+ */
+static char *
+rdinline(char **s)
+{
+	char *t;
+	int l;
+
+	l = (int)rduint(s);
+	t = tmpalloc(l+1);
+	memcpy(t, *s, l);
+	t[l] = 0;
+	*s += l;
+	return t;
+}
+
+/*
+ * Read a binary node tree, see p2bnode() in pass1.
+ */
+static NODE *
+rdbnode(char **s)
+{
+	struct attr *ap, **app;
+	NODE *p = talloc();
+	int ty, i, n;
+
+	p->n_regw = NULL;
+	p->n_ap = NULL;
+	p->n_su = p->n_rval = 0;
+	setlval(p, 0);
+	p->n_op = (int)rduint(s);
+	p->n_type = (TWORD)rduint(s);
+	p->n_qual = (TWORD)rduint(s);
+	p->n_name = "";
+	ty = optype(p->n_op);
+	if (ty == LTYPE)
+		setlval(p, rdvint(s));
+	if (p->n_op == NAME || p->n_op == ICON)
+		p->n_name = rdsref(s);
+	else if (ty != BITYPE)
+		p->n_rval = (int)rdvint(s);
+	if (p->n_op == XASM || p->n_op == XARG)
+		p->n_name = rdinline(s);
+	app = &p->n_ap;
+	for (n = (int)rduint(s); n > 0; n--) {
+		i = (int)rduint(s);
+		ap = attr_new(i, (int)rduint(s));
+		for (i = 0; i < ap->sz; i++)
+			ap->iarg(i) = (int)rdvint(s);
+		*app = ap;
+		app = &ap->next;
+	}
+	if (ty != LTYPE)
+		p->n_left = rdbnode(s);
+	if (ty == BITYPE)
+		p->n_right = rdbnode(s);
+	return p;
+}
+
+/*
+ * Read the binary interpass format.  Records are a tag byte and
+ * a varint length, everything else are passthrough lines.
+ */
+static void
+mainbin(void)
+{
+	static int foo[] = { 0 };
+	static char *buf;
+	static int bufsz;
+	struct interpass_prolog *ipp;
+	struct interpass *ip;
+	int c, i, len, sh;
+	char *p, *e;
+
+	/* first magic byte already read by mainp2() */
+	for (i = 1; i < (int)sizeof(IPMAGIC)-1; i++)
+		if (getchar() != IPMAGIC[i])
+			comperr("bad interpass magic");
+	if ((c = getchar()) != IPVERSION)
+		comperr("interpass version %d, expected %d", c, IPVERSION);
+	ipbinary = 1;
+
+	while ((c = getchar()) != EOF) {
+		if (c < IPT_PROLOG || c > IPT_LINE) {
+			/* pass thru line, with or without prefix */
+			if (c == '*') {
+				if ((c = getchar()) == ' ')
+					c = getchar();
+				else
+					putchar('*');
+			}
+			while (c != '\n' && c != EOF) {
+				putchar(c);
+				c = getchar();
+			}
+			putchar('\n');
+			continue;
+		}
+		len = sh = 0;
+		do {
+			if ((i = getchar()) == EOF)
+				comperr("unexpected EOF in interpass record");
+			len |= (i & 0x7f) << sh;
+			sh += 7;
+		} while (i & 0x80);
+		if (len > bufsz) {
+			bufsz = len + 1024;
+			if ((buf = realloc(buf, bufsz)) == NULL)
+				comperr("out of memory");
+		}
+		if ((int)fread(buf, 1, len, stdin) != len)
+			comperr("short interpass record");
+		p = buf;
+		e = buf + len;
+
+		switch (c) {
+		case IPT_LINE:
+			lineno = (int)rdvint(&p);
+			break;
+		case IPT_NODE:
+			ip = malloc(sizeof(struct interpass));
+			ip->type = IP_NODE;
+			ip->lineno = lineno;
+			ip->ip_node = rdbnode(&p);
+			pass2_compile(ip);
+			break;
+		case IPT_DEFLAB:
+			ip = malloc(sizeof(struct interpass));
+			ip->type = IP_DEFLAB;
+			ip->lineno = lineno;
+			ip->ip_lbl = (int)rdvint(&p);
+			pass2_compile(ip);
+			break;
+		case IPT_ASM:
+			ip = malloc(sizeof(struct interpass));
+			ip->type = IP_ASM;
+			ip->lineno = lineno;
+			ip->ip_asm = rdinline(&p);
+			pass2_compile(ip);
+			break;
+		case IPT_PROLOG:
+			ipp = malloc(sizeof(struct interpass_prolog));
+			ip = (void *)ipp;
+			ip->type = IP_PROLOG;
+			ip->lineno = lineno;
+			ipp->ipp_type = (TWORD)rduint(&p);
+			ipp->ipp_vis = (int)rdvint(&p);
+			ip->ip_lbl = (int)rdvint(&p);
+			ipp->ip_tmpnum = (int)rdvint(&p);
+			ipp->ip_lblnum = (int)rdvint(&p);
+			ipp->ipp_name = rdsref(&p);
+			ipp->ipp_autos = -1;
+			ipp->ip_labels = foo;
+#ifdef TARGET_IPP_MEMBERS
+			target_members_read_prolog(ipp);
+#endif
+			pass2_compile(ip);
+			break;
+		case IPT_EPILOG:
+			ipp = malloc(sizeof(struct interpass_prolog));
+			ip = (void *)ipp;
+			ip->type = IP_EPILOG;
+			ip->lineno = lineno;
+			ipp->ipp_autos = (int)rdvint(&p);
+			ip->ip_lbl = (int)rdvint(&p);
+			ipp->ip_tmpnum = (int)rdvint(&p);
+			ipp->ip_lblnum = (int)rdvint(&p);
+			ipp->ipp_name = rdsref(&p);
+			if ((len = (int)rduint(&p)) > 0) {
+				ipp->ip_labels = tmpalloc(sizeof(int)*(len+1));
+				for (i = 0; i < len; i++)
+					ipp->ip_labels[i] = (int)rdvint(&p);
+				ipp->ip_labels[len] = 0;
+			} else
+				ipp->ip_labels = foo;
+#ifdef TARGET_IPP_MEMBERS
+			target_members_read_epilog(ipp);
+#endif
+			pass2_compile(ip);
+			break;
+		}
+		if (p != e)
+			comperr("interpass record %d sync error", c);
+	}
+}
+
 /*
  * Read everything from pass1.
  */
@@ -471,8 +734,27 @@ mainp2()
 	struct interpass *ip;
 	char nam[SZIBUF], *p, *b;
 	extern char *ftitle;
+	int c;
+
+	if ((c = getchar()) == IPMAGIC[0]) {
+		mainbin();
+		return;
+	}
+	ungetc(c, stdin);
 
-	while ((p = rdline()) != NULL) {
+	for (;;) {
+		/* lines from pass1 without sync char are passed thru */
+		if ((c = getchar()) == EOF)
+			break;
+		ungetc(c, stdin);
+		if (strchr("*&#\"^$!%", c) == NULL) {
+			while ((c = getchar()) != '\n' && c != EOF)
+				putchar(c);
+			putchar('\n');
+			continue;
+		}
+		if ((p = rdline()) == NULL)
+			break;
 		b = p++;
 		p++;
 
@@ -490,24 +772,34 @@ mainp2()
 		case '"':
 			ip = malloc(sizeof(struct interpass));
 			ip->type = IP_NODE;
+			ip->lineno = lineno;
 			ip->ip_node = rdnode(b);
 			pass2_compile(ip);
 			break;
 		case '^':
 			ip = malloc(sizeof(struct interpass));
 			ip->type = IP_DEFLAB;
+			ip->lineno = lineno;
 			ip->ip_lbl = atoi(p);
 			pass2_compile(ip);
 			break;
+		case '$':
+			ip = malloc(sizeof(struct interpass));
+			ip->type = IP_ASM;
+			ip->lineno = lineno;
+			ip->ip_asm = tmpalloc(strlen(p)+1);
+			strcpy(ip->ip_asm, p);
+			pass2_compile(ip);
+			break;
 		case '!': /* prolog */
 			ipp = malloc(sizeof(struct interpass_prolog));
 			ip = (void *)ipp;
 			ip->type = IP_PROLOG;
+			ip->lineno = lineno;
 			sscanf(p, "%d %d %d %d %d %s", &ipp->ipp_type,
 			    &ipp->ipp_vis, &ip->ip_lbl, &ipp->ip_tmpnum,
 			    &ipp->ip_lblnum, nam);
 			ipp->ipp_name = xstrdup(nam);
-			memset(ipp->ipp_regs, -1, sizeof(ipp->ipp_regs));
 			ipp->ipp_autos = -1;
 			ipp->ip_labels = foo;
 #ifdef TARGET_IPP_MEMBERS
@@ -526,18 +818,18 @@ mainp2()
 			ipp = malloc(sizeof(struct interpass_prolog));
 			ip = (void *)ipp;
 			ip->type = IP_EPILOG;
+			ip->lineno = lineno;
 			ipp->ipp_autos = rdint(&p);
 			ip->ip_lbl = rdint(&p);
 			ipp->ip_tmpnum = rdint(&p);
 			ipp->ip_lblnum = rdint(&p);
 			ipp->ipp_name = rdstr(&p);
-			memset(ipp->ipp_regs, 0, sizeof(ipp->ipp_regs));
 			SKIPWS(p);
 			if (*p == '+') {
 				int num, i;
 				p++;
-				num = rdint(&p) + 1;
-				ipp->ip_labels = tmpalloc(sizeof(int)*num);
+				num = rdint(&p);
+				ipp->ip_labels = tmpalloc(sizeof(int)*(num+1));
 				for (i = 0; i < num; i++)
 					ipp->ip_labels[i] = rdint(&p);
 				ipp->ip_labels[num] = 0;
@@ -576,6 +868,7 @@ pass2_compile(struct interpass *ip)
 	void deljumps(struct p2env *);
 	struct p2env *p2e = &p2env;
 	int (*addrp)[2];
+	clock_t t0;
 
 	if (ip->type == IP_PROLOG) {
 		memset(p2e, 0, sizeof(struct p2env));
@@ -653,6 +946,7 @@ pass2_compile(struct interpass *ip)
 		}
 	}
 
+	coldmove(p2e); /* move unlikely code out of the way */
 	fixxasm(p2e); /* setup for extended asm */
 
 	optimize(p2e);
@@ -660,11 +954,116 @@ pass2_compile(struct interpass *ip)
 
 	if (xtemps && xdeljumps)
 		deljumps(p2e);
+#ifdef CONDMOVE
+	if (xifconv)
+		ifconvert(p2e);
+#endif
+#ifdef TAILCALL
+	if (xtailcall)
+		tailcall(p2e);
+#endif
 
+#ifdef ASMOPT
+	if (xdelay)
+		asmcapture();
+#endif
+#ifdef PEEPHOLE
+	if (xpeep && !asmcapt)
+		asmcapture();
+#endif
+	t0 = clock();
 	DLIST_FOREACH(ip, &p2e->ipole, qelem)
 		emit(ip);
+#ifdef ASMCAPT
+	if (asmcapt)
+		asmrelease();
+#endif
+	p2emittime += clock() - t0;
+}
+
+#ifdef ASMCAPT
+/*
+ * The assembler output of a function is collected in a temporary file
+ * and given to peephole() and myasmopt() as an array of lines, which
+ * may be rewritten, moved or deleted (set to NULL) before printing.
+ * Inline assembler is enclosed in ASMBEG and ASMEND lines, which are
+ * not printed.
+ */
+static FILE *asmfp;
+static int asmfd;
+static long asmoff;
+
+static void
+asmcapture(void)
+{
+	fflush(stdout);
+	if (asmfp == NULL && (asmfp = tmpfile()) == NULL)
+		cerror("asmcapture: cannot create temporary file");
+	fseek(asmfp, 0L, SEEK_END);
+	asmoff = ftell(asmfp);
+	if ((asmfd = dup(fileno(stdout))) < 0 ||
+	    dup2(fileno(asmfp), fileno(stdout)) < 0)
+		cerror("asmcapture: cannot redirect output");
+	asmcapt = 1;
 }
 
+static void
+asmrelease(void)
+{
+	char *buf, *s, **lines;
+	long sz;
+	int i, n;
+
+	fflush(stdout);
+	if (dup2(asmfd, fileno(stdout)) < 0)
+		cerror("asmrelease: cannot restore output");
+	close(asmfd);
+	asmcapt = 0;
+
+	fseek(asmfp, 0L, SEEK_END);
+	sz = ftell(asmfp) - asmoff;
+	fseek(asmfp, asmoff, SEEK_SET);
+	buf = tmpalloc(sz + 1);
+	if (fread(buf, 1, sz, asmfp) != (size_t)sz)
+		cerror("asmrelease: read error");
+	buf[sz] = 0;
+
+	/* drop stray nul characters, they would end lines early */
+	for (i = n = 0, s = buf; s < buf + sz; s++) {
+		if (*s == '\n')
+			n++;
+		if (*s)
+			buf[i++] = *s;
+	}
+	buf[i] = 0;
+	lines = tmpalloc((n + 1) * sizeof(char *));
+	for (n = 0, s = buf; *s; ) {
+		lines[n++] = s;
+		while (*s && *s != '\n')
+			s++;
+		if (*s)
+			*s++ = 0;
+	}
+
+#ifdef PEEPHOLE
+	if (xpeep)
+		peephole(lines, n);
+#endif
+#ifdef ASMOPT
+	if (xdelay)
+		myasmopt(lines, n);
+#endif
+
+	for (i = 0; i < n; i++) {
+		if (lines[i] == NULL || strcmp(lines[i], ASMBEG) == 0 ||
+		    strcmp(lines[i], ASMEND) == 0)
+			continue;
+		outstr(lines[i]);
+		outchr('\n');
+	}
+}
+#endif
+
 void
 emit(struct interpass *ip)
 {
@@ -703,11 +1102,32 @@ emit(struct interpass *ip)
 				gencode(r, FORCC);
 			}
 			break;
+#ifdef CONDMOVE
+		case CMOV:
+			/* compare, then the (conditional) moves */
+			o = p->n_left->n_op;
+			gencode(p->n_left, FORCC);
+			r = p->n_right;
+			if (r->n_op == CM) {
+				gencode(r->n_left, FOREFF);
+				r = r->n_right;
+			}
+			cmovgen(o, r);
+			break;
+#endif
 		case FORCE:
 			gencode(p->n_left, INREGS);
 			break;
 		case XASM:
+#ifdef ASMCAPT
+			if (asmcapt)
+				outstr(ASMBEG "\n");
+#endif
 			genxasm(p);
+#ifdef ASMCAPT
+			if (asmcapt)
+				outstr(ASMEND "\n");
+#endif
 			break;
 		default:
 			if (p->n_op != REG || p->n_type != VOID) /* XXX */
@@ -721,13 +1141,22 @@ emit(struct interpass *ip)
 		break;
 	case IP_EPILOG:
 		eoftn((struct interpass_prolog *)ip);
+		p2autosz += p2maxautooff;
 		p2maxautooff = p2autooff = AUTOINIT/SZCHAR;
 		break;
 	case IP_DEFLAB:
 		deflab(ip->ip_lbl);
 		break;
 	case IP_ASM:
-		printf("%s", ip->ip_asm);
+#ifdef ASMCAPT
+		if (asmcapt)
+			outstr(ASMBEG "\n");
+#endif
+		outstr(ip->ip_asm);
+#ifdef ASMCAPT
+		if (asmcapt)
+			outstr(ASMEND "\n");
+#endif
 		break;
 	default:
 		cerror("emit %d", ip->type);
@@ -836,6 +1265,7 @@ again:	switch (o = p->n_op) {
 	case PLUS:
 	case MINUS:
 	case MUL:
+	case MULH:
 	case DIV:
 	case MOD:
 	case AND:
@@ -843,6 +1273,10 @@ again:	switch (o = p->n_op) {
 	case ER:
 	case LS:
 	case RS:
+	case XADD:
+	case XCHG:
+	case CMPXCHG:
+	case CM: /* only as CMPXCHG operand pair */
 		rv = findops(p, cookie);
 		break;
 
@@ -888,6 +1322,7 @@ again:	switch (o = p->n_op) {
 	case UCALL:
 	case USTCALL:
 	case ADDROF:
+	case FENCE:
 		rv = finduni(p, cookie);
 		break;
 
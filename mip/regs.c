@@ -2561,6 +2561,56 @@ AssignColors(struct interpass *ip)
 }
 
 static REGW *spole, *longsp;
+
+/*
+ * Stack slots handed out to spilled long-lived temporaries in this
+ * round.  Temporaries that do not interfere are never live at the same
+ * time, so they may share a slot the same way they could have shared
+ * a register.
+ */
+struct stkslot {
+	struct stkslot *next;
+	struct stkmem {
+		struct stkmem *next;
+		REGW *w;
+	} *mem;			/* temporaries in this slot */
+	int off, sz;
+};
+static struct stkslot *stkslots;
+int stkshared;		/* bytes saved by sharing, for -s */
+
+static int
+slotalloc(REGW *w, int sz)
+{
+	struct stkslot *s;
+	struct stkmem *m;
+
+	for (s = stkslots; s; s = s->next) {
+		if (s->sz != sz)
+			continue;
+		for (m = s->mem; m; m = m->next)
+			if (adjSet(w, m->w))
+				break;
+		if (m == NULL)
+			break;
+	}
+	if (s == NULL) {
+		s = tmpalloc(sizeof(struct stkslot));
+		s->off = freetemp(sz);
+		s->sz = sz;
+		s->mem = NULL;
+		s->next = stkslots;
+		stkslots = s;
+	} else
+		stkshared += sz * (SZINT/SZCHAR);
+	m = tmpalloc(sizeof(struct stkmem));
+	m->w = w;
+	m->next = s->mem;
+	s->mem = m;
+	RDEBUG(("Node %d in slot %d\n", ASGNUM(w), s->off));
+	return s->off;
+}
+
 /*
  * Store all spilled nodes in memory by fetching a temporary on the stack.
  * Will never end up here if not optimizing.
@@ -2580,7 +2630,7 @@ longtemp(NODE *p, void *arg)
 		MYLONGTEMP(p, w);
 #endif
 		if (w->r_class == 0) {
-			w->r_color = freetemp(szty(p->n_type));
+			w->r_color = slotalloc(w, szty(p->n_type));
 			w->r_class = FPREG; /* XXX - assumption? */
 		}
 		storemod(p, w->r_color, w->r_class);
@@ -2822,6 +2872,7 @@ leafrewrite(struct interpass *ipole, REGW *rpole)
 	struct interpass *ip;
 
 	spole = rpole;
+	stkslots = NULL;
 	DLIST_FOREACH(ip, ipole, qelem) {
 		if (ip->type != IP_NODE)
 			continue;